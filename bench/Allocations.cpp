@@ -0,0 +1,38 @@
+#include "Allocations.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+std::atomic<size_t> g_allocationCount = 0;
+
+} // anonymous namespace
+
+size_t allocationCount()
+{
+  return g_allocationCount.load(std::memory_order_relaxed);
+}
+
+// the array and nothrow forms call these
+void* operator new(size_t size)
+{
+  g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* const ptr = std::malloc(size == 0 ? 1 : size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+// Number of calls to the global operator new so far, the bench executable
+// replaces it with a counting one
+size_t allocationCount();
@@ -0,0 +1,326 @@
+#include "Regression.h"
+
+#include <Benchmark.h>
+#include <Utils.h>
+#include <parsing/Intern.h>
+#include <parsing/Operator.h>
+#include <parsing/Parser.h>
+#include <parsing/Tokenizer.h>
+
+#include <fmt/core.h>
+
+#include <cstdlib>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+constexpr std::string_view helpString = R"TEXT(
+Usage: bench [options]
+
+  Run micro-benchmarks of the hot paths of the front-end. Every
+  benchmark is timed in samples of batched calls, outliers beyond
+  Tukey's fences are rejected before the statistics are computed.
+
+Options:
+
+  --check=FILE        Measure a generated corpus instead and compare
+                      with the baseline in FILE, see Regression.h,
+                      the exit code is 1 if anything regressed
+  --update=FILE       Measure the corpus and write the results to
+                      FILE as the new baseline
+  --filter=TEXT       Only run benchmarks whose name contains TEXT
+  --json              Print the results as JSON
+  --samples=N         Samples per benchmark (default 30)
+  --sample-ms=N       Minimum duration of a sample (default 10)
+  -h, --help          Print this and exit
+
+)TEXT";
+
+constexpr std::string_view declarations = R"MIR(let std = @import, str = "a; b, c";
+pub let Vec = struct {
+  x: f32,
+  y: f32,
+
+  let zero = fn() Vec {
+    return undefined;
+  };
+};
+let mut counter: usize = 0;
+let Color = enum u8 { red, green = 2, blue, };
+let f = fn(a: i32, b: i32) i32 {
+  let c = blk: {
+    if a { break :blk b; } else if b { break :blk a; } else { break :blk null; }
+  };
+  loop c |x| { continue; } else |e| { unreachable; }
+  defer { x; }
+  let k = comptime 3;
+  return switch c { 0 => a, 1 |v| => b, };
+};
+)MIR";
+
+// only tokenized, the parser does not know operators yet
+constexpr std::string_view operators = R"MIR(let e = a + b * c - d / e % f;
+let g = !a and b or c == d != e < f <= g;
+let h = a.b.c(d, e)[f].g +% i <| j;
+)MIR";
+
+constexpr std::string_view types = R"MIR(let Shape = union {
+  circle: struct { r: f32, },
+  rect: struct { w: f32, h: f32, },
+  let Kind = enum u8 { circle, rect, };
+};
+let Tree = struct {
+  left: Node,
+  right: Node,
+  let Node = union { leaf: i32, tree: Tree, };
+};
+)MIR";
+
+struct Benchmark
+{
+  std::string name;
+  // what one call processes, e.g. tokens, to report the time per item
+  size_t itemsPerCall;
+  std::function<void()> run;
+};
+
+struct Result
+{
+  std::string name;
+  size_t itemsPerCall;
+  size_t rejected;
+  Samples samples;
+};
+
+size_t countTokens(std::string_view text)
+{
+  auto textStream = std::istringstream(std::string(text), std::ios::in);
+  auto tokenizer = Tokenizer(textStream, "<bench>");
+  size_t res = 0;
+  for (auto tok = tokenizer.next(); tok.tag() != Token::Eof; tok = tokenizer.next())
+  {
+    res += 1;
+  }
+  return res;
+}
+
+ast::Node::Ptr parse(std::string_view text, ast::Arena& arena)
+{
+  auto textStream = std::istringstream(std::string(text), std::ios::in);
+  auto parser = Parser(Tokenizer(textStream, "<bench>"), arena);
+  return parser.root();
+}
+
+std::vector<Benchmark> benchmarks()
+{
+  std::vector<Benchmark> res;
+
+  for (auto const& [name, text] : {
+    std::pair{"Tokenizer::next/declarations", declarations},
+    std::pair{"Tokenizer::next/operators", operators}})
+  {
+    res.push_back({name, countTokens(text), [text = text]
+    {
+      auto textStream = std::istringstream(std::string(text), std::ios::in);
+      auto tokenizer = Tokenizer(textStream, "<bench>");
+      for (auto tok = tokenizer.next(); tok.tag() != Token::Eof; tok = tokenizer.next())
+      {
+        doNotOptimize(tok);
+      }
+    }});
+  }
+
+  res.push_back({"Intern::string/existing", 1, []
+  {
+    doNotOptimize(Intern::string(std::string("identifier")));
+  }});
+  res.push_back({"Intern::string/mixed", 64, []
+  {
+    // a fixed set of names, all but the first round are hits
+    static std::vector<std::string> const names = []
+    {
+      std::vector<std::string> names;
+      for (size_t i = 0; i < 64; i += 1)
+      {
+        names.push_back(fmt::format("name{}", i * 7919));
+      }
+      return names;
+    }();
+    for (auto const& name : names)
+    {
+      doNotOptimize(Intern::string(name.data(), name.size()));
+    }
+  }});
+
+  res.push_back({"Operator::validate/valid", 1, []
+  {
+    doNotOptimize(Operator::validate("+="));
+  }});
+  res.push_back({"Operator::validate/invalid", 1, []
+  {
+    doNotOptimize(Operator::validate("+-+"));
+  }});
+
+  for (auto const& [name, text] : {
+    std::pair{"Parser::root/declarations", declarations},
+    std::pair{"Parser::root/types", types}})
+  {
+    res.push_back({name, countTokens(text), [text = text]
+    {
+      ast::Arena arena;
+      doNotOptimize(parse(text, arena));
+    }});
+  }
+
+  res.push_back({"Node::toString/declarations", 1, []
+  {
+    static ast::Arena arena;
+    static auto const pRoot = parse(declarations, arena);
+    doNotOptimize(pRoot->toString());
+  }});
+
+  return res;
+}
+
+void printTable(std::vector<Result> const& results)
+{
+  fmt::print("{:<32}{:>12}{:>12}{:>12}{:>12}{:>10}\n",
+    "benchmark", "median ns", "min ns", "p90 ns", "ns/item", "rejected");
+  for (auto const& result : results)
+  {
+    double const median = result.samples.median() * 1e9;
+    fmt::print("{:<32}{:>12.1f}{:>12.1f}{:>12.1f}{:>12.1f}{:>10}\n",
+      result.name, median, result.samples.min() * 1e9, result.samples.percentile(90) * 1e9,
+      median / static_cast<double>(result.itemsPerCall), result.rejected);
+  }
+}
+
+// {"benchmarks":[{"name":...,"items_per_call":...,"samples":...,"rejected":...,
+//  "median_ns":...,"mean_ns":...,"min_ns":...,"max_ns":...,"p90_ns":...}, ...]}
+void printJson(std::vector<Result> const& results)
+{
+  fmt::memory_buffer out;
+  auto const it = std::back_inserter(out);
+
+  fmt::format_to(it, "{{\"benchmarks\":[");
+  for (size_t i = 0; i < results.size(); i += 1)
+  {
+    auto const& result = results[i];
+    fmt::format_to(it, "{}{{\"name\":", i > 0 ? "," : "");
+    appendJsonString(out, result.name);
+    fmt::format_to(it,
+      ",\"items_per_call\":{},\"samples\":{},\"rejected\":{},\"median_ns\":{:.1f},\"mean_ns\":{:.1f},"
+      "\"min_ns\":{:.1f},\"max_ns\":{:.1f},\"p90_ns\":{:.1f}}}",
+      result.itemsPerCall, result.samples.size(), result.rejected,
+      result.samples.median() * 1e9, result.samples.mean() * 1e9,
+      result.samples.min() * 1e9, result.samples.max() * 1e9, result.samples.percentile(90) * 1e9);
+  }
+  fmt::format_to(it, "]}}\n");
+  std::fwrite(out.data(), 1, out.size(), stdout);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  std::string_view filter;
+  std::string checkPath, updatePath;
+  bool json = false;
+  size_t
+    sampleCount = 30,
+    sampleMs = 10;
+
+  for (int i = 1; i < argc; i += 1)
+  {
+    std::string_view const arg = argv[i];
+    if (arg == "-h" || arg == "--help")
+    {
+      fmt::print("{}", helpString);
+      return 0;
+    }
+    else if (arg == "--json")
+    {
+      json = true;
+    }
+    else if (arg.starts_with("--check="))
+    {
+      checkPath = arg.substr(8);
+    }
+    else if (arg.starts_with("--update="))
+    {
+      updatePath = arg.substr(9);
+    }
+    else if (arg.starts_with("--filter="))
+    {
+      filter = arg.substr(9);
+    }
+    else if (arg.starts_with("--samples="))
+    {
+      sampleCount = std::max<size_t>(std::strtoul(arg.substr(10).data(), nullptr, 10), 1);
+    }
+    else if (arg.starts_with("--sample-ms="))
+    {
+      sampleMs = std::strtoul(arg.substr(12).data(), nullptr, 10);
+    }
+    else
+    {
+      fmt::print("error: unknown option '{}'\n{}", arg, helpString);
+      return 1;
+    }
+  }
+
+  if (!checkPath.empty() || !updatePath.empty())
+  {
+    try
+    {
+      if (!updatePath.empty())
+      {
+        updateBaseline(updatePath);
+        return 0;
+      }
+      return checkBaseline(checkPath) ? 0 : 1;
+    }
+    catch (Error const& err)
+    {
+      fmt::print("\n{}\n\n", err);
+      return 1;
+    }
+  }
+
+  std::vector<Result> results;
+  try
+  {
+    for (auto const& benchmark : benchmarks())
+    {
+      if (benchmark.name.find(filter) == std::string::npos)
+      {
+        continue;
+      }
+
+      auto const samples = timePerCall(benchmark.run, sampleCount, std::chrono::milliseconds(sampleMs));
+      auto kept = samples.withoutOutliers();
+      size_t const rejected = samples.size() - kept.size();
+      results.push_back({benchmark.name, benchmark.itemsPerCall, rejected, std::move(kept)});
+    }
+  }
+  catch (Error const& err)
+  {
+    fmt::print("\n{}\n\n", err);
+    return 1;
+  }
+
+  if (json)
+  {
+    printJson(results);
+  }
+  else
+  {
+    printTable(results);
+  }
+  return 0;
+}
@@ -0,0 +1,376 @@
+#include "Regression.h"
+
+#include "Allocations.h"
+
+#include <Benchmark.h>
+#include <Corpus.h>
+#include <Utils.h>
+#include <parsing/Error.h>
+#include <parsing/Parser.h>
+#include <parsing/Tokenizer.h>
+#include <parsing/ast/Walker.h>
+
+#include <fmt/core.h>
+
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+
+namespace
+{
+
+enum class Better
+{
+  Higher,
+  Lower,
+};
+
+struct Metric
+{
+  char const* name;
+  Better better;
+  double defaultTolerance;
+};
+
+// allocations do not vary between runs, timings do
+constexpr std::array<Metric, 5> metrics = {{
+  {"lex_mb_per_s", Better::Higher, 0.3},
+  {"parse_nodes_per_s", Better::Higher, 0.3},
+  {"lex_allocations_per_token", Better::Lower, 0.02},
+  {"parse_allocations_per_token", Better::Lower, 0.02},
+  {"peak_rss_mb", Better::Lower, 0.2},
+}};
+
+struct Corpus
+{
+  size_t size = 64 * 1024;
+  size_t seed = 1;
+  size_t iterations = 5;
+};
+
+struct Baseline
+{
+  Corpus corpus;
+  std::map<std::string, double> values;
+  std::map<std::string, double> tolerances;
+};
+
+// Reads the numbers of the objects of a baseline file, nested keys are
+// joined with '.' as in "metrics.peak_rss_mb.value". Strings, booleans
+// and null are accepted and ignored, arrays are not part of the format.
+struct Reader
+{
+  std::string const& path;
+  std::string_view text;
+  size_t idx;
+  std::map<std::string, double> numbers;
+
+  Reader(std::string const& path, std::string_view text)
+    : path(path)
+    , text(text)
+    , idx(0)
+  {}
+
+  [[noreturn]] void fail(std::string const& message)
+  {
+    // positions of the same form the parser reports
+    size_t line = 0, column = 0;
+    for (size_t i = 0; i < idx && i < text.size(); i += 1)
+    {
+      if (text[i] == '\n')
+      {
+        line += 1;
+        column = 0;
+      }
+      else
+      {
+        column += 1;
+      }
+    }
+    throw Error(path, Position(line, column), message);
+  }
+
+  void skipSpace()
+  {
+    while (idx < text.size() && std::isspace(static_cast<unsigned char>(text[idx])))
+    {
+      idx += 1;
+    }
+  }
+
+  void expect(char c)
+  {
+    skipSpace();
+    if (idx >= text.size() || text[idx] != c)
+    {
+      fail(fmt::format("'{}' expected", c));
+    }
+    idx += 1;
+  }
+
+  std::string string()
+  {
+    expect('"');
+    std::string res;
+    while (idx < text.size() && text[idx] != '"')
+    {
+      if (text[idx] == '\\' && idx + 1 < text.size())
+      {
+        idx += 1;
+      }
+      res += text[idx];
+      idx += 1;
+    }
+    expect('"');
+    return res;
+  }
+
+  void value(std::string const& key)
+  {
+    skipSpace();
+    if (idx >= text.size())
+    {
+      fail("value expected");
+    }
+
+    char const c = text[idx];
+    if (c == '{')
+    {
+      object(key);
+    }
+    else if (c == '"')
+    {
+      string();
+    }
+    else if (text.substr(idx).starts_with("true") || text.substr(idx).starts_with("null"))
+    {
+      idx += 4;
+    }
+    else if (text.substr(idx).starts_with("false"))
+    {
+      idx += 5;
+    }
+    else
+    {
+      std::string const rest(text.substr(idx, 64));
+      char* pEnd = nullptr;
+      double const number = std::strtod(rest.c_str(), &pEnd);
+      if (pEnd == rest.c_str())
+      {
+        fail("value expected");
+      }
+      idx += static_cast<size_t>(pEnd - rest.c_str());
+      numbers[key] = number;
+    }
+  }
+
+  void object(std::string const& key)
+  {
+    expect('{');
+    skipSpace();
+    if (idx < text.size() && text[idx] == '}')
+    {
+      idx += 1;
+      return;
+    }
+    while (true)
+    {
+      auto const member = string();
+      expect(':');
+      value(key.empty() ? member : key + "." + member);
+      skipSpace();
+      if (idx < text.size() && text[idx] == ',')
+      {
+        idx += 1;
+        continue;
+      }
+      expect('}');
+      return;
+    }
+  }
+};
+
+Baseline readBaseline(std::string const& path)
+{
+  auto fileStream = std::ifstream(path, std::ios::in | std::ios::binary);
+  if (!fileStream)
+  {
+    throw Error(path, "cannot open file");
+  }
+  std::stringstream buffer;
+  buffer << fileStream.rdbuf();
+  auto const text = std::move(buffer).str();
+
+  Reader reader(path, text);
+  reader.object("");
+
+  auto const& numbers = reader.numbers;
+  auto const get = [&](std::string const& key, double fallback)
+  {
+    auto const it = numbers.find(key);
+    return it != numbers.end() ? it->second : fallback;
+  };
+
+  Baseline res;
+  res.corpus.size = static_cast<size_t>(get("corpus.size", static_cast<double>(res.corpus.size)));
+  res.corpus.seed = static_cast<size_t>(get("corpus.seed", static_cast<double>(res.corpus.seed)));
+  res.corpus.iterations = static_cast<size_t>(get("corpus.iterations", static_cast<double>(res.corpus.iterations)));
+  for (auto const& metric : metrics)
+  {
+    auto const prefix = fmt::format("metrics.{}.", metric.name);
+    if (auto const it = numbers.find(prefix + "value"); it != numbers.end())
+    {
+      res.values[metric.name] = it->second;
+    }
+    res.tolerances[metric.name] = get(prefix + "tolerance", metric.defaultTolerance);
+  }
+  return res;
+}
+
+void writeBaseline(std::string const& path, Baseline const& baseline)
+{
+  fmt::memory_buffer out;
+  auto const it = std::back_inserter(out);
+
+  fmt::format_to(it, "{{\n  \"corpus\": {{\"size\": {}, \"seed\": {}, \"iterations\": {}}},\n  \"metrics\": {{\n",
+    baseline.corpus.size, baseline.corpus.seed, baseline.corpus.iterations);
+  for (size_t i = 0; i < metrics.size(); i += 1)
+  {
+    auto const name = metrics[i].name;
+    fmt::format_to(it, "    \"{}\": {{\"value\": {:.6g}, \"tolerance\": {}}}{}\n",
+      name, baseline.values.at(name), baseline.tolerances.at(name), i + 1 < metrics.size() ? "," : "");
+  }
+  fmt::format_to(it, "  }}\n}}\n");
+
+  auto fileStream = std::ofstream(path, std::ios::out | std::ios::binary);
+  if (!fileStream)
+  {
+    throw Error(path, "cannot write file");
+  }
+  fileStream.write(out.data(), static_cast<std::streamsize>(out.size()));
+}
+
+struct CountNodes
+{
+  size_t count = 0;
+  void pre(ast::Node::Ptr) { count += 1; }
+};
+
+std::map<std::string, double> measure(Corpus const& corpus)
+{
+  CorpusOptions options;
+  options.size = corpus.size;
+  options.seed = corpus.seed;
+  auto const text = generateCorpus(options);
+
+  size_t tokenCount = 0;
+  auto const tokenize = [&]
+  {
+    tokenCount = 0;
+    auto textStream = std::istringstream(text, std::ios::in);
+    auto tokenizer = Tokenizer(textStream, "<corpus>");
+    for (auto tok = tokenizer.next(); tok.tag() != Token::Eof; tok = tokenizer.next())
+    {
+      tokenCount += 1;
+    }
+  };
+  auto const parse = [&]
+  {
+    ast::Arena arena;
+    auto textStream = std::istringstream(text, std::ios::in);
+    auto parser = Parser(Tokenizer(textStream, "<corpus>"), arena);
+    parser.root();
+  };
+
+  // counted once, outside of the timed and allocation counted calls
+  size_t nodeCount = 0;
+  {
+    ast::Arena arena;
+    auto textStream = std::istringstream(text, std::ios::in);
+    auto parser = Parser(Tokenizer(textStream, "<corpus>"), arena);
+    CountNodes counter;
+    ast::Walker().walk(parser.root(), counter);
+    nodeCount = counter.count;
+  }
+
+  // the first call fills the interner, the counted ones allocate the same
+  tokenize();
+  size_t const lexAllocations = allocationCount();
+  tokenize();
+  size_t const parseAllocations = allocationCount();
+  parse();
+  size_t const afterAllocations = allocationCount();
+
+  auto const iterations = std::max<size_t>(corpus.iterations, 1);
+  auto const lexSamples = timePerCall(tokenize, iterations, std::chrono::seconds(0));
+  auto const parseSamples = timePerCall(parse, iterations, std::chrono::seconds(0));
+
+  auto const tokens = static_cast<double>(std::max<size_t>(tokenCount, 1));
+  return {
+    {"lex_mb_per_s", static_cast<double>(text.size()) / 1e6 / lexSamples.median()},
+    {"parse_nodes_per_s", static_cast<double>(nodeCount) / parseSamples.median()},
+    {"lex_allocations_per_token", static_cast<double>(parseAllocations - lexAllocations) / tokens},
+    {"parse_allocations_per_token", static_cast<double>(afterAllocations - parseAllocations) / tokens},
+    {"peak_rss_mb", static_cast<double>(peakRss()) / 1e6},
+  };
+}
+
+} // anonymous namespace
+
+bool checkBaseline(std::string const& path)
+{
+  auto const baseline = readBaseline(path);
+  auto const current = measure(baseline.corpus);
+
+  bool res = true;
+  fmt::print("{:<30}{:>14}{:>14}{:>10}{:>11}\n", "metric", "baseline", "current", "change", "tolerance");
+  for (auto const& metric : metrics)
+  {
+    double const value = current.at(metric.name);
+    double const tolerance = baseline.tolerances.at(metric.name);
+
+    auto const it = baseline.values.find(metric.name);
+    if (it == baseline.values.end())
+    {
+      fmt::print("{:<30}{:>14}{:>14.4g}{:>10}{:>11}  no baseline\n", metric.name, "-", value, "-", "-");
+      continue;
+    }
+
+    double const expected = it->second;
+    double const change = expected != 0 ? (value - expected) / std::abs(expected) : 0;
+    // positive if better
+    double const gain = metric.better == Better::Higher ? change : -change;
+
+    std::string_view verdict = "ok";
+    if (gain < -tolerance)
+    {
+      verdict = "REGRESSED";
+      res = false;
+    }
+    else if (gain > tolerance)
+    {
+      verdict = "improved, update the baseline";
+    }
+
+    fmt::print("{:<30}{:>14.4g}{:>14.4g}{:>+9.1f}%{:>10}%  {}\n",
+      metric.name, expected, value, change * 100,
+      fmt::format("{}{:.0f}", metric.better == Better::Higher ? "-" : "+", tolerance * 100), verdict);
+  }
+  return res;
+}
+
+void updateBaseline(std::string const& path)
+{
+  auto baseline = std::filesystem::exists(path) ? readBaseline(path) : Baseline();
+  for (auto const& metric : metrics)
+  {
+    baseline.tolerances.try_emplace(metric.name, metric.defaultTolerance);
+  }
+  baseline.values = measure(baseline.corpus);
+  writeBaseline(path, baseline);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+// Measures the front-end on a generated corpus and compares every metric
+// with a baseline file:
+//
+//   {
+//     "corpus": {"size": 65536, "seed": 1, "iterations": 5},
+//     "metrics": {
+//       "lex_mb_per_s": {"value": 0.07, "tolerance": 0.3},
+//       ...
+//     }
+//   }
+//
+// A metric regresses if it is worse than its value by more than the
+// tolerance, a fraction of the value. Whether higher or lower is better
+// depends on the metric. Prints a report of every metric and returns
+// false if any regressed, a missing or malformed baseline throws Error.
+bool checkBaseline(std::string const& path);
+
+// Measures with the corpus of the baseline if it exists and writes the
+// results as its new values, keeping the tolerances
+void updateBaseline(std::string const& path);
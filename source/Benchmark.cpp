@@ -0,0 +1,68 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <sys/resource.h>
+
+Samples::Samples(std::vector<double> values)
+  : d_sorted(std::move(values))
+{
+  std::sort(d_sorted.begin(), d_sorted.end());
+}
+
+double Samples::percentile(double p) const
+{
+  if (d_sorted.empty())
+  {
+    return 0;
+  }
+  auto const rank = static_cast<size_t>(std::ceil(p / 100 * static_cast<double>(d_sorted.size())));
+  return d_sorted[std::clamp<size_t>(rank, 1, d_sorted.size()) - 1];
+}
+
+double Samples::mean() const
+{
+  if (d_sorted.empty())
+  {
+    return 0;
+  }
+  double sum = 0;
+  for (auto const value : d_sorted)
+  {
+    sum += value;
+  }
+  return sum / static_cast<double>(d_sorted.size());
+}
+
+Samples Samples::withoutOutliers() const
+{
+  double const
+    q1 = percentile(25),
+    q3 = percentile(75),
+    low = q1 - 1.5 * (q3 - q1),
+    high = q3 + 1.5 * (q3 - q1);
+
+  std::vector<double> res;
+  res.reserve(d_sorted.size());
+  for (auto const value : d_sorted)
+  {
+    if (low <= value && value <= high)
+    {
+      res.push_back(value);
+    }
+  }
+  return Samples(std::move(res));
+}
+
+size_t peakRss()
+{
+  rusage usage = {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return 0;
+  }
+  // kilobytes on Linux
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
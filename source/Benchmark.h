@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Measurements of repeated runs, e.g. durations in seconds, summarized by
+// their nearest-rank percentiles
+struct Samples final
+{
+private:
+  // Data
+  std::vector<double> d_sorted;
+
+public:
+  // Constructors
+  explicit Samples(std::vector<double> values);
+
+  // Methods
+  size_t size() const { return d_sorted.size(); }
+  bool isEmpty() const { return d_sorted.empty(); }
+
+  // p in [0, 100], 0 if there are no samples
+  double percentile(double p) const;
+  double median() const { return percentile(50); }
+  double min() const { return percentile(0); }
+  double max() const { return percentile(100); }
+  double mean() const;
+
+  // The samples within Tukey's fences, 1.5 interquartile ranges below
+  // the first or above the third quartile
+  Samples withoutOutliers() const;
+};
+
+// Keeps the compiler from optimizing away the computation of value
+template<typename T>
+void doNotOptimize(T const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Seconds per call of f in sampleCount samples. Calls are batched so that
+// a sample lasts at least minSampleTime and the clock's resolution does
+// not matter, the batch size is found before measuring.
+template<typename F>
+Samples timePerCall(F&& f, size_t sampleCount, std::chrono::duration<double> minSampleTime)
+{
+  using Clock = std::chrono::steady_clock;
+
+  auto const timeBatch = [&f](size_t batchSize)
+  {
+    auto const start = Clock::now();
+    for (size_t i = 0; i < batchSize; i += 1)
+    {
+      f();
+    }
+    return std::chrono::duration<double>(Clock::now() - start);
+  };
+
+  size_t batchSize = 1;
+  while (timeBatch(batchSize) < minSampleTime)
+  {
+    batchSize *= 2;
+  }
+
+  std::vector<double> seconds;
+  seconds.reserve(sampleCount);
+  for (size_t i = 0; i < sampleCount; i += 1)
+  {
+    seconds.push_back(timeBatch(batchSize).count() / static_cast<double>(batchSize));
+  }
+  return Samples(std::move(seconds));
+}
+
+// Peak resident set size of the process in bytes, 0 if unknown
+size_t peakRss();
@@ -0,0 +1,511 @@
+#include "Corpus.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+// generated source is written to the file whenever it grows past this
+constexpr size_t flushSize = 64 * 1024;
+
+constexpr std::array<std::string_view, 28> reserved = {
+  "pub", "let", "mut", "comptime", "struct", "enum", "union", "fn", "if", "else",
+  "switch", "loop", "import", "return", "break", "continue", "defer", "true",
+  "false", "null", "undefined", "unreachable", "and", "or", "not", "try",
+  "catch", "orelse",
+};
+
+constexpr std::array<std::string_view, 8> primitives = {
+  "i32", "u8", "usize", "f32", "bool", "void", "i64", "type",
+};
+
+// splitmix64, small and the same everywhere unlike the std distributions
+struct Random
+{
+  uint64_t state;
+
+  uint64_t next()
+  {
+    state += 0x9e3779b97f4a7c15;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  // in [0, bound)
+  size_t below(size_t bound) { return static_cast<size_t>(next() % bound); }
+  bool chance(size_t percent) { return below(100) < percent; }
+};
+
+struct Generator
+{
+  CorpusOptions options;
+  Random random;
+  std::string out;
+  std::vector<std::string> identifiers;
+  size_t indent = 0;
+  size_t labelCount = 0;
+
+  explicit Generator(CorpusOptions const& options)
+    : options(options)
+    , random{options.seed}
+  {
+    identifiers.reserve(std::max<size_t>(options.identifierCount, 1));
+    for (size_t i = 0; i < std::max<size_t>(options.identifierCount, 1); i += 1)
+    {
+      identifiers.push_back(makeIdentifier());
+    }
+  }
+
+  std::string makeIdentifier()
+  {
+    std::string res;
+    size_t const length = 1 + random.below(10);
+    for (size_t i = 0; i < length; i += 1)
+    {
+      res += static_cast<char>('a' + random.below(26));
+    }
+    if (random.chance(20))
+    {
+      fmt::format_to(std::back_inserter(res), "{}", random.below(100));
+    }
+    if (std::find(reserved.begin(), reserved.end(), res) != reserved.end()
+      || std::find(primitives.begin(), primitives.end(), res) != primitives.end())
+    {
+      res += '_';
+    }
+    return res;
+  }
+
+  void raw(std::string_view text) { out += text; }
+
+  void newline()
+  {
+    out += '\n';
+    out.append(2 * indent, ' ');
+  }
+
+  void identifier()
+  {
+    raw(identifiers[random.below(identifiers.size())]);
+  }
+
+  void atom()
+  {
+    switch (random.below(10))
+    {
+    case 0: fmt::format_to(std::back_inserter(out), "{}", random.below(100000)); break;
+    case 1: fmt::format_to(std::back_inserter(out), "{}.{}", random.below(1000), random.below(100)); break;
+    case 2: raw("\""); identifier(); raw(" "); identifier(); raw("\""); break;
+    case 3: raw(random.chance(50) ? "true" : "false"); break;
+    case 4: raw("null"); break;
+    case 5: raw("@"); identifier(); break;
+    default: identifier(); break;
+    }
+  }
+
+  void type(size_t depth)
+  {
+    if (depth < options.maxDepth && random.chance(10))
+    {
+      typeExpression(depth + 1);
+      return;
+    }
+    if (random.chance(50))
+    {
+      raw(primitives[random.below(primitives.size())]);
+      return;
+    }
+    identifier();
+  }
+
+  // values of let statements, can be any expression
+  void value(size_t depth, bool inFunction)
+  {
+    if (depth >= options.maxDepth)
+    {
+      atom();
+      return;
+    }
+
+    switch (random.below(16))
+    {
+    case 0: typeExpression(depth + 1); break;
+    case 1: function(depth + 1); break;
+    case 2: labeledBlock(depth + 1, inFunction); break;
+    case 3: ifExpression(depth + 1, inFunction); break;
+    case 4: switchExpression(depth + 1, inFunction); break;
+    case 5: raw("comptime "); atom(); break;
+    default: atom(); break;
+    }
+  }
+
+  void typeExpression(size_t depth)
+  {
+    switch (random.below(3))
+    {
+    case 0:
+    {
+      raw("struct {");
+      indent += 1;
+      declarations(depth, random.below(3));
+      for (size_t i = 0, count = random.below(5); i < count; i += 1)
+      {
+        newline();
+        identifier();
+        raw(": ");
+        type(depth);
+        raw(",");
+      }
+      declarations(depth, random.below(2));
+      indent -= 1;
+      newline();
+      raw("}");
+      break;
+    }
+    case 1:
+    {
+      raw(random.chance(50) ? "enum u8 {" : "enum {");
+      for (size_t i = 0, count = 1 + random.below(6); i < count; i += 1)
+      {
+        raw(" ");
+        identifier();
+        if (random.chance(20))
+        {
+          fmt::format_to(std::back_inserter(out), " = {}", random.below(256));
+        }
+        raw(",");
+      }
+      raw(" }");
+      break;
+    }
+    case 2:
+    {
+      raw("union {");
+      indent += 1;
+      for (size_t i = 0, count = 1 + random.below(4); i < count; i += 1)
+      {
+        newline();
+        identifier();
+        raw(": ");
+        type(depth);
+        raw(",");
+      }
+      declarations(depth, random.below(2));
+      indent -= 1;
+      newline();
+      raw("}");
+      break;
+    }
+    }
+  }
+
+  void declarations(size_t depth, size_t count)
+  {
+    for (size_t i = 0; i < count; i += 1)
+    {
+      newline();
+      let(depth, false);
+    }
+  }
+
+  void function(size_t depth)
+  {
+    raw("fn(");
+    for (size_t i = 0, count = random.below(4); i < count; i += 1)
+    {
+      raw(i > 0 ? ", " : "");
+      identifier();
+      raw(": ");
+      type(depth);
+    }
+    raw(") ");
+    type(depth);
+    // a function type without a body
+    if (random.chance(10))
+    {
+      return;
+    }
+    raw(" ");
+    block(depth, true, false, 3);
+  }
+
+  // mostly functions and types like real files
+  void topLevelLet()
+  {
+    raw(random.chance(20) ? "pub let " : "let ");
+    identifier();
+    raw(" = ");
+    switch (random.below(10))
+    {
+    case 0: case 1: case 2: case 3: function(1); break;
+    case 4: case 5: case 6: typeExpression(1); break;
+    default: value(0, false); break;
+    }
+    raw(";");
+  }
+
+  void let(size_t depth, bool inFunction)
+  {
+    raw("let ");
+    // only variables can be left undefined
+    bool const isMut = random.chance(20);
+    if (isMut)
+    {
+      raw("mut ");
+    }
+    for (size_t i = 0, count = 1 + (random.chance(15) ? random.below(3) : 0); i < count; i += 1)
+    {
+      raw(i > 0 ? ", " : "");
+      identifier();
+      if (random.chance(25))
+      {
+        raw(": ");
+        type(depth);
+      }
+      raw(" = ");
+      if (isMut && random.chance(20))
+      {
+        raw("undefined");
+      }
+      else
+      {
+        value(depth, inFunction);
+      }
+    }
+    raw(";");
+  }
+
+  // { statements }
+  void block(size_t depth, bool inFunction, bool inLoop, size_t maxStatements)
+  {
+    raw("{");
+    indent += 1;
+    for (size_t i = 0, count = 1 + random.below(maxStatements); i < count; i += 1)
+    {
+      newline();
+      statement(depth, inFunction, inLoop);
+    }
+    indent -= 1;
+    newline();
+    raw("}");
+  }
+
+  void statement(size_t depth, bool inFunction, bool inLoop)
+  {
+    bool const canNest = depth < options.maxDepth;
+    switch (random.below(12))
+    {
+    case 0:
+    case 1:
+    case 2:
+      let(depth, inFunction);
+      return;
+    case 3:
+      if (canNest)
+      {
+        ifExpression(depth + 1, inFunction, inLoop);
+        return;
+      }
+      break;
+    case 4:
+      if (canNest)
+      {
+        loop(depth + 1, inFunction);
+        return;
+      }
+      break;
+    case 5:
+      if (canNest)
+      {
+        raw("defer ");
+        block(depth + 1, false, false, 2);
+        return;
+      }
+      break;
+    case 6:
+      if (inFunction)
+      {
+        raw("return");
+        if (random.chance(10))
+        {
+          raw(" undefined");
+        }
+        else if (random.chance(70))
+        {
+          // labeled blocks and comptime cannot follow a return
+          raw(" ");
+          if (canNest && random.chance(20))
+          {
+            switchExpression(depth + 1, inFunction);
+          }
+          else
+          {
+            atom();
+          }
+        }
+        raw(";");
+        return;
+      }
+      break;
+    case 7:
+      if (inLoop)
+      {
+        raw(random.chance(50) ? "break;" : "continue;");
+        return;
+      }
+      break;
+    default:
+      break;
+    }
+    identifier();
+    raw(";");
+  }
+
+  void ifExpression(size_t depth, bool inFunction, bool inLoop = false)
+  {
+    raw("if ");
+    identifier();
+    raw(" ");
+    capture();
+    block(depth, inFunction, inLoop, 2);
+    for (size_t i = 0, count = random.below(3); i < count; i += 1)
+    {
+      raw(" else if ");
+      identifier();
+      raw(" ");
+      block(depth, inFunction, inLoop, 2);
+    }
+    raw(" else ");
+    block(depth, inFunction, inLoop, 2);
+  }
+
+  void loop(size_t depth, bool inFunction)
+  {
+    raw("loop ");
+    if (random.chance(30))
+    {
+      raw("true");
+    }
+    else
+    {
+      identifier();
+    }
+    raw(" ");
+    capture();
+    block(depth, inFunction, true, 3);
+    if (random.chance(20))
+    {
+      raw(" else ");
+      capture();
+      block(depth, inFunction, false, 2);
+    }
+  }
+
+  void capture()
+  {
+    if (random.chance(30))
+    {
+      raw("|");
+      identifier();
+      raw("| ");
+    }
+  }
+
+  void switchExpression(size_t depth, bool inFunction)
+  {
+    raw("switch ");
+    identifier();
+    raw(" {");
+    indent += 1;
+    for (size_t i = 0, count = 1 + random.below(4); i < count; i += 1)
+    {
+      newline();
+      if (random.chance(70))
+      {
+        fmt::format_to(std::back_inserter(out), "{}", i);
+      }
+      else
+      {
+        identifier();
+      }
+      raw(" ");
+      capture();
+      raw("=> ");
+      if (random.chance(20))
+      {
+        labeledBlock(depth, inFunction);
+      }
+      else
+      {
+        atom();
+      }
+      raw(",");
+    }
+    indent -= 1;
+    newline();
+    raw("}");
+  }
+
+  // label: { statements break :label value; }
+  void labeledBlock(size_t depth, bool inFunction)
+  {
+    auto const label = fmt::format("blk{}", labelCount);
+    labelCount += 1;
+
+    raw(label);
+    raw(": {");
+    indent += 1;
+    for (size_t i = 0, count = random.below(3); i < count; i += 1)
+    {
+      newline();
+      statement(depth, inFunction, false);
+    }
+    newline();
+    raw("break :");
+    raw(label);
+    raw(" ");
+    atom();
+    raw(";");
+    indent -= 1;
+    newline();
+    raw("}");
+  }
+};
+
+} // anonymous namespace
+
+std::string generateCorpus(CorpusOptions const& options)
+{
+  Generator generator(options);
+  generator.out.reserve(options.size + 4096);
+  while (generator.out.size() < options.size)
+  {
+    generator.topLevelLet();
+    generator.raw("\n");
+  }
+  return std::move(generator.out);
+}
+
+void generateCorpus(CorpusOptions const& options, std::FILE* pFile)
+{
+  Generator generator(options);
+  for (size_t written = 0; written < options.size;)
+  {
+    generator.topLevelLet();
+    generator.raw("\n");
+    if (generator.out.size() >= flushSize || written + generator.out.size() >= options.size)
+    {
+      std::fwrite(generator.out.data(), 1, generator.out.size(), pFile);
+      written += generator.out.size();
+      generator.out.clear();
+    }
+  }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Knobs of generateCorpus()
+struct CorpusOptions
+{
+  // bytes generated, the last declaration is completed so the result is
+  // slightly larger
+  size_t size = size_t(1) << 20;
+  // how deep types, blocks and control flow are nested in declarations
+  size_t maxDepth = 4;
+  // distinct identifiers used, more identifiers mean more interned strings
+  size_t identifierCount = 256;
+  uint64_t seed = 0;
+};
+
+// Random but valid Mir source using every construct the parser supports:
+// nested struct, enum and union types, fn literals and types, let
+// statements, if, loop, switch, labeled blocks, break, continue, defer,
+// return and comptime. The random numbers come from a generator of our
+// own so equal options give equal source on every platform.
+std::string generateCorpus(CorpusOptions const& options);
+// Writes the same source in chunks, for sizes that should not be kept
+void generateCorpus(CorpusOptions const& options, std::FILE* pFile);
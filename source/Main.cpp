@@ -14,8 +14,12 @@ Usage: mir [command] [options]
 
 Commands:
 
+  ast-check     Check files and directories for syntax errors
   ast-dump      Print the syntax tree
+  bench         Measure how fast sources are tokenized, parsed and printed
+  generate      Print random source for benchmarks
   op-table      Print a table containing info about operators
+  tokens        Print the tokens of a file and how fast they are read
 
 Options:
 
@@ -56,6 +60,22 @@ int main(int argc, char** argv)
   {
     return command::OpTable::exec(pathToSelf, args);
   }
+  if (cmmd == command::Bench::name)
+  {
+    return command::Bench::exec(pathToSelf, args);
+  }
+  if (cmmd == command::Generate::name)
+  {
+    return command::Generate::exec(pathToSelf, args);
+  }
+  if (cmmd == command::Tokens::name)
+  {
+    return command::Tokens::exec(pathToSelf, args);
+  }
+  if (cmmd == command::AstCheck::name)
+  {
+    return command::AstCheck::exec(pathToSelf, args);
+  }
   if (cmmd == command::AstDump::name)
   {
     return command::AstDump::exec(pathToSelf, args);
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <cstddef>
+
+// Lock-free ring buffer for exactly one producer and one consumer thread.
+// Elements are moved in batches so that the indices, each on its own cache
+// line, are published once per batch instead of once per element. Each side
+// keeps a copy of the other side's index and only reloads it when the ring
+// looks full or empty.
+template<typename T, size_t Capacity>
+struct SpscRing final
+{
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+private:
+  // Types
+  static constexpr size_t cacheLineSize = 64;
+  static constexpr size_t mask = Capacity - 1;
+
+  // Data
+  alignas(cacheLineSize) std::atomic<size_t> d_head = 0; // written by the consumer
+  alignas(cacheLineSize) size_t d_cachedTail = 0; // consumer's copy of d_tail
+  alignas(cacheLineSize) std::atomic<size_t> d_tail = 0; // written by the producer
+  alignas(cacheLineSize) size_t d_cachedHead = 0; // producer's copy of d_head
+  alignas(cacheLineSize) std::array<T, Capacity> d_elements;
+
+public:
+  // Methods
+  // producer only, returns how many of the count elements were pushed
+  size_t tryPush(T const* elements, size_t count)
+  {
+    size_t const tail = d_tail.load(std::memory_order_relaxed);
+    if (tail - d_cachedHead + count > Capacity)
+    {
+      d_cachedHead = d_head.load(std::memory_order_acquire);
+    }
+
+    size_t const res = std::min(count, Capacity - (tail - d_cachedHead));
+    for (size_t i = 0; i < res; i += 1)
+    {
+      d_elements[(tail + i) & mask] = elements[i];
+    }
+    d_tail.store(tail + res, std::memory_order_release);
+    return res;
+  }
+
+  // consumer only, returns how many elements were written to out
+  size_t tryPop(T* out, size_t maxCount)
+  {
+    size_t const head = d_head.load(std::memory_order_relaxed);
+    if (d_cachedTail - head < maxCount)
+    {
+      d_cachedTail = d_tail.load(std::memory_order_acquire);
+    }
+
+    size_t const res = std::min(maxCount, d_cachedTail - head);
+    for (size_t i = 0; i < res; i += 1)
+    {
+      out[i] = d_elements[(head + i) & mask];
+    }
+    d_head.store(head + res, std::memory_order_release);
+    return res;
+  }
+};
@@ -1,6 +1,7 @@
 #include "Utils.h"
 
 #include <algorithm>
+#include <iterator>
 
 size_t levenshteinDistance(std::string_view str1, std::string_view str2)
 {
@@ -30,4 +31,57 @@ size_t levenshteinDistance(std::string_view str1, std::string_view str2)
     levenshteinDistance(str1, tail2),
     levTailTail
   });
-}
\ No newline at end of file
+}
+std::optional<size_t> parseSize(std::string_view text)
+{
+  size_t res = 0;
+  size_t i = 0;
+  for (; i < text.size() && '0' <= text[i] && text[i] <= '9'; i += 1)
+  {
+    res = res * 10 + static_cast<size_t>(text[i] - '0');
+  }
+
+  auto const suffix = text.substr(i);
+  if (i == 0 || suffix.size() > 1)
+  {
+    return std::nullopt;
+  }
+  if (suffix == "K") return res << 10;
+  if (suffix == "M") return res << 20;
+  if (suffix == "G") return res << 30;
+  if (!suffix.empty()) return std::nullopt;
+  return res;
+}
+
+void appendJsonString(fmt::memory_buffer& out, std::string_view text)
+{
+  static constexpr char hex[] = "0123456789abcdef";
+
+  auto const raw = [&out](std::string_view str) { out.append(str.data(), str.data() + str.size()); };
+
+  out.push_back('"');
+  for (char const c : text)
+  {
+    switch (c)
+    {
+    case '"': raw("\\\""); break;
+    case '\\': raw("\\\\"); break;
+    case '\n': raw("\\n"); break;
+    case '\r': raw("\\r"); break;
+    case '\t': raw("\\t"); break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        auto const code = static_cast<unsigned char>(c);
+        char const escaped[] = {'\\', 'u', '0', '0', hex[code >> 4], hex[code & 0xf]};
+        out.append(std::begin(escaped), std::end(escaped));
+      }
+      else
+      {
+        out.push_back(c);
+      }
+      break;
+    }
+  }
+  out.push_back('"');
+}
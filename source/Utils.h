@@ -2,5 +2,81 @@
 
 #include <string_view>
 #include <fmt/core.h>
+#include <fmt/format.h>
 
-size_t levenshteinDistance(std::string_view str1, std::string_view str2);
\ No newline at end of file
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+// Reads a string in place, std::istringstream copies it
+struct ViewBuffer final : std::streambuf
+{
+  explicit ViewBuffer(std::string_view text)
+  {
+    auto const pBegin = const_cast<char*>(text.data());
+    setg(pBegin, pBegin, pBegin + text.size());
+  }
+};
+
+size_t levenshteinDistance(std::string_view str1, std::string_view str2);
+
+// A number with an optional K, M or G suffix for multiples of 1024, like
+// the sizes given on the command line
+std::optional<size_t> parseSize(std::string_view text);
+
+// Appends text quoted and escaped the way JSON requires
+void appendJsonString(fmt::memory_buffer& out, std::string_view text);
+
+// Calls func(i) for every i in [0, count) using at most `jobs` threads,
+// the calling thread included. The first exception thrown by any call
+// is rethrown once every thread has finished.
+template<typename Func>
+void parallelFor(size_t count, size_t jobs, Func&& func)
+{
+  jobs = std::clamp<size_t>(jobs, 1, std::max<size_t>(count, 1));
+
+  std::atomic<size_t> nextIdx = 0;
+  std::exception_ptr pException = nullptr;
+  std::mutex exceptionMutex;
+
+  auto const work = [&]
+  {
+    for (size_t i = nextIdx++; i < count; i = nextIdx++)
+    {
+      try
+      {
+        func(i);
+      }
+      catch (...)
+      {
+        std::scoped_lock lock(exceptionMutex);
+        if (pException == nullptr)
+        {
+          pException = std::current_exception();
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(jobs - 1);
+  for (size_t i = 1; i < jobs; i += 1)
+  {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+
+  if (pException != nullptr)
+  {
+    std::rethrow_exception(pException);
+  }
+}
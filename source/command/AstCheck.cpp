@@ -0,0 +1,183 @@
+#include "command/AstCheck.h"
+
+#include <parsing/DiagnosticEmitter.h>
+#include <parsing/Error.h>
+#include <parsing/ParallelParser.h>
+#include <Utils.h>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+using namespace command;
+
+namespace
+{
+
+// The error of the file if it has one, its text is only kept by the
+// SourceManager when an error has to show it. Any other exception is
+// reported as an error of the file, so every file is checked once.
+std::optional<Error> check(std::string const& path)
+{
+  try
+  {
+    auto fileStream = std::ifstream(path, std::ios::in | std::ios::binary);
+    if (!fileStream)
+    {
+      throw Error(path, "cannot open file");
+    }
+    std::stringstream buffer;
+    buffer << fileStream.rdbuf();
+    std::string text = std::move(buffer).str();
+
+    try
+    {
+      ast::Arena arena;
+      ParallelParser::root(text, path, 1, arena);
+    }
+    catch (Error const&)
+    {
+      SourceManager::add(path, std::move(text));
+      throw;
+    }
+  }
+  catch (Error const& err)
+  {
+    return err;
+  }
+  catch (std::exception const& ex)
+  {
+    return Error(path, fmt::format("cannot check file: {}", ex.what()));
+  }
+  catch (...)
+  {
+    return Error(path, "cannot check file");
+  }
+  return std::nullopt;
+}
+
+} // anonymous namespace
+
+std::vector<std::string> AstCheck::collect(std::vector<std::string_view> const& paths)
+{
+  std::vector<std::string> res;
+  for (auto const path : paths)
+  {
+    std::error_code ec;
+    if (!fs::is_directory(path, ec))
+    {
+      res.emplace_back(path);
+      continue;
+    }
+
+    auto const options = fs::directory_options::skip_permission_denied;
+    for (auto it = fs::recursive_directory_iterator(path, options, ec);
+      it != fs::recursive_directory_iterator();
+      it.increment(ec))
+    {
+      if (it->is_regular_file(ec) && it->path().extension() == ".mir")
+      {
+        res.push_back(it->path().string());
+      }
+    }
+  }
+
+  std::sort(res.begin(), res.end());
+  res.erase(std::unique(res.begin(), res.end()), res.end());
+  return res;
+}
+
+int AstCheck::exec(std::string_view pathToSelf, std::vector<std::string_view> const& args)
+{
+  (void)pathToSelf;
+
+  return exec(args, stdout, stderr);
+}
+
+int AstCheck::exec(std::vector<std::string_view> const& args, std::FILE* pOut, std::FILE* pErr)
+{
+  std::vector<std::string_view> paths;
+  size_t jobs = std::thread::hardware_concurrency();
+  DiagnosticFormat diagnosticsFormat = DiagnosticFormat::Text;
+  for (auto const arg : args)
+  {
+    if (arg.starts_with("--diagnostics-format="))
+    {
+      auto const parsed = diagnosticFormat(arg.substr(21));
+      if (!parsed.has_value())
+      {
+        fmt::print(pOut, "error: unknown diagnostics format '{}'\n", arg.substr(21));
+        return 1;
+      }
+      diagnosticsFormat = *parsed;
+    }
+    else if (arg.starts_with("-j"))
+    {
+      jobs = arg.size() > 2
+        ? std::strtoul(arg.substr(2).data(), nullptr, 10)
+        : std::thread::hardware_concurrency();
+    }
+    else
+    {
+      paths.push_back(arg);
+    }
+  }
+
+  if (paths.empty())
+  {
+    fmt::print(pOut, "error: no files given\n{}", helpString);
+    return 1;
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  auto const files = collect(paths);
+
+  bool const isText = diagnosticsFormat == DiagnosticFormat::Text;
+  auto diagnostics = DiagnosticEmitter(diagnosticsFormat, pOut, isText && isatty(fileno(pOut)) != 0);
+
+  // a report is emitted once every file before it has been checked, the
+  // order is deterministic while nothing waits for the slowest file
+  std::mutex mutex;
+  std::vector<std::optional<Error>> errors(files.size());
+  std::vector<bool> isChecked(files.size(), false);
+  size_t nextToEmit = 0;
+  size_t failedCount = 0;
+
+  parallelFor(files.size(), jobs, [&](size_t i)
+  {
+    auto error = check(files[i]);
+
+    auto const lock = std::scoped_lock(mutex);
+    errors[i] = std::move(error);
+    isChecked[i] = true;
+    for (; nextToEmit < files.size() && isChecked[nextToEmit]; nextToEmit += 1)
+    {
+      if (auto& err = errors[nextToEmit]; err.has_value())
+      {
+        diagnostics.emit(*err);
+        failedCount += 1;
+        err.reset();
+      }
+    }
+  });
+  diagnostics.finish();
+
+  auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+  fmt::print(pErr, "checked {} files in {:.3f}s, {} with errors\n", files.size(), elapsed.count(), failedCount);
+
+  return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace command
+{
+
+struct AstCheck
+{
+
+static constexpr std::string_view name = "ast-check";
+
+static constexpr std::string_view helpString = R"TEXT(
+Usage: mir ast-check [paths...]
+
+  Reports the compile errors that can be ascertained on the basis of
+  the source code alone for every given file and every .mir file in
+  the given directories, searched recursively. Files are checked on
+  a pool of threads, errors are reported in the order of the sorted
+  paths. A summary is printed to stderr, the exit code is 1 if any
+  file has an error.
+
+Options:
+
+  --diagnostics-format=[text|json|sarif]
+                      Report errors as text, as JSON lines or as a
+                      SARIF log, see DiagnosticEmitter.h
+  -j[N]               Check N files at once
+                      (all available cores if N is omitted)
+  -h, --help          Print this and exit
+
+)TEXT";
+
+static int exec(std::string_view pathToSelf, std::vector<std::string_view> const& args);
+
+// exec() reporting to pOut and writing the summary to pErr
+static int exec(std::vector<std::string_view> const& args, std::FILE* pOut, std::FILE* pErr);
+
+// Paths of the given files and of the .mir files in the given directories,
+// sorted so that the order of the reports never depends on the file system
+static std::vector<std::string> collect(std::vector<std::string_view> const& paths);
+
+};
+
+} // namespace command
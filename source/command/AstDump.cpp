@@ -1,61 +1,221 @@
 #include "command/AstDump.h"
 
+#include <parsing/DiagnosticEmitter.h>
 #include <parsing/Error.h>
+#include <parsing/LexerThread.h>
 #include <parsing/Tokenizer.h>
 #include <parsing/Parser.h>
+#include <parsing/ParallelParser.h>
+#include <parsing/StreamingParser.h>
+#include <parsing/ast/Export.h>
 
 #include <fmt/core.h>
 
+#include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <sstream>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+
+#include <unistd.h>
 
 namespace fs = std::filesystem;
 
 using namespace command;
 
+namespace
+{
+
+// bytes read at a time from a streamed file
+constexpr size_t BlockSize = size_t(1) << 16;
+
+// Streamed files are loaded to show the lines of an error, one that cannot
+// be loaded any more is reported without them. Called from catch handlers,
+// so nothing is thrown.
+void loadForDiagnostics(std::string const& path)
+{
+  try
+  {
+    SourceManager::load(path);
+  }
+  catch(...)
+  {
+  }
+}
+
+} // anonymous namespace
+
 int AstDump::exec(std::string_view pathToSelf, std::vector<std::string_view> const& args)
 {
   (void)pathToSelf;
 
-  // TODO parse arguments
+  // TODO parse remaining arguments
+
+  std::string path;
+  size_t jobs = 1;
+  bool lexThread = false;
+  std::optional<ast::ExportFormat> format;
+  DiagnosticFormat diagnosticsFormat = DiagnosticFormat::Text;
+  for (auto const arg : args)
+  {
+    if (arg == "--lex-thread")
+    {
+      lexThread = true;
+    }
+    else if (arg.starts_with("--format="))
+    {
+      format = ast::exportFormat(arg.substr(9));
+      if (!format.has_value())
+      {
+        fmt::print("error: unknown format '{}'\n", arg.substr(9));
+        return 1;
+      }
+    }
+    else if (arg.starts_with("--diagnostics-format="))
+    {
+      auto const parsed = diagnosticFormat(arg.substr(21));
+      if (!parsed.has_value())
+      {
+        fmt::print("error: unknown diagnostics format '{}'\n", arg.substr(21));
+        return 1;
+      }
+      diagnosticsFormat = *parsed;
+    }
+    else if (arg.starts_with("-j"))
+    {
+      jobs = arg.size() > 2
+        ? std::strtoul(arg.substr(2).data(), nullptr, 10)
+        : std::thread::hardware_concurrency();
+    }
+    else
+    {
+      path = arg;
+    }
+  }
+
+  // structured diagnostics go to stderr so that they never mix with the tree
+  bool const isText = diagnosticsFormat == DiagnosticFormat::Text;
+  auto diagnostics = DiagnosticEmitter(
+    diagnosticsFormat,
+    isText ? stdout : stderr,
+    isText && isatty(fileno(stdout)) != 0);
+
+  auto const report = [&](Error const& err)
+  {
+    // TODO +1 to all line info
+    if (isText)
+    {
+      fmt::print("\n");
+    }
+    diagnostics.emit(err);
+    if (isText)
+    {
+      fmt::print("\n");
+    }
+  };
 
-  ast::Node::SPtr pAst = nullptr;
-  if (args.empty())
+  // prints every top-level declaration as soon as it is complete, only the
+  // declarations being printed are kept
+  auto const stream = [&](std::istream& input, std::string const& sourcePath, bool isInteractive)
   {
-    auto parser = Parser(Tokenizer(std::cin, "<stdout>"));
+    auto parser = StreamingParser(sourcePath);
+    parser.setKeepsTree(false);
 
-    fmt::print("Waiting for import from stdout...   (Use Ctrl+D to stop)\n\n");
+    auto const print = [&](std::vector<ast::Node::Ptr> const& nodes)
+    {
+      for (auto const& pNode : nodes)
+      {
+        if (format.has_value())
+        {
+          ast::exportTree(pNode, *format, parser.lineStarts(), stdout, parser.firstLine());
+          continue;
+        }
+        fmt::print("\n");
+        pNode->print(stdout);
+        fmt::print("\n");
+      }
+    };
 
     try
     {
-      pAst = parser.root();
+      if (isInteractive)
+      {
+        std::string line;
+        while (std::getline(input, line))
+        {
+          line += '\n';
+          print(parser.push(line));
+          std::fflush(stdout);
+        }
+      }
+      else
+      {
+        std::string block(BlockSize, '\0');
+        while (input.read(block.data(), static_cast<std::streamsize>(block.size())) || input.gcount() > 0)
+        {
+          print(parser.push(std::string_view(block.data(), static_cast<size_t>(input.gcount()))));
+        }
+      }
+      print(parser.finish());
     }
     catch(Error const& err)
     {
-      // TODO +1 to all line info
-      fmt::print("\n{}\n\n", err);
+      if (!isInteractive)
+      {
+        loadForDiagnostics(sourcePath);
+      }
+      report(err);
+      return 1;
     }
-  }
-  else
+    return 0;
+  };
+
+  if (path.empty())
   {
-    std::string const path = args[0].data();
-    if (!fs::exists(path))
+    if (!format.has_value())
     {
-      fmt::print("error: file '{}' doesn't exist", path);
+      fmt::print("Waiting for import from stdout...   (Use Ctrl+D to stop)\n\n");
     }
+    return stream(std::cin, "<stdout>", true);
+  }
 
-    auto fileStream = std::ifstream(path, std::ios::in);
-    auto parser = Parser(Tokenizer(fileStream, path));
-    try
+  if (!fs::exists(path))
+  {
+    fmt::print("error: file '{}' doesn't exist", path);
+    return 1;
+  }
+
+  if (format.has_value())
+  {
+    // one top-level declaration at a time, in constant memory
+    auto fileStream = std::ifstream(path, std::ios::in | std::ios::binary);
+    return stream(fileStream, path, false);
+  }
+
+  ast::Arena arena;
+  ast::Node::Ptr pAst = nullptr;
+  try
+  {
+    if (lexThread && jobs <= 1)
     {
+      auto fileStream = std::ifstream(path, std::ios::in);
+      auto parser = Parser(LexerThread(fileStream, path), arena);
       pAst = parser.root();
     }
-    catch(Error const& err)
+    else
     {
-      // TODO +1 to all line info
-      fmt::print("\n{}\n\n", err);
+      auto const file = SourceManager::load(path);
+      pAst = ParallelParser::root(SourceManager::text(file), file, jobs, arena);
     }
-    fileStream.close();
+  }
+  catch(Error const& err)
+  {
+    // the lexer thread streams the file, it is loaded to show the lines
+    loadForDiagnostics(path);
+    report(err);
   }
 
   if (pAst == nullptr)
@@ -63,7 +223,9 @@ int AstDump::exec(std::string_view pathToSelf, std::vector<std::string_view> con
     return 1;
   }
 
-  fmt::print("\n{}\n\n", pAst->toString());
+  fmt::print("\n");
+  pAst->print(stdout);
+  fmt::print("\n\n");
 
   return 0;
 }
\ No newline at end of file
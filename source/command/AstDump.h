@@ -9,7 +9,6 @@ namespace command
 struct AstDump
 {
 
-// rename into ast-check
 // add --dump flag
 
 static constexpr std::string_view name = "ast-dump";
@@ -22,12 +21,26 @@ Usage: mir ast-dump [file]
   errors are found, the syntax tree representation of the source
   file will be printed.
 
-  if [file] is ommited, stdin is used.
+  if [file] is ommited, stdin is used and every top-level declaration
+  is printed as soon as it is complete.
 
 Options:
 
   --ascii             Print tree using only ascii characters
   --color [on|off]    Enable or disable colored output
+  --diagnostics-format=[text|json|sarif]
+                      Report errors as text, as JSON lines or as a
+                      SARIF log on stderr, see DiagnosticEmitter.h
+  --format=[json|sexpr]
+                      Print the tree as JSON or as an s-expression
+                      for tools, one line per top-level declaration
+                      or field, see ast/Export.h. Files are read one
+                      declaration at a time (-j and --lex-thread
+                      are ignored)
+  -j[N]               Parse top-level declarations on N threads
+                      (all available cores if N is omitted)
+  --lex-thread        Tokenize on a separate thread while parsing
+                      (ignored with -j)
   -h, --help    Print this and exit
 
 )TEXT";
@@ -0,0 +1,220 @@
+#include "command/Bench.h"
+
+#include <Benchmark.h>
+#include <Corpus.h>
+#include <Utils.h>
+#include <parsing/DiagnosticRenderer.h>
+#include <parsing/Error.h>
+#include <parsing/Parser.h>
+#include <parsing/Tokenizer.h>
+#include <parsing/ast/Walker.h>
+
+#include <fmt/core.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <sstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+using namespace command;
+
+namespace
+{
+
+struct Source
+{
+  std::string path;
+  std::string text;
+};
+
+struct CountNodes
+{
+  size_t count = 0;
+  void pre(ast::Node::Ptr) { count += 1; }
+};
+
+// durations in seconds of the measured runs, setup runs untimed before
+// every run
+Samples measure(
+  size_t warmup,
+  size_t iterations,
+  std::function<void()> const& run,
+  std::function<void()> const& setup = nullptr)
+{
+  std::vector<double> durations;
+  durations.reserve(iterations);
+  for (size_t i = 0; i < warmup + iterations; i += 1)
+  {
+    if (setup != nullptr)
+    {
+      setup();
+    }
+    auto const start = std::chrono::steady_clock::now();
+    run();
+    auto const duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    if (i >= warmup)
+    {
+      durations.push_back(duration.count());
+    }
+  }
+  return Samples(std::move(durations));
+}
+
+} // anonymous namespace
+
+int Bench::exec(std::string_view pathToSelf, std::vector<std::string_view> const& args)
+{
+  (void)pathToSelf;
+
+  std::vector<Source> sources;
+  size_t
+    iterations = 10,
+    warmup = 2;
+  CorpusOptions corpus;
+  for (auto const arg : args)
+  {
+    std::optional<size_t> value;
+    if (arg.starts_with("--iterations="))
+    {
+      value = parseSize(arg.substr(13));
+      iterations = value.value_or(0);
+    }
+    else if (arg.starts_with("--warmup="))
+    {
+      value = parseSize(arg.substr(9));
+      warmup = value.value_or(0);
+    }
+    else if (arg.starts_with("--size="))
+    {
+      value = parseSize(arg.substr(7));
+      corpus.size = value.value_or(0);
+    }
+    else if (arg.starts_with("--seed="))
+    {
+      value = parseSize(arg.substr(7));
+      corpus.seed = value.value_or(0);
+    }
+    else
+    {
+      if (!fs::exists(arg))
+      {
+        fmt::print("error: file '{}' doesn't exist\n", arg);
+        return 1;
+      }
+      auto const file = SourceManager::load(std::string(arg));
+      sources.push_back({std::string(arg), std::string(SourceManager::text(file))});
+      continue;
+    }
+
+    if (!value.has_value())
+    {
+      fmt::print("error: invalid value in '{}'\n", arg);
+      return 1;
+    }
+  }
+  iterations = std::max<size_t>(iterations, 1);
+
+  if (sources.empty())
+  {
+    sources.push_back({"<synthetic>", generateCorpus(corpus)});
+    SourceManager::add(sources.back().path, sources.back().text);
+  }
+
+  size_t bytes = 0;
+  for (auto const& source : sources)
+  {
+    bytes += source.text.size();
+  }
+
+  // the same code paths ast-dump uses without threads, one tree per source
+  size_t tokenCount = 0;
+  size_t nodeCount = 0;
+  std::vector<std::unique_ptr<ast::Arena>> arenas;
+  std::vector<ast::Node::Ptr> trees;
+
+  auto const tokenize = [&]
+  {
+    tokenCount = 0;
+    for (auto const& source : sources)
+    {
+      auto textStream = std::istringstream(source.text, std::ios::in);
+      auto tokenizer = Tokenizer(textStream, source.path);
+      for (auto tok = tokenizer.next(); tok.tag() != Token::Eof; tok = tokenizer.next())
+      {
+        tokenCount += 1;
+      }
+    }
+  };
+  // the trees of the previous run are released before the timer starts
+  auto const release = [&]
+  {
+    arenas.clear();
+    trees.clear();
+    arenas.reserve(sources.size());
+    trees.reserve(sources.size());
+  };
+  auto const parse = [&]
+  {
+    for (auto const& source : sources)
+    {
+      auto textStream = std::istringstream(source.text, std::ios::in);
+      auto& arena = *arenas.emplace_back(std::make_unique<ast::Arena>());
+      auto parser = Parser(Tokenizer(textStream, source.path), arena);
+      trees.push_back(parser.root());
+    }
+  };
+  auto const dump = [&]
+  {
+    fmt::memory_buffer out;
+    for (auto const pTree : trees)
+    {
+      out.clear();
+      pTree->print(out);
+    }
+  };
+
+  Samples tokenizeSamples({}), parseSamples({}), dumpSamples({});
+  try
+  {
+    tokenizeSamples = measure(warmup, iterations, tokenize);
+    parseSamples = measure(warmup, iterations, parse, release);
+    dumpSamples = measure(warmup, iterations, dump);
+  }
+  catch (Error const& err)
+  {
+    fmt::print("\n{}\n", DiagnosticRenderer().render(err));
+    return 1;
+  }
+
+  CountNodes counter;
+  ast::Walker walker;
+  for (auto const pTree : trees)
+  {
+    walker.walk(pTree, counter);
+  }
+  nodeCount = counter.count;
+
+  double const megabytes = static_cast<double>(bytes) / 1e6;
+  fmt::print("{} sources, {:.2f} MB, {} tokens, {} nodes, {} runs after {} warmup runs\n\n",
+    sources.size(), megabytes, tokenCount, nodeCount, iterations, warmup);
+  fmt::print("  {:<10}{:>12}{:>12}{:>12}{:>12}\n", "phase", "median ms", "p90 ms", "p99 ms", "MB/s");
+  auto const row = [&](std::string_view phase, Samples const& samples)
+  {
+    fmt::print("  {:<10}{:>12.3f}{:>12.3f}{:>12.3f}{:>12.2f}\n",
+      phase, samples.median() * 1e3, samples.percentile(90) * 1e3, samples.percentile(99) * 1e3,
+      megabytes / samples.median());
+  };
+  row("tokenize", tokenizeSamples);
+  row("parse", parseSamples);
+  row("dump", dumpSamples);
+
+  fmt::print("\n  {:.0f} tokens/s, {:.0f} nodes/s, peak RSS {:.1f} MB\n",
+    static_cast<double>(tokenCount) / tokenizeSamples.median(),
+    static_cast<double>(nodeCount) / parseSamples.median(),
+    static_cast<double>(peakRss()) / 1e6);
+  return 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+namespace command
+{
+
+struct Bench
+{
+
+static constexpr std::string_view name = "bench";
+
+static constexpr std::string_view helpString = R"TEXT(
+Usage: mir bench [files...]
+
+  Tokenize, parse and print the syntax trees of the given .mir
+  source files, or of generated source if none are given, several
+  times after a few warmup runs. Prints the median, 90th and 99th
+  percentile of every phase, the MB/s at the median, the nodes
+  parsed per second and the peak resident set size.
+
+Options:
+
+  --iterations=N      Measured runs of every phase (default 10)
+  --warmup=N          Runs before measuring (default 2)
+  --size=N[K|M|G]     Bytes of source to generate when no files
+                      are given (default 1M)
+  --seed=N            Seed of the generated source (default 0),
+                      see mir generate
+  -h, --help          Print this and exit
+
+)TEXT";
+
+static int exec(std::string_view pathToSelf, std::vector<std::string_view> const& args);
+
+};
+
+} // namespace command
@@ -1,4 +1,8 @@
 #pragma once
 
+#include <command/AstCheck.h>
 #include <command/AstDump.h>
-#include <command/OpTable.h>
\ No newline at end of file
+#include <command/Bench.h>
+#include <command/Generate.h>
+#include <command/OpTable.h>
+#include <command/Tokens.h>
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "command/Generate.h"
+
+#include <Corpus.h>
+#include <Utils.h>
+
+#include <fmt/core.h>
+
+using namespace command;
+
+int Generate::exec(std::string_view pathToSelf, std::vector<std::string_view> const& args)
+{
+  (void)pathToSelf;
+
+  CorpusOptions options;
+  for (auto const arg : args)
+  {
+    std::optional<size_t> value;
+    if (arg.starts_with("--size="))
+    {
+      value = parseSize(arg.substr(7));
+      options.size = value.value_or(0);
+    }
+    else if (arg.starts_with("--depth="))
+    {
+      value = parseSize(arg.substr(8));
+      options.maxDepth = value.value_or(0);
+    }
+    else if (arg.starts_with("--identifiers="))
+    {
+      value = parseSize(arg.substr(14));
+      options.identifierCount = value.value_or(0);
+    }
+    else if (arg.starts_with("--seed="))
+    {
+      value = parseSize(arg.substr(7));
+      options.seed = value.value_or(0);
+    }
+
+    if (!value.has_value())
+    {
+      fmt::print(stderr, "error: invalid option '{}'\n{}", arg, helpString);
+      return 1;
+    }
+  }
+
+  generateCorpus(options, stdout);
+  return 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+namespace command
+{
+
+struct Generate
+{
+
+static constexpr std::string_view name = "generate";
+
+static constexpr std::string_view helpString = R"TEXT(
+Usage: mir generate [options]
+
+  Print random but valid .mir source using every construct the
+  parser supports, for benchmarks and scaling tests. The same
+  options always print the same source.
+
+Options:
+
+  --size=N[K|M|G]     Bytes to print (default 1M)
+  --depth=N           Nesting depth of types, blocks and control
+                      flow (default 4)
+  --identifiers=N     Distinct identifiers to use (default 256)
+  --seed=N            Seed of the random numbers (default 0)
+  -h, --help          Print this and exit
+
+)TEXT";
+
+static int exec(std::string_view pathToSelf, std::vector<std::string_view> const& args);
+
+};
+
+} // namespace command
@@ -0,0 +1,119 @@
+#include "command/Tokens.h"
+
+#include <parsing/DiagnosticRenderer.h>
+#include <parsing/Error.h>
+#include <parsing/Intern.h>
+#include <parsing/Tokenizer.h>
+
+#include <fmt/core.h>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+using namespace command;
+
+int Tokens::exec(std::string_view pathToSelf, std::vector<std::string_view> const& args)
+{
+  (void)pathToSelf;
+
+  std::string path;
+  bool countOnly = false;
+  for (auto const arg : args)
+  {
+    if (arg == "--count")
+    {
+      countOnly = true;
+    }
+    else
+    {
+      path = arg;
+    }
+  }
+
+  if (!path.empty() && !fs::exists(path))
+  {
+    fmt::print("error: file '{}' doesn't exist\n", path);
+    return 1;
+  }
+
+  // read up front so that only tokenizing is timed
+  std::stringstream input;
+  if (path.empty())
+  {
+    input << std::cin.rdbuf();
+  }
+  else
+  {
+    input << std::ifstream(path, std::ios::in | std::ios::binary).rdbuf();
+  }
+  size_t const byteCount = static_cast<size_t>(input.tellp());
+  // kept to show the line of an error
+  auto const file = SourceManager::add(path.empty() ? "<stdin>" : path, input.str());
+
+  std::array<size_t, Token::Eof + 1> tagCounts = {};
+  std::vector<Token> tokens;
+  size_t const
+    internCountBefore = Intern::count(),
+    internBytesBefore = Intern::bytes();
+
+  auto const start = std::chrono::steady_clock::now();
+  try
+  {
+    auto tokenizer = Tokenizer(input, file);
+    for (auto tok = tokenizer.next(); tok.tag() != Token::Eof; tok = tokenizer.next())
+    {
+      tagCounts[tok.tag()] += 1;
+      if (!countOnly)
+      {
+        tokens.push_back(tok);
+      }
+    }
+  }
+  catch (Error const& err)
+  {
+    fmt::print("\n{}\n", DiagnosticRenderer().render(err));
+    return 1;
+  }
+  auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  size_t tokenCount = 0;
+  for (auto const count : tagCounts)
+  {
+    tokenCount += count;
+  }
+
+  if (countOnly)
+  {
+    fmt::print("{}\n", tokenCount);
+  }
+  else
+  {
+    fmt::memory_buffer out;
+    for (auto const& tok : tokens)
+    {
+      fmt::format_to(std::back_inserter(out), "{:s}\n", tok);
+    }
+    std::fwrite(out.data(), 1, out.size(), stdout);
+  }
+
+  double const perSecond = seconds > 0 ? 1 / seconds : 0;
+  fmt::print(stderr, "\n{} bytes, {} tokens in {:.3f}s\n", byteCount, tokenCount, seconds);
+  fmt::print(stderr, "{:.2f} MB/s, {:.0f} tokens/s\n",
+    static_cast<double>(byteCount) * perSecond / 1e6, static_cast<double>(tokenCount) * perSecond);
+  fmt::print(stderr, "interned {} new strings of {} bytes, {} in total\n",
+    Intern::count() - internCountBefore, Intern::bytes() - internBytesBefore, Intern::count());
+  fmt::print(stderr, "\n");
+  for (size_t tag = 0; tag < tagCounts.size(); tag += 1)
+  {
+    if (tagCounts[tag] > 0)
+    {
+      fmt::print(stderr, "  {:d<16}{:>12}\n", static_cast<Token::Tag>(tag), tagCounts[tag]);
+    }
+  }
+  return 0;
+}
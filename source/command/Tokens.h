@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+namespace command
+{
+
+struct Tokens
+{
+
+static constexpr std::string_view name = "tokens";
+
+static constexpr std::string_view helpString = R"TEXT(
+Usage: mir tokens [file]
+
+  Tokenize a .mir source file and print its tokens, one per line.
+  When done, the time spent tokenizing, the bytes and tokens per
+  second, the number of tokens of every tag and how much the string
+  interner grew are printed to stderr.
+
+  If [file] is ommited, stdin is used.
+
+Options:
+
+  --count             Only print the number of tokens
+  -h, --help          Print this and exit
+
+)TEXT";
+
+static int exec(std::string_view pathToSelf, std::vector<std::string_view> const& args);
+
+};
+
+} // namespace command
@@ -0,0 +1,205 @@
+#include "parsing/DeclarationScanner.h"
+
+namespace
+{
+
+bool isWordStart(int c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '@';
+}
+
+bool isWordChar(int c)
+{
+  return isWordStart(c) || (c >= '0' && c <= '9');
+}
+
+} // anonymous namespace
+
+bool DeclarationScanner::Input::await_ready() const noexcept
+{
+  return pScanner->d_pieceIdx < pScanner->d_piece.size() || pScanner->d_isFinished;
+}
+
+int DeclarationScanner::Input::await_resume() noexcept
+{
+  auto& scanner = *pScanner;
+  if (scanner.d_pieceIdx >= scanner.d_piece.size())
+  {
+    return eof;
+  }
+
+  char const c = scanner.d_piece[scanner.d_pieceIdx];
+  if (consume)
+  {
+    scanner.d_pieceIdx += 1;
+    scanner.d_offset += 1;
+    if (c == '\n')
+    {
+      scanner.d_position.line += 1;
+      scanner.d_position.column = 0;
+    }
+    else
+    {
+      scanner.d_position.column += 1;
+    }
+  }
+  return c;
+}
+
+DeclarationScanner::DeclarationScanner()
+  : d_task(scan())
+  , d_pieceIdx(0)
+  , d_isFinished(false)
+  , d_offset(0)
+  , d_position(0, 0)
+{
+  d_boundaries.push_back({0, Position(0, 0)});
+}
+
+DeclarationScanner::~DeclarationScanner()
+{
+  d_task.handle.destroy();
+}
+
+void DeclarationScanner::dropBoundaries()
+{
+  d_boundaries.erase(d_boundaries.begin(), d_boundaries.end() - 1);
+}
+
+void DeclarationScanner::push(std::string_view piece)
+{
+  d_piece = piece;
+  d_pieceIdx = 0;
+  if (!d_task.handle.done())
+  {
+    d_task.handle.resume();
+  }
+}
+
+void DeclarationScanner::finish()
+{
+  d_piece = std::string_view();
+  d_pieceIdx = 0;
+  d_isFinished = true;
+  if (!d_task.handle.done())
+  {
+    d_task.handle.resume();
+  }
+}
+
+DeclarationScanner::Task DeclarationScanner::scan()
+{
+  size_t depth = 0;
+  bool isInLet = false;
+  std::string word;
+
+  while (true)
+  {
+    int const c = co_await next();
+    if (c == eof)
+    {
+      co_return;
+    }
+
+    if (c == '/' && co_await peek() == '/')
+    {
+      while (co_await peek() != '\n' && co_await next() != eof) {}
+      continue;
+    }
+
+    if (c == '/' && co_await peek() == '*')
+    {
+      co_await next();
+      size_t commentNestLevel = 1;
+      while (commentNestLevel > 0)
+      {
+        int const inner = co_await next();
+        if (inner == eof)
+        {
+          co_return;
+        }
+        if (inner == '/' && co_await peek() == '*')
+        {
+          co_await next();
+          commentNestLevel += 1;
+        }
+        else if (inner == '*' && co_await peek() == '/')
+        {
+          co_await next();
+          commentNestLevel -= 1;
+        }
+      }
+      continue;
+    }
+
+    if (c == '"')
+    {
+      while (true)
+      {
+        int const inner = co_await peek();
+        if (inner == eof || inner == '"' || inner == '\n')
+        {
+          break;
+        }
+        co_await next();
+        if (inner == '\\' && co_await next() == eof)
+        {
+          break;
+        }
+      }
+      if (co_await peek() == '"')
+      {
+        co_await next();
+      }
+      continue;
+    }
+
+    if (isWordStart(c))
+    {
+      word.assign(1, static_cast<char>(c));
+      while (isWordChar(co_await peek()))
+      {
+        word.push_back(static_cast<char>(co_await next()));
+      }
+      if (depth == 0 && word == "let")
+      {
+        // let statement parts are separated by commas too
+        isInLet = true;
+      }
+      continue;
+    }
+
+    switch (c)
+    {
+    case '(':
+    case '[':
+    case '{':
+      depth += 1;
+      break;
+
+    case ')':
+    case ']':
+    case '}':
+      depth -= (depth > 0) ? 1 : 0;
+      break;
+
+    case ';':
+      if (depth == 0)
+      {
+        d_boundaries.push_back({d_offset, d_position});
+        isInLet = false;
+      }
+      break;
+
+    case ',':
+      if (depth == 0 && !isInLet)
+      {
+        d_boundaries.push_back({d_offset, d_position});
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+}
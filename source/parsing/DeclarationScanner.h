@@ -0,0 +1,89 @@
+#pragma once
+
+#include <parsing/Position.h>
+
+#include <coroutine>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Finds the top-level declaration and field boundaries of a source pushed
+// in pieces of any size. The scanner is a coroutine that suspends whenever
+// it runs out of bytes and is resumed by the next push(), so no byte is
+// looked at twice and pieces are not copied.
+struct DeclarationScanner final
+{
+public:
+  // Types
+  struct Boundary
+  {
+    size_t offset;
+    Position position;
+  };
+
+private:
+  struct Task
+  {
+    struct promise_type
+    {
+      Task get_return_object() { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_always final_suspend() noexcept { return {}; }
+      void return_void() {}
+      void unhandled_exception() { throw; }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+  };
+
+  // Suspends until a byte is available or the input is finished,
+  // returns the byte or eof
+  struct Input
+  {
+    DeclarationScanner* pScanner;
+    bool consume;
+
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<>) const noexcept {}
+    int await_resume() noexcept;
+  };
+
+  static constexpr int eof = -1;
+
+  // Data
+  Task d_task;
+  std::string_view d_piece;
+  size_t d_pieceIdx;
+  bool d_isFinished;
+  size_t d_offset;
+  Position d_position;
+  std::vector<Boundary> d_boundaries;
+
+public:
+  // Constructors
+  DeclarationScanner();
+  DeclarationScanner(DeclarationScanner const&) = delete;
+  ~DeclarationScanner();
+
+  // Methods
+  // scans all of piece before returning
+  void push(std::string_view piece);
+  void finish();
+
+  // Offsets right after every top-level ';' or ',' that ends a declaration
+  // or a field, found by tracking bracket depth while skipping strings and
+  // comments. The first boundary is the start of the source or the one
+  // kept by the last dropBoundaries().
+  std::vector<Boundary> const& boundaries() const { return d_boundaries; }
+  // Forgets all but the last boundary, for callers that are done with them
+  void dropBoundaries();
+
+  // Operators
+  DeclarationScanner& operator=(DeclarationScanner const&) = delete;
+
+private:
+  Task scan();
+
+  Input next() { return Input{this, true}; }
+  Input peek() { return Input{this, false}; }
+};
@@ -0,0 +1,178 @@
+#include "parsing/DiagnosticEmitter.h"
+
+#include <Utils.h>
+
+#include <cassert>
+#include <iterator>
+
+namespace
+{
+
+constexpr std::string_view sarifHeader =
+  "{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\","
+  "\"version\":\"2.1.0\","
+  "\"runs\":[{\"tool\":{\"driver\":{\"name\":\"mir\"}},\"results\":[";
+
+constexpr std::string_view sarifFooter = "]}]}\n";
+
+std::string_view tagName(Error::Tag tag)
+{
+  return tag == Error::Tag::Error ? "error" : "note";
+}
+
+} // anonymous namespace
+
+std::optional<DiagnosticFormat> diagnosticFormat(std::string_view name)
+{
+  if (name == "text")
+  {
+    return DiagnosticFormat::Text;
+  }
+  if (name == "json")
+  {
+    return DiagnosticFormat::Json;
+  }
+  if (name == "sarif")
+  {
+    return DiagnosticFormat::Sarif;
+  }
+  return std::nullopt;
+}
+
+DiagnosticEmitter::DiagnosticEmitter(DiagnosticFormat format, std::FILE* pFile, bool color)
+  : d_format(format)
+  , d_renderer(color)
+  , d_pFile(pFile)
+  , d_count(0)
+  , d_isFinished(false)
+{
+  if (d_format == DiagnosticFormat::Sarif)
+  {
+    raw(sarifHeader);
+    flush();
+  }
+}
+
+DiagnosticEmitter::~DiagnosticEmitter()
+{
+  finish();
+}
+
+void DiagnosticEmitter::emit(Error const& error)
+{
+  assert(!d_isFinished);
+  auto const& parts = error.parts();
+
+  switch (d_format)
+  {
+  case DiagnosticFormat::Text:
+    d_renderer.render(error, d_out);
+    break;
+  case DiagnosticFormat::Json:
+    raw("{");
+    jsonPart(parts.front());
+    raw(",\"notes\":[");
+    for (size_t i = 1; i < parts.size(); i += 1)
+    {
+      raw(i > 1 ? ",{" : "{");
+      jsonPart(parts[i]);
+      raw("}");
+    }
+    raw("]}\n");
+    break;
+  case DiagnosticFormat::Sarif:
+  {
+    auto const& part = parts.front();
+    raw(d_count > 0 ? ",{\"level\":" : "{\"level\":");
+    appendJsonString(d_out, tagName(part.tag()));
+    raw(",\"message\":{\"text\":");
+    appendJsonString(d_out, part.message());
+    raw("},\"locations\":[{");
+    sarifLocation(part);
+    raw("}],\"relatedLocations\":[");
+    for (size_t i = 1; i < parts.size(); i += 1)
+    {
+      // a related location is a location with a message
+      raw(i > 1 ? ",{\"message\":{\"text\":" : "{\"message\":{\"text\":");
+      appendJsonString(d_out, parts[i].message());
+      raw("},");
+      sarifLocation(parts[i]);
+      raw("}");
+    }
+    raw("]}");
+    break;
+  }
+  }
+
+  d_count += 1;
+  flush();
+}
+
+void DiagnosticEmitter::finish()
+{
+  if (d_isFinished)
+  {
+    return;
+  }
+  d_isFinished = true;
+
+  if (d_format == DiagnosticFormat::Sarif)
+  {
+    raw(sarifFooter);
+    flush();
+  }
+}
+
+void DiagnosticEmitter::jsonPart(Error::Part const& part)
+{
+  auto const it = std::back_inserter(d_out);
+  auto const position = [&](Position position)
+  {
+    if (!position.isValid())
+    {
+      raw("null");
+      return;
+    }
+    fmt::format_to(it, "[{},{}]", position.line, position.column);
+  };
+
+  raw("\"tag\":");
+  appendJsonString(d_out, tagName(part.tag()));
+  raw(",\"file\":");
+  appendJsonString(d_out, part.filePath());
+  raw(",\"start\":");
+  position(part.start());
+  raw(",\"end\":");
+  position(part.end());
+  raw(",\"message\":");
+  appendJsonString(d_out, part.message());
+}
+
+void DiagnosticEmitter::sarifLocation(Error::Part const& part)
+{
+  raw("\"physicalLocation\":{\"artifactLocation\":{\"uri\":");
+  appendJsonString(d_out, part.filePath());
+  raw("}");
+  if (part.start().isValid())
+  {
+    auto const start = part.start();
+    auto const end = part.end().isValid() ? part.end() : start.nextColumn();
+    fmt::format_to(
+      std::back_inserter(d_out),
+      ",\"region\":{{\"startLine\":{},\"startColumn\":{},\"endLine\":{},\"endColumn\":{}}}",
+      start.line + 1, start.column + 1, end.line + 1, end.column + 1);
+  }
+  raw("}");
+}
+
+void DiagnosticEmitter::raw(std::string_view text)
+{
+  d_out.append(text.data(), text.data() + text.size());
+}
+
+void DiagnosticEmitter::flush()
+{
+  std::fwrite(d_out.data(), 1, d_out.size(), d_pFile);
+  std::fflush(d_pFile);
+  d_out.clear();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <parsing/DiagnosticRenderer.h>
+#include <parsing/Error.h>
+
+#include <fmt/format.h>
+
+#include <cstdio>
+#include <optional>
+#include <string_view>
+
+enum class DiagnosticFormat
+{
+  Text,
+  Json,
+  Sarif,
+};
+
+// "text", "json" or "sarif"
+std::optional<DiagnosticFormat> diagnosticFormat(std::string_view name);
+
+// Writes errors to a file as soon as they are emitted, nothing is kept
+// once a diagnostic is written and the file is flushed after each one.
+//
+// Text is what DiagnosticRenderer writes. Json writes one object per line
+// with the fields in this order, the parts after the first are notes:
+//
+//   {"tag":"error","file":"a.mir","start":[1,4],"end":[1,5],"message":"...",
+//    "notes":[{"tag":"note","file":...,"start":...,"end":...,"message":...}]}
+//
+// with 0-based positions like everywhere else, null if a part has none.
+// Sarif writes a SARIF 2.1.0 log whose results are streamed, the log is
+// closed by finish() and its regions are 1-based as SARIF requires.
+struct DiagnosticEmitter final
+{
+private:
+  // Data
+  DiagnosticFormat d_format;
+  DiagnosticRenderer d_renderer;
+  std::FILE* d_pFile;
+  fmt::memory_buffer d_out;
+  size_t d_count;
+  bool d_isFinished;
+
+public:
+  // Constructors
+  DiagnosticEmitter(DiagnosticFormat format, std::FILE* pFile, bool color = false);
+
+  DiagnosticEmitter(DiagnosticEmitter const&) = delete;
+  DiagnosticEmitter& operator=(DiagnosticEmitter const&) = delete;
+
+  // Finishes the output if finish() was not called
+  ~DiagnosticEmitter();
+
+  // Methods
+  // Number of errors emitted so far
+  size_t count() const { return d_count; }
+
+  void emit(Error const& error);
+  // Closes the SARIF log, also written when nothing was emitted
+  void finish();
+
+private:
+  // the members of the objects, without braces
+  void jsonPart(Error::Part const& part);
+  void sarifLocation(Error::Part const& part);
+  void raw(std::string_view text);
+  void flush();
+};
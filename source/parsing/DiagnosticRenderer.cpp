@@ -0,0 +1,89 @@
+#include "parsing/DiagnosticRenderer.h"
+
+#include <fmt/color.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+
+constexpr auto errorStyle = fmt::emphasis::bold | fmt::fg(fmt::color::red);
+constexpr auto noteStyle = fmt::emphasis::bold | fmt::fg(fmt::color::cyan);
+constexpr auto gutterStyle = fmt::fg(fmt::color::steel_blue);
+
+size_t digits(size_t value)
+{
+  size_t res = 1;
+  for (; value >= 10; value /= 10)
+  {
+    res += 1;
+  }
+  return res;
+}
+
+} // anonymous namespace
+
+void DiagnosticRenderer::render(Error const& error, fmt::memory_buffer& out) const
+{
+  for (auto const& part : error.parts())
+  {
+    renderPart(part, out);
+  }
+}
+
+std::string DiagnosticRenderer::render(Error const& error) const
+{
+  fmt::memory_buffer out;
+  render(error, out);
+  return fmt::to_string(out);
+}
+
+void DiagnosticRenderer::renderPart(Error::Part const& part, fmt::memory_buffer& out) const
+{
+  auto const it = std::back_inserter(out);
+  auto const style = [this](fmt::text_style style) { return d_color ? style : fmt::text_style(); };
+
+  auto const start = part.start();
+  bool const hasPosition = start.isValid();
+
+  if (hasPosition)
+  {
+    fmt::format_to(it, "{}:{}: ", part.filePath(), start);
+  }
+  else
+  {
+    fmt::format_to(it, "{}: ", part.filePath());
+  }
+  auto const tagStyle = part.tag() == Error::Tag::Error ? errorStyle : noteStyle;
+  fmt::format_to(it, style(tagStyle), "{}", part.tag());
+  fmt::format_to(it, ": {}\n", part.message());
+
+  if (!hasPosition || !SourceManager::hasText(part.file())
+    || start.line >= SourceManager::lineStarts(part.file()).size())
+  {
+    return;
+  }
+
+  auto const line = SourceManager::line(part.file(), start.line);
+  size_t const width = digits(start.line);
+
+  fmt::format_to(it, style(gutterStyle), "{:>{}} | ", start.line, width + 2);
+  out.append(line.data(), line.data() + line.size());
+  out.push_back('\n');
+
+  // the underline copies tabs so that it stays aligned with the line
+  size_t const
+    begin = std::min(start.column, line.size()),
+    end = (part.end().isValid() && part.end().line == start.line)
+      ? std::max(std::min(part.end().column, line.size()), begin + 1)
+      : std::max(line.size(), begin + 1);
+
+  fmt::format_to(it, style(gutterStyle), "{:>{}} | ", "", width + 2);
+  for (size_t i = 0; i < begin; i += 1)
+  {
+    out.push_back(line[i] == '\t' ? '\t' : ' ');
+  }
+  fmt::format_to(it, style(tagStyle), "^{:~>{}}", "", end - begin - 1);
+  out.push_back('\n');
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <parsing/Error.h>
+
+#include <fmt/format.h>
+
+#include <string>
+
+// Renders errors with the source lines they point at:
+//
+//   file.mir:2:10: error: expression expected
+//      2 | let a = ;
+//        |         ^
+//
+// Lines are looked up in the line tables of the SourceManager, files
+// without a text and parts without a position only get the first line.
+// Positions are shown like fmt::formatter<Error::Part> shows them. Spans
+// over several lines are underlined to the end of their first line.
+struct DiagnosticRenderer final
+{
+private:
+  // Data
+  bool d_color;
+
+public:
+  // Constructors
+  explicit DiagnosticRenderer(bool color = false)
+    : d_color(color)
+  {}
+
+  // Methods
+  // Appends to out, every part ends with a newline
+  void render(Error const& error, fmt::memory_buffer& out) const;
+  std::string render(Error const& error) const;
+
+private:
+  void renderPart(Error::Part const& part, fmt::memory_buffer& out) const;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <parsing/Position.h>
+#include <parsing/SourceManager.h>
 
 #include <fmt/format.h>
 
@@ -19,22 +20,23 @@ public:
   struct Part
   {
   private:
-    std::string d_filepath;
+    FileId d_file;
     Position d_start;
     Position d_end;
     Tag d_tag;
     std::string d_message;
 
   public:
-    Part(std::string const& filepath, Position start, Position end, Tag tag, std::string const& message) noexcept
-      : d_filepath(filepath)
+    Part(FileId file, Position start, Position end, Tag tag, std::string const& message) noexcept
+      : d_file(file)
       , d_start(start)
       , d_end(end)
       , d_tag(tag)
       , d_message(message)
     {}
 
-    std::string const& filePath() const noexcept { return d_filepath; }
+    FileId file() const noexcept { return d_file; }
+    std::string const& filePath() const noexcept { return SourceManager::path(d_file); }
     Position start() const noexcept { return d_start; }
     Position end() const noexcept { return d_end; }
     Tag tag() const noexcept { return d_tag; }
@@ -45,29 +47,51 @@ private:
   std::vector<Part> d_parts;
 
 public:
-  Error(std::string const& filepath, Position start, Position end, std::string const& message)
+  Error(FileId file, Position start, Position end, std::string const& message)
   {
-    d_parts.emplace_back(filepath, start, end, Tag::Error, message);
+    d_parts.emplace_back(file, start, end, Tag::Error, message);
   }
 
+  Error(FileId file, Position position, std::string const& message)
+    : Error(file, position, position.nextColumn(), message)
+  {}
+
+  Error(FileId file, std::string const& message)
+    : Error(file, Position::invalid(), Position::invalid(), message)
+  {}
+
+  // register filepath with the SourceManager
+  Error(std::string const& filepath, Position start, Position end, std::string const& message)
+    : Error(SourceManager::id(filepath), start, end, message)
+  {}
+
   Error(std::string const& filepath, Position position, std::string const& message)
-    : Error(filepath, position, position.nextColumn(), message)
+    : Error(SourceManager::id(filepath), position, message)
   {}
 
   Error(std::string const& filepath, std::string const& message)
-    : Error(filepath, Position::invalid(), Position::invalid(), message)
+    : Error(SourceManager::id(filepath), message)
   {}
 
-  Error& note(std::string const& filepath, Position start, Position end, std::string const& message)
+  Error& note(FileId file, Position start, Position end, std::string const& message)
   {
-    d_parts.emplace_back(filepath, start, end, Tag::Note, message);
+    d_parts.emplace_back(file, start, end, Tag::Note, message);
     return *this;
   }
 
+  Error& note(FileId file, Position position, std::string const& message)
+  {
+    return note(file, position, position.nextColumn(), message);
+  }
+
+  Error& note(std::string const& filepath, Position start, Position end, std::string const& message)
+  {
+    return note(SourceManager::id(filepath), start, end, message);
+  }
+
   Error& note(std::string const& filepath, Position position, std::string const& message)
   {
-    d_parts.emplace_back(filepath, position, position.nextColumn(), Tag::Note, message);
-    return *this;
+    return note(SourceManager::id(filepath), position, message);
   }
 
   Error& note(std::string const& filepath, std::string const& message)
@@ -77,14 +101,12 @@ public:
 
   Error& note(Position start, Position end, std::string const& message)
   {
-    d_parts.emplace_back(d_parts.back().filePath(), start, end, Tag::Note, message);
-    return *this;
+    return note(d_parts.back().file(), start, end, message);
   }
 
   Error& note(Position position, std::string const& message)
   {
-    d_parts.emplace_back(d_parts.back().filePath(), position, position.nextColumn(), Tag::Note, message);
-    return *this;
+    return note(d_parts.back().file(), position, message);
   }
 
   Error& note(std::string const& message)
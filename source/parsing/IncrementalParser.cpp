@@ -0,0 +1,226 @@
+#include "parsing/IncrementalParser.h"
+
+#include <Utils.h>
+
+#include <algorithm>
+#include <istream>
+
+using namespace ast;
+
+IncrementalParser::IncrementalParser(std::string source, std::string const& sourcePath)
+  : d_source(std::move(source))
+  , d_lineStarts(lineStarts(d_source))
+  , d_file(SourceManager::id(sourcePath))
+  , d_tokens(tokenize(d_source, d_file))
+  , d_reusedCount(0)
+{
+  parse();
+}
+
+TypeExpression::Ptr IncrementalParser::update(Edit const& edit)
+{
+  assert(edit.offset + edit.length <= d_source.size());
+
+  Position const start = position(edit.offset);
+  Position const oldEnd = position(edit.offset + edit.length);
+  Position newEnd = start;
+  for (char const c : edit.text)
+  {
+    newEnd = (c == '\n') ? Position(newEnd.line + 1, 0) : newEnd.nextColumn();
+  }
+  auto const shift = PositionShift{oldEnd, newEnd};
+
+  // the first token the edit touches can merge with the new text and an
+  // edited comment starts after the token before it
+  size_t const touched = static_cast<size_t>(std::lower_bound(
+    d_tokens.begin(), d_tokens.end(), start,
+    [](Token const& tok, Position pos) { return tok.end() < pos; }) - d_tokens.begin());
+  size_t const relexIdx = (touched > 0) ? touched - 1 : 0;
+  Position const relexStart = (touched > 0) ? d_tokens[relexIdx].start() : Position(0, 0);
+
+  std::string const removed = d_source.substr(edit.offset, edit.length);
+  d_source.replace(edit.offset, edit.length, edit.text);
+
+  // lex until a token after the edit is an old one moved by the edit,
+  // the rest of the source lexes as it did before
+  std::vector<Token> lexed;
+  size_t oldIdx = static_cast<size_t>(std::lower_bound(
+    d_tokens.begin(), d_tokens.end(), oldEnd,
+    [](Token const& tok, Position pos) { return tok.start() < pos; }) - d_tokens.begin());
+  try
+  {
+    auto buffer = ViewBuffer(std::string_view(d_source).substr(d_lineStarts[relexStart.line] + relexStart.column));
+    auto textStream = std::istream(&buffer);
+    auto tokenizer = Tokenizer(textStream, d_file, relexStart);
+
+    while (true)
+    {
+      Token const tok = tokenizer.next();
+      if (tok.tag() == Token::Comment)
+      {
+        continue;
+      }
+      if (tok.start() >= newEnd)
+      {
+        while (oldIdx < d_tokens.size() && shift(d_tokens[oldIdx].start()) < tok.start())
+        {
+          oldIdx += 1;
+        }
+        if (oldIdx < d_tokens.size()
+          && shift(d_tokens[oldIdx].start()) == tok.start()
+          && d_tokens[oldIdx].tag() == tok.tag()
+          && d_tokens[oldIdx].text() == tok.text())
+        {
+          break;
+        }
+      }
+      lexed.push_back(tok);
+      if (tok.tag() == Token::Eof)
+      {
+        oldIdx = d_tokens.size();
+        break;
+      }
+    }
+  }
+  catch (...)
+  {
+    d_source.replace(edit.offset, edit.text.size(), removed);
+    throw;
+  }
+
+  // tokens lexed again can come out unchanged, positions included
+  size_t const oldTokenCount = d_tokens.size();
+  size_t const suffixLength = oldTokenCount - oldIdx;
+  size_t prefixLength = relexIdx;
+  while (prefixLength - relexIdx < std::min(lexed.size(), oldIdx - relexIdx)
+    && d_tokens[prefixLength] == lexed[prefixLength - relexIdx])
+  {
+    prefixLength += 1;
+  }
+
+  // the lexed tokens replace [relexIdx, oldIdx) and the following ones move
+  std::vector<Token> const replaced = splice(relexIdx, oldIdx, lexed, shift);
+
+  try
+  {
+    Parser<TokenRange>::ReuseTable reusable;
+    auto parser = Parser(TokenRange(d_tokens, 0, d_tokens.size(), d_file), *d_pArena);
+    parser.d_pRecorded = &reusable;
+    parser.d_reuse = Parser<TokenRange>::Reuse{
+      &d_reusable, oldTokenCount, d_tokens.size(), prefixLength, suffixLength, shift};
+
+    try
+    {
+      d_pRoot = parser.root();
+    }
+    catch (...)
+    {
+      // reused nodes are shared with the previous tree, which is kept
+      for (auto const& [_, moved] : parser.d_moved)
+      {
+        moved.pNode->shift(shift.inverse());
+      }
+      throw;
+    }
+
+    d_reusable = std::move(reusable);
+    d_reusedCount = parser.d_reused.size();
+  }
+  catch (...)
+  {
+    splice(relexIdx, relexIdx + lexed.size(), replaced, shift.inverse());
+    d_source.replace(edit.offset, edit.text.size(), removed);
+    throw;
+  }
+
+  // lines starting in the replaced text are replaced by those of the new
+  // text, the following ones move by the change in length
+  auto const firstRemoved = std::upper_bound(d_lineStarts.begin(), d_lineStarts.end(), edit.offset);
+  auto const firstKept = std::upper_bound(firstRemoved, d_lineStarts.end(), edit.offset + edit.length);
+  for (auto it = firstKept; it != d_lineStarts.end(); ++it)
+  {
+    *it = *it - edit.length + edit.text.size();
+  }
+  std::vector<size_t> added;
+  for (size_t i = 0; i < edit.text.size(); ++i)
+  {
+    if (edit.text[i] == '\n')
+    {
+      added.push_back(edit.offset + i + 1);
+    }
+  }
+  auto const it = d_lineStarts.erase(firstRemoved, firstKept);
+  d_lineStarts.insert(it, added.begin(), added.end());
+
+  if (d_pArena->bytesUsed() > MaxArenaGrowth * d_parsedBytes)
+  {
+    parse();
+  }
+  return d_pRoot;
+}
+
+void IncrementalParser::parse()
+{
+  auto pArena = std::make_unique<Arena>();
+  Parser<TokenRange>::ReuseTable reusable;
+  auto parser = Parser(TokenRange(d_tokens, 0, d_tokens.size(), d_file), *pArena);
+  parser.d_pRecorded = &reusable;
+  d_pRoot = parser.root();
+
+  d_reusable = std::move(reusable);
+  d_pArena = std::move(pArena);
+  d_parsedBytes = d_pArena->bytesUsed();
+}
+
+std::vector<Token> IncrementalParser::splice(size_t begin, size_t end, std::vector<Token> const& tokens, PositionShift const& shift)
+{
+  for (auto it = d_tokens.begin() + static_cast<std::ptrdiff_t>(end); it != d_tokens.end(); ++it)
+  {
+    *it = Token(it->tag(), shift(it->start()), shift(it->end()), it->text());
+  }
+
+  auto const first = d_tokens.begin() + static_cast<std::ptrdiff_t>(begin);
+  auto const last = d_tokens.begin() + static_cast<std::ptrdiff_t>(end);
+  std::vector<Token> res(first, last);
+  d_tokens.insert(d_tokens.erase(first, last), tokens.begin(), tokens.end());
+  return res;
+}
+
+Position IncrementalParser::position(size_t offset) const
+{
+  auto const it = std::upper_bound(d_lineStarts.begin(), d_lineStarts.end(), offset) - 1;
+  return Position(static_cast<size_t>(it - d_lineStarts.begin()), offset - *it);
+}
+
+std::vector<Token> IncrementalParser::tokenize(std::string_view source, FileId file)
+{
+  auto buffer = ViewBuffer(source);
+  auto textStream = std::istream(&buffer);
+  auto tokenizer = Tokenizer(textStream, file);
+
+  std::vector<Token> res;
+  do
+  {
+    Token const tok = tokenizer.next();
+    if (tok.tag() != Token::Comment)
+    {
+      res.push_back(tok);
+    }
+  }
+  while (res.empty() || res.back().tag() != Token::Eof);
+
+  return res;
+}
+
+std::vector<size_t> IncrementalParser::lineStarts(std::string_view source)
+{
+  std::vector<size_t> res = {0};
+  for (size_t i = 0; i < source.size(); ++i)
+  {
+    if (source[i] == '\n')
+    {
+      res.push_back(i + 1);
+    }
+  }
+  return res;
+}
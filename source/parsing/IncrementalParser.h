@@ -0,0 +1,82 @@
+#pragma once
+
+#include <parsing/Parser.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Keeps the source, tokens and syntax tree of a file so that the tree can
+// be updated after an edit by reparsing only what the edit touched. Only
+// the tokens from the one before the edit up to the first unchanged token
+// after it are lexed again, the following ones are shifted by the edit.
+// Let statements, blocks and function definitions whose tokens are
+// unchanged are reused from the previous tree and only the spine enclosing
+// the edit is rebuilt. Reused nodes the edit moved get their positions
+// shifted in place, so the memory an update takes does not depend on where
+// the edit is.
+//
+// Reused nodes are shared between versions of the tree and do not know their
+// parent, build an ast::ParentTable from the root of a version to walk up.
+// Only the latest version has the positions of the source, shifting a node
+// shifts it in every version sharing it. Every version of the tree is
+// allocated from the same arena and previous trees stay valid until it
+// takes more than MaxArenaGrowth times what a full parse took. The tree is
+// then parsed again into a new arena and the memory of the previous trees
+// is released.
+struct IncrementalParser final
+{
+public:
+  // Types
+  struct Edit
+  {
+    size_t offset;
+    size_t length;
+    std::string text;
+  };
+
+  static constexpr size_t MaxArenaGrowth = 4;
+
+private:
+  // Data
+  std::unique_ptr<ast::Arena> d_pArena;
+  size_t d_parsedBytes; // taken by the last full parse
+  std::string d_source;
+  std::vector<size_t> d_lineStarts;
+  FileId d_file;
+  std::vector<Token> d_tokens;
+  Parser<TokenRange>::ReuseTable d_reusable;
+  ast::TypeExpression::Ptr d_pRoot;
+  size_t d_reusedCount;
+
+public:
+  // Constructors
+  IncrementalParser(std::string source, std::string const& sourcePath);
+
+  // Methods
+  ast::TypeExpression::Ptr root() const { return d_pRoot; }
+  std::string const& source() const { return d_source; }
+
+  // Number of subtrees taken from the previous tree by the last update
+  size_t reusedCount() const { return d_reusedCount; }
+  // Bytes taken by the trees kept alive
+  size_t bytesUsed() const { return d_pArena->bytesUsed(); }
+
+  // Replaces edit.length bytes at edit.offset with edit.text and reparses,
+  // if the new source has errors the parser is left unchanged
+  ast::TypeExpression::Ptr update(Edit const& edit);
+
+private:
+  // Parses the tokens into a new arena, previous trees are released
+  void parse();
+
+  // Replaces the tokens [begin, end) with tokens and shifts the following
+  // ones, returns the replaced tokens
+  std::vector<Token> splice(size_t begin, size_t end, std::vector<Token> const& tokens, PositionShift const& shift);
+
+  Position position(size_t offset) const;
+
+  static std::vector<Token> tokenize(std::string_view source, FileId file);
+  static std::vector<size_t> lineStarts(std::string_view source);
+};
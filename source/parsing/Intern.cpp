@@ -6,31 +6,61 @@ Intern& Intern::instance()
   return inst;
 }
 
+std::string_view Intern::added(std::set<std::string>::iterator it, bool inserted)
+{
+  if (inserted)
+  {
+    d_bytes += it->length();
+  }
+  return std::string_view(it->c_str(), it->length());
+}
+
 std::string_view Intern::string(char const* cString)
 {
   std::string string(cString);
-  auto const [it, _] = instance().d_strings.insert(std::move(string));
-  return std::string_view(it->c_str(), it->length());
+  auto& inst = instance();
+  std::scoped_lock lock(inst.d_mutex);
+  auto const [it, inserted] = inst.d_strings.insert(std::move(string));
+  return inst.added(it, inserted);
 }
 
 std::string_view Intern::string(char const* ptr, size_t length)
 {
   std::string string(ptr, length);
-  auto const [it, _] = instance().d_strings.insert(std::move(string));
-  return std::string_view(it->c_str(), it->length());
+  auto& inst = instance();
+  std::scoped_lock lock(inst.d_mutex);
+  auto const [it, inserted] = inst.d_strings.insert(std::move(string));
+  return inst.added(it, inserted);
 }
 
 std::string_view Intern::string(std::string const& string)
 {
-  auto const [it, _] = instance().d_strings.insert(string);
-  return std::string_view(it->c_str(), it->length());
-
+  auto& inst = instance();
+  std::scoped_lock lock(inst.d_mutex);
+  auto const [it, inserted] = inst.d_strings.insert(string);
+  return inst.added(it, inserted);
 }
 
 std::string_view Intern::string(std::string&& string)
 {
-  auto const [it, _] = instance().d_strings.insert(std::move(string));
-  return std::string_view(it->c_str(), it->length());
+  auto& inst = instance();
+  std::scoped_lock lock(inst.d_mutex);
+  auto const [it, inserted] = inst.d_strings.insert(std::move(string));
+  return inst.added(it, inserted);
+}
+
+size_t Intern::count()
+{
+  auto& inst = instance();
+  std::scoped_lock lock(inst.d_mutex);
+  return inst.d_strings.size();
+}
+
+size_t Intern::bytes()
+{
+  auto& inst = instance();
+  std::scoped_lock lock(inst.d_mutex);
+  return inst.d_bytes;
 }
 
 // auto& inst = instance();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <set>
 #include <string>
 #include <string_view>
@@ -8,9 +9,14 @@ struct Intern final
 {
 private:
   std::set<std::string> d_strings;
+  size_t d_bytes = 0; // sum of the lengths of d_strings
+  std::mutex d_mutex; // the parallel parser interns from several threads
 
   static Intern& instance();
 
+  // counts the string if it was inserted, the lock must be held
+  std::string_view added(std::set<std::string>::iterator it, bool inserted);
+
 public:
 
   template<size_t N>
@@ -27,4 +33,9 @@ public:
   static std::string_view string(std::string const& string);
 
   static std::string_view string(std::string&& string);
+
+  // Number of interned strings and the sum of their lengths, to see how
+  // much the interner grows
+  static size_t count();
+  static size_t bytes();
 };
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "parsing/LexerThread.h"
+
+#include <parsing/Error.h>
+#include <parsing/Tokenizer.h>
+
+LexerThread::LexerThread(std::istream& input, std::string const& sourcePath, Position start)
+  : d_file(SourceManager::id(sourcePath))
+  , d_pShared(std::make_unique<Shared>())
+  , d_batchIdx(0)
+  , d_batchSize(0)
+{
+  d_thread = std::thread(lex, std::ref(*d_pShared), std::ref(input), d_file, start);
+}
+
+LexerThread::~LexerThread()
+{
+  if (d_thread.joinable())
+  {
+    // the parser can stop before Eof, unblock the producer
+    d_pShared->stop = true;
+    d_thread.join();
+  }
+}
+
+Token LexerThread::next()
+{
+  while (d_batchIdx == d_batchSize)
+  {
+    d_batchIdx = 0;
+    d_batchSize = d_pShared->ring.tryPop(d_batch.data(), d_batch.size());
+    if (d_batchSize == 0)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  Token const res = d_batch[d_batchIdx];
+  if (res.tag() == Token::Eof)
+  {
+    // Eof is the last token pushed, keep returning it
+    if (d_pShared->pException != nullptr)
+    {
+      std::rethrow_exception(d_pShared->pException);
+    }
+    return res;
+  }
+  d_batchIdx += 1;
+  return res;
+}
+
+void LexerThread::lex(Shared& shared, std::istream& input, FileId file, Position start)
+{
+  std::array<Token, batchSize> batch;
+  size_t count = 0;
+
+  auto const flush = [&]()
+  {
+    size_t pushed = 0;
+    while (pushed < count && !shared.stop)
+    {
+      pushed += shared.ring.tryPush(batch.data() + pushed, count - pushed);
+      if (pushed < count)
+      {
+        std::this_thread::yield();
+      }
+    }
+    count = 0;
+  };
+
+  auto tokenizer = Tokenizer(input, file, start);
+  Token token;
+  do
+  {
+    try
+    {
+      token = tokenizer.next();
+    }
+    catch (Error const&)
+    {
+      shared.pException = std::current_exception();
+      token = Token(Token::Eof, Position::invalid(), Position::invalid(), "");
+    }
+
+    if (token.tag() != Token::Comment)
+    {
+      batch[count++] = token;
+    }
+    if (count == batch.size() || token.tag() == Token::Eof)
+    {
+      flush();
+    }
+  }
+  while (token.tag() != Token::Eof && !shared.stop);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <parsing/Position.h>
+#include <parsing/SourceManager.h>
+#include <parsing/Token.h>
+#include <SpscRing.h>
+
+#include <array>
+#include <atomic>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Token source running a Tokenizer on its own thread so that lexing
+// overlaps with parsing. Tokens, comments excluded, are handed over in
+// batches through a lock-free ring. Tokenizer errors are rethrown by
+// next() when the parser reaches the point where they occurred.
+struct LexerThread final
+{
+public:
+  // Types
+  static constexpr size_t batchSize = 256;
+  static constexpr size_t ringCapacity = 8 * batchSize;
+
+private:
+  struct Shared
+  {
+    SpscRing<Token, ringCapacity> ring;
+    std::atomic<bool> stop = false;
+    std::exception_ptr pException = nullptr; // set before the final Eof is pushed
+  };
+
+  // Data
+  FileId d_file;
+  std::unique_ptr<Shared> d_pShared;
+  std::thread d_thread;
+  std::array<Token, batchSize> d_batch;
+  size_t d_batchIdx;
+  size_t d_batchSize;
+
+public:
+  // Constructors
+  // input must outlive the source
+  LexerThread(
+    std::istream& input,
+    std::string const& sourcePath,
+    Position start = Position(0, 0));
+  LexerThread(LexerThread&& other) noexcept = default;
+  LexerThread(LexerThread const&) = delete;
+  ~LexerThread();
+
+  // Methods
+  Token next();
+  FileId fileId() const { return d_file; }
+
+  // Operators
+  LexerThread& operator=(LexerThread const&) = delete;
+  LexerThread& operator=(LexerThread&&) = delete;
+
+private:
+  static void lex(Shared& shared, std::istream& input, FileId file, Position start);
+};
@@ -6,6 +6,7 @@
 #include <fmt/color.h>
 #include <fort.hpp>
 
+#include <algorithm>
 #include <map>
 #include <limits>
 #include <cassert>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <parsing/Token.h>
+#include <parsing/TokenSource.h>
 #include <fmt/format.h>
 
 // TODO
@@ -8,6 +9,7 @@
 //   make constexpr
 struct Operator final
 {
+  template<TokenSource>
   friend struct Parser;
 
 public:
@@ -0,0 +1,140 @@
+#include "parsing/ParallelParser.h"
+
+#include <parsing/DeclarationScanner.h>
+#include <parsing/Parser.h>
+#include <Utils.h>
+
+#include <optional>
+#include <sstream>
+
+using namespace ast;
+
+namespace
+{
+
+// ranges of boundaries parsed by a single worker, bigger batches mean less
+// per parser overhead, more batches mean better load balancing
+constexpr size_t batchesPerJob = 8;
+
+template<typename T>
+void append(std::vector<T>& dest, std::span<T const> src)
+{
+  dest.insert(dest.end(), src.begin(), src.end());
+}
+
+} // anonymous namespace
+
+TypeExpression::Ptr ParallelParser::root(
+  std::string_view source,
+  std::string const& sourcePath,
+  size_t jobs,
+  Arena& arena)
+{
+  return root(source, SourceManager::id(sourcePath), jobs, arena);
+}
+
+TypeExpression::Ptr ParallelParser::root(
+  std::string_view source,
+  FileId file,
+  size_t jobs,
+  Arena& arena)
+{
+  if (jobs <= 1)
+  {
+    return parse(source, file, Position(0, 0), arena);
+  }
+
+  auto const boundaries = topLevelBoundaries(source);
+
+  std::vector<Boundary> batches;
+  size_t const batchSize = source.size() / (jobs * batchesPerJob) + 1;
+  for (auto const& boundary : boundaries)
+  {
+    if (batches.empty() || boundary.offset - batches.back().offset >= batchSize)
+    {
+      batches.push_back(boundary);
+    }
+  }
+
+  if (batches.size() <= 1)
+  {
+    return parse(source, file, Position(0, 0), arena);
+  }
+
+  std::vector<std::optional<TypeExpression::Ptr>> results(batches.size());
+  parallelFor(batches.size(), jobs, [&](size_t i)
+  {
+    size_t const
+      begin = batches[i].offset,
+      end = (i + 1 < batches.size()) ? batches[i + 1].offset : source.size();
+
+    try
+    {
+      results[i] = parse(source.substr(begin, end - begin), file, batches[i].position, arena.fork());
+    }
+    catch (Error const&)
+    {
+      // reported by the sequential fallback below
+    }
+  });
+
+  // merge the batches in source order enforcing the rules that
+  // Parser::typeExpression() checks across declarations
+  std::vector<Part::Ptr> fields;
+  std::vector<LetStatement::Ptr> declsPre, declsPost;
+  bool ok = true;
+
+  for (auto const& result : results)
+  {
+    if (!result.has_value())
+    {
+      ok = false;
+      break;
+    }
+
+    auto const& pBatch = *result;
+    if (pBatch->fields().empty())
+    {
+      append(fields.empty() ? declsPre : declsPost, pBatch->declsPre());
+      continue;
+    }
+
+    if (!fields.empty() && (!declsPost.empty() || !pBatch->declsPre().empty()))
+    {
+      // fields must be grouped together
+      ok = false;
+      break;
+    }
+    append(declsPre, pBatch->declsPre());
+    append(fields, pBatch->fields());
+    append(declsPost, pBatch->declsPost());
+  }
+
+  if (!ok)
+  {
+    return parse(source, file, Position(0, 0), arena);
+  }
+
+  Position const end = results.back().value()->end();
+  return TypeExpression::make(
+    arena, TypeExpression::Struct, Position(0, 0), end, fields, declsPre, declsPost);
+}
+
+std::vector<ParallelParser::Boundary> ParallelParser::topLevelBoundaries(std::string_view source)
+{
+  DeclarationScanner scanner;
+  scanner.push(source);
+  scanner.finish();
+  return scanner.boundaries();
+}
+
+TypeExpression::Ptr ParallelParser::parse(
+  std::string_view source,
+  FileId file,
+  Position start,
+  Arena& arena)
+{
+  auto textStream = std::istringstream(std::string(source), std::ios::in);
+  auto parser = Parser(Tokenizer(textStream, file, start), arena);
+  return parser.root();
+}
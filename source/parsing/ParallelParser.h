@@ -0,0 +1,47 @@
+#pragma once
+
+#include <parsing/DeclarationScanner.h>
+#include <parsing/Position.h>
+#include <parsing/SourceManager.h>
+#include <parsing/ast/TypeExpression.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Parses the implicit root type expression of a source file by splitting
+// it at its top-level declarations and parsing groups of them on a
+// worker pool. The result is identical to Parser::root(), errors included:
+// if any group fails to parse, the whole source is reparsed sequentially
+// so that the reported error is the one the sequential parser would give.
+// Each worker allocates its nodes from a fork of the given arena.
+struct ParallelParser final
+{
+public:
+  // Types
+  using Boundary = DeclarationScanner::Boundary;
+
+public:
+  // Methods
+  static ast::TypeExpression::Ptr root(
+    std::string_view source,
+    FileId file,
+    size_t jobs,
+    ast::Arena& arena);
+
+  static ast::TypeExpression::Ptr root(
+    std::string_view source,
+    std::string const& sourcePath,
+    size_t jobs,
+    ast::Arena& arena);
+
+  // see DeclarationScanner::boundaries()
+  static std::vector<Boundary> topLevelBoundaries(std::string_view source);
+
+private:
+  static ast::TypeExpression::Ptr parse(
+    std::string_view source,
+    FileId file,
+    Position start,
+    ast::Arena& arena);
+};
@@ -1,5 +1,8 @@
 #include "parsing/Parser.h"
 
+#include <parsing/LexerThread.h>
+#include <parsing/TokenCache.h>
+
 // TODO better error messages
 
 using namespace ast;
@@ -11,63 +14,88 @@ static constexpr Operator::Tag Bar = Operator::BitOr;
 
 }
 
-TypeExpression::SPtr Parser::root()
+template<TokenSource Source>
+Parser<Source>::Parser(Source source, Arena& arena)
+  : Parser(std::move(source), arena, State::Base)
+{}
+
+template<TokenSource Source>
+Parser<Source>::Parser(Source source, Arena& arena, State state)
+  : d_source(std::move(source))
+  , d_pArena(&arena)
+  , d_file(d_source.fileId())
+  , d_currentTokenIdx(0)
+  , d_lazyFunctionBodies(false)
+  , d_pLazyTokens(nullptr)
+  , d_pRecorded(nullptr)
+{
+  d_stateStack.push(State::Base);
+  if (state != State::Base)
+  {
+    d_stateStack.push(state);
+  }
+}
+
+template<TokenSource Source>
+TypeExpression::Ptr Parser<Source>::root()
 {
   auto pRoot = typeExpression(true);
   match(Token::Eof, ErrorStrategy::DefaultErrorMessage);
   return pRoot;
 }
 
-TokenExpression::SPtr Parser::tokenExpression()
+template<TokenSource Source>
+TokenExpression::Ptr Parser<Source>::tokenExpression()
 {
   if (next(Token::Symbol))
   {
     Token const tokSymbol = match(Token::Symbol);
     if (tokSymbol.text() == "true")
     {
-      return std::make_shared<BoolExpression>(tokSymbol, true);
+      return d_pArena->make<BoolExpression>(tokSymbol, true);
     }
     else if (tokSymbol.text() == "false")
     {
-      return std::make_shared<BoolExpression>(tokSymbol, false);
+      return d_pArena->make<BoolExpression>(tokSymbol, false);
     }
     else if (tokSymbol.text() == "null")
     {
-      return std::make_shared<NullExpression>(tokSymbol);
+      return d_pArena->make<NullExpression>(tokSymbol);
     }
     else if (tokSymbol.text() == "undefined")
     {
-      return std::make_shared<UndefinedExpression>(tokSymbol);
+      return d_pArena->make<UndefinedExpression>(tokSymbol);
     }
     else if (tokSymbol.text() == "unreachable")
     {
-      return std::make_shared<UnreachableExpression>(tokSymbol);
+      return d_pArena->make<UnreachableExpression>(tokSymbol);
     }
     else if (tokSymbol.text()[0] == '@')
     {
-      return std::make_shared<BuiltinExpression>(tokSymbol);
+      return d_pArena->make<BuiltinExpression>(tokSymbol);
     }
     else
     {
-      return std::make_shared<SymbolExpression>(tokSymbol);
+      return d_pArena->make<SymbolExpression>(tokSymbol);
     }
   }
   if (next(Token::StringLiteral))
   {
-    return std::make_shared<StringExpression>(match(Token::StringLiteral));
+    return d_pArena->make<StringExpression>(match(Token::StringLiteral));
   }
   if (next(Token::NumberLiteral))
   {
-    return std::make_shared<NumberExpression>(match(Token::NumberLiteral));
+    return d_pArena->make<NumberExpression>(match(Token::NumberLiteral));
   }
   return nullptr;
 }
 
-TypeExpression::SPtr Parser::typeExpression(bool isRoot)
+template<TokenSource Source>
+TypeExpression::Ptr Parser<Source>::typeExpression(bool isRoot)
 {
   Token tokTag { Token::KwStruct, Position(0, 0), Position(0, 0), "" };
   TypeExpression::Tag tag = TypeExpression::Struct;
-  Node::SPtr pUnderlyingType = nullptr;
+  Node::Ptr pUnderlyingType = nullptr;
 
   if (!isRoot)
   {
@@ -102,12 +130,12 @@ TypeExpression::SPtr Parser::typeExpression(bool isRoot)
     match(Token::LBrace, "block expected", fallback);
   }
 
-  std::vector<Part::SPtr> fields;
-  std::vector<LetStatement::SPtr>
+  std::vector<Part::Ptr> fields;
+  std::vector<LetStatement::Ptr>
     declsPre, declsPost, *decls = &declsPre;
 
   size_t commaCount = 0;
-  while (auto pExpr = expressionOrPart())
+  while (Node::Ptr pExpr = expressionOrPart())
   {
     if (pExpr->is<LetStatement>())
     {
@@ -169,23 +197,30 @@ TypeExpression::SPtr Parser::typeExpression(bool isRoot)
     ? match(Token::RBrace, ErrorStrategy::DefaultErrorMessage).end()
     : lastMatchedToken().end();
 
-  return TypeExpression::make_shared(
-    tag, tokTag.start(), end, std::move(fields), std::move(declsPre), std::move(declsPost), pUnderlyingType);
+  return TypeExpression::make(*d_pArena,
+    tag, tokTag.start(), end, fields, declsPre, declsPost, pUnderlyingType);
 }
 
-FunctionExpression::SPtr Parser::functionExpression()
+template<TokenSource Source>
+FunctionExpression::Ptr Parser<Source>::functionExpression()
 {
   if (!next(Token::KwFn))
   {
     return nullptr;
   }
+  size_t const firstTokenIdx = d_currentTokenIdx;
+  State const firstState = currentState();
+  if (auto pRes = reuse<FunctionExpression>(); pRes != nullptr)
+  {
+    return pRes;
+  }
   Token const tokFn = match(Token::KwFn);
 
   match(Token::LParen, ErrorStrategy::DefaultErrorMessage);
 
   size_t commaCount = 0;
-  std::vector<Part::SPtr> parameters;
-  while(auto pExpr = expressionOrPart())
+  std::vector<Part::Ptr> parameters;
+  while(Node::Ptr pExpr = expressionOrPart())
   {
     // TODO check for default values, i.e. all params with default values
     //   must be grouped at the end
@@ -211,6 +246,25 @@ FunctionExpression::SPtr Parser::functionExpression()
   auto const state = popState();
   assert(state == State::FunctionReturnType);
 
+  if (d_lazyFunctionBodies && next(Token::LBrace))
+  {
+    Position bodyEnd;
+    auto const lazyBody = skipFunctionBody(&bodyEnd);
+
+    for (auto const& param : parameters)
+    {
+      if (!param->hasType())
+      {
+        throw error(param, "function parameters must have type annotations");
+      }
+    }
+
+    auto pRes = FunctionExpression::make(*d_pArena,
+      tokFn, parameters, pReturnType, bodyEnd, lazyBody);
+    record(pRes, firstTokenIdx, firstState);
+    return pRes;
+  }
+
   auto const pBody = expression<BlockExpression>(Optional, "block expected");
   if (pBody != nullptr && pBody->isLabeled())
   {
@@ -240,14 +294,33 @@ FunctionExpression::SPtr Parser::functionExpression()
     }
   }
 
-  return FunctionExpression::make_shared(tokFn, std::move(parameters), pReturnType, pBody);
+  auto pRes = FunctionExpression::make(*d_pArena, tokFn, parameters, pReturnType, pBody);
+  if (pBody != nullptr)
+  {
+    // function types can depend on more than the token following them
+    record(pRes, firstTokenIdx, firstState);
+  }
+  return pRes;
 }
 
-LetStatement::SPtr Parser::letStatement()
+template<TokenSource Source>
+LetStatement::Ptr Parser<Source>::letStatement()
 {
   // TODO parse comptime here
   //  "pub comptime let" not "comptime pub let"
 
+  if (!next(Token::KwPub) && !next(Token::KwLet))
+  {
+    return nullptr;
+  }
+
+  size_t const firstTokenIdx = d_currentTokenIdx;
+  State const firstState = currentState();
+  if (auto pRes = reuse<LetStatement>(); pRes != nullptr)
+  {
+    return pRes;
+  }
+
   auto start = Position::invalid();
   bool
     isPub = false,
@@ -282,8 +355,8 @@ LetStatement::SPtr Parser::letStatement()
   }
 
   size_t commaCount = 0;
-  std::vector<Part::SPtr> parts;
-  while (auto pExpr = expressionOrPart())
+  std::vector<Part::Ptr> parts;
+  while (Node::Ptr pExpr = expressionOrPart())
   {
     if (!pExpr->is<Part>())
     {
@@ -308,7 +381,7 @@ LetStatement::SPtr Parser::letStatement()
         throw error(pPart, "constants must be initialized");
       }
     }
-    if (!isMut && std::dynamic_pointer_cast<UndefinedExpression>(pPart->value()) != nullptr)
+    if (!isMut && pPart->value()->is<UndefinedExpression>())
     {
       // TODO add note
       throw error(pPart, "constants must be initialized with a proper value");
@@ -328,16 +401,19 @@ LetStatement::SPtr Parser::letStatement()
     throw error(tokLet, "let statement cannot be empty");
   }
 
-  return LetStatement::make_shared(start, isPub, isMut, std::move(parts));
+  auto pRes = LetStatement::make(*d_pArena, start, isPub, isMut, parts);
+  record(pRes, firstTokenIdx, firstState);
+  return pRes;
 }
 
-Part::SPtr Parser::part()
+template<TokenSource Source>
+Part::Ptr Parser<Source>::part()
 {
   // TODO implement workaround when a = b expression will be implemented and this code will break
 
   auto const [tokComptime, isComptime] = comptime();
 
-  Node::SPtr pAsign = nullptr;
+  Node::Ptr pAsign = nullptr;
 
   setRollbackPoint();
   auto const [tokLabel, isLabeled] = label();
@@ -365,21 +441,21 @@ Part::SPtr Parser::part()
     return nullptr;
   }
 
-  Node::SPtr pType = nullptr;
+  Node::Ptr pType = nullptr;
   if (next(Token::Colon))
   {
     Token const tokColon = match(Token::Colon);
     pType = expression("type expression expected", tokColon.end());
   }
 
-  Node::SPtr pValue = nullptr;
+  Node::Ptr pValue = nullptr;
   if (next(Token::Operator))
   {
     Token const tokEq = match(Operator::Eq, ErrorStrategy::DefaultErrorMessage);
     pValue = expression("expression expected", tokEq.end());
   }
 
-  auto pRes = Part::make_shared(pAsign, pType, pValue);
+  auto pRes = Part::make(*d_pArena, pAsign, pType, pValue);
   if (isComptime)
   {
     pRes->setIsComptime(tokComptime);
@@ -387,16 +463,24 @@ Part::SPtr Parser::part()
   return pRes;
 }
 
-BlockExpression::SPtr Parser::blockExpression()
+template<TokenSource Source>
+BlockExpression::Ptr Parser<Source>::blockExpression()
 {
   if (!next(Token::LBrace))
   {
     return nullptr;
   }
+
+  size_t const firstTokenIdx = d_currentTokenIdx;
+  State const firstState = currentState();
+  if (auto pRes = reuse<BlockExpression>(); pRes != nullptr)
+  {
+    return pRes;
+  }
   Token const tokLBrace = match(Token::LBrace);
 
-  std::vector<Node::SPtr> statements;
-  while (auto pStmt = expression())
+  std::vector<Node::Ptr> statements;
+  while (Node::Ptr pStmt = expression())
   {
     // errors on unassigned function results is done in sema
 
@@ -417,11 +501,14 @@ BlockExpression::SPtr Parser::blockExpression()
   }
   Token const tokRBrace = match(Token::RBrace, ErrorStrategy::DefaultErrorMessage);
 
-  return BlockExpression::make_shared(
-    tokLBrace.start(), tokRBrace.end(), std::move(statements));
+  auto pRes = BlockExpression::make(*d_pArena,
+    tokLBrace.start(), tokRBrace.end(), statements);
+  record(pRes, firstTokenIdx, firstState);
+  return pRes;
 }
 
-IfExpression::SPtr Parser::ifExpression()
+template<TokenSource Source>
+IfExpression::Ptr Parser<Source>::ifExpression()
 {
   if (!next(Token::KwIf) && !next(Token::KwElse))
   {
@@ -463,7 +550,7 @@ IfExpression::SPtr Parser::ifExpression()
       }
     }
 
-    Node::SPtr pClauseCondition = nullptr;
+    Node::Ptr pClauseCondition = nullptr;
     if (tag != IfExpression::Clause::Else)
     {
       // TODO the error should be "expression expected"
@@ -520,10 +607,11 @@ IfExpression::SPtr Parser::ifExpression()
     assert(state == State::IfExpression);
   }
 
-  return IfExpression::make_shared(std::move(clauses));
+  return IfExpression::make(*d_pArena, clauses);
 }
 
-LoopExpression::SPtr Parser::loopExpression()
+template<TokenSource Source>
+LoopExpression::Ptr Parser<Source>::loopExpression()
 {
   if (!next(Token::KwLoop))
   {
@@ -551,9 +639,9 @@ LoopExpression::SPtr Parser::loopExpression()
   auto const state = popState();
   assert(state == State::IfExpression);
 
-  Token tokElse;
-  Node::SPtr pElseCapture = nullptr;
-  BlockExpression::SPtr pElseBody = nullptr;
+  Token tokElse = Token(); // stored in the node even without an else
+  Node::Ptr pElseCapture = nullptr;
+  BlockExpression::Ptr pElseBody = nullptr;
 
   if (next(Token::KwElse))
   {
@@ -574,11 +662,12 @@ LoopExpression::SPtr Parser::loopExpression()
     }
   }
 
-  return LoopExpression::make_shared(
+  return LoopExpression::make(*d_pArena,
     tokLoop, pCondition, pCapture, pBody, tokElse, pElseCapture, pElseBody);
 }
 
-SwitchExpression::SPtr Parser::switchExpression()
+template<TokenSource Source>
+SwitchExpression::Ptr Parser<Source>::switchExpression()
 {
   if (!next(Token::KwSwitch))
   {
@@ -631,16 +720,17 @@ SwitchExpression::SPtr Parser::switchExpression()
 
   Token const tokRBrace = match(Token::RBrace, ErrorStrategy::DefaultErrorMessage, cases.back().result->end().nextColumn());
 
-  return SwitchExpression::make_shared(tokSwitch, pValue, std::move(cases), tokRBrace.end());
+  return SwitchExpression::make(*d_pArena, tokSwitch, pValue, cases, tokRBrace.end());
 }
 
-Node::SPtr Parser::expression()
+template<TokenSource Source>
+Node::Ptr Parser<Source>::expression()
 {
   auto const [tokComptime, isComptime] = comptime();
 
   auto const [tokLabel, isLabeled] = label();
 
-  auto pRes = pred15();
+  Node::Ptr pRes = pred15();
 
   if (isComptime)
   {
@@ -679,7 +769,8 @@ Node::SPtr Parser::expression()
   return pRes;
 }
 
-Node::SPtr Parser::pred15()
+template<TokenSource Source>
+Node::Ptr Parser<Source>::pred15()
 {
   if (next(Operator::Return))
   {
@@ -695,7 +786,7 @@ Node::SPtr Parser::pred15()
 
     auto const pTarget = atomic();
 
-    return ReturnStatement::make_shared(tokBreak, pTarget);
+    return ReturnStatement::make(*d_pArena, tokBreak, pTarget);
   }
   if (next(Operator::Break))
   {
@@ -703,14 +794,14 @@ Node::SPtr Parser::pred15()
     auto const [tokLabel, isLabeled] = jumpLabel();
     auto const pTarget = atomic();
 
-    return BreakStatement::make_shared(tokBreak, isLabeled, tokLabel, pTarget);
+    return BreakStatement::make(*d_pArena, tokBreak, isLabeled, tokLabel, pTarget);
   }
   if (next(Operator::Continue))
   {
     Token const tokContinue = match(Operator::Continue);
     auto const [tokLabel, isLabeled] = jumpLabel();
 
-    return std::make_shared<ContinueStatement>(tokContinue, isLabeled, tokLabel);
+    return d_pArena->make<ContinueStatement>(tokContinue, isLabeled, tokLabel);
   }
   if (next(Operator::Defer))
   {
@@ -727,12 +818,13 @@ Node::SPtr Parser::pred15()
     {
       throw error(tokDefer.end().nextColumn(), "expression expected");
     }
-    return DeferStatement::make_shared(tokDefer, pTarget);
+    return DeferStatement::make(*d_pArena, tokDefer, pTarget);
   }
   return atomic();
 }
 
-Node::SPtr Parser::atomic()
+template<TokenSource Source>
+Node::Ptr Parser<Source>::atomic()
 {
   if (auto pRes = typeExpression(); pRes != nullptr)
   {
@@ -765,7 +857,8 @@ Node::SPtr Parser::atomic()
   return tokenExpression();
 }
 
-Node::SPtr Parser::expressionOrPart()
+template<TokenSource Source>
+Node::Ptr Parser<Source>::expressionOrPart()
 {
   /*
     this fixes: a: b = c,
@@ -783,7 +876,8 @@ Node::SPtr Parser::expressionOrPart()
   return expression();
 }
 
-std::tuple<Token, bool> Parser::comptime()
+template<TokenSource Source>
+std::tuple<Token, bool> Parser<Source>::comptime()
 {
   if (!next(Token::KwComptime))
   {
@@ -792,7 +886,8 @@ std::tuple<Token, bool> Parser::comptime()
   return {match(Token::KwComptime), true};
 }
 
-std::tuple<Token, bool> Parser::label()
+template<TokenSource Source>
+std::tuple<Token, bool> Parser<Source>::label()
 {
   std::tuple<Token, bool> const fail = {Token(), false};
 
@@ -821,7 +916,8 @@ std::tuple<Token, bool> Parser::label()
   return {toklabel, true};
 }
 
-std::tuple<Token, bool> Parser::jumpLabel()
+template<TokenSource Source>
+std::tuple<Token, bool> Parser<Source>::jumpLabel()
 {
   std::tuple<Token, bool> const fail = {Token(), false};
 
@@ -850,9 +946,10 @@ std::tuple<Token, bool> Parser::jumpLabel()
   return {tokLabel, true};
 }
 
-std::tuple<Node::SPtr, Token> Parser::capture()
+template<TokenSource Source>
+std::tuple<Node::Ptr, Token> Parser<Source>::capture()
 {
-  Node::SPtr pCapture = nullptr;
+  Node::Ptr pCapture = nullptr;
   Token tokClosingBar;
   if (next(Runes::Bar))
   {
@@ -869,37 +966,136 @@ std::tuple<Node::SPtr, Token> Parser::capture()
 
 /* ===================== Helpers ===================== */
 
-bool Parser::next(Token::Tag tag)
+template<TokenSource Source>
+void Parser<Source>::record(Node::Ptr pNode, size_t firstTokenIdx, State state)
 {
-  if (d_currentTokenIdx < d_tokens.size())
+  if (d_pRecorded != nullptr)
+  {
+    // the subtrees of the node were recorded before it and start after it
+    auto const it = std::upper_bound(d_pRecorded->begin(), d_pRecorded->end(), firstTokenIdx,
+      [](size_t idx, Reusable const& reusable) { return idx < reusable.firstTokenIdx; });
+    d_pRecorded->insert(it, Reusable{pNode, firstTokenIdx, d_currentTokenIdx - firstTokenIdx, state});
+  }
+}
+
+template<TokenSource Source>
+void Parser<Source>::move(Reusable const& reusable)
+{
+  auto const& shift = d_reuse->shift;
+  size_t const
+    begin = reusable.firstTokenIdx,
+    end = begin + reusable.tokenCount;
+
+  // the subtrees of a shifted subtree were shifted with it
+  auto it = d_moved.upper_bound(begin);
+  if (it != d_moved.begin() && std::prev(it)->second.end > begin)
   {
-    return d_tokens[d_currentTokenIdx].tag() == tag;
+    return;
   }
 
-  Token nextToken = d_tokenizer.next();
-  while (nextToken.tag() == Token::Comment) // TODO save these
+  // lines after the edit keep their columns
+  if (shift.from == shift.to
+    || (shift.from.line == shift.to.line && reusable.pNode->start().line != shift.from.line))
   {
-    nextToken = d_tokenizer.next();
+    return;
   }
 
-  d_tokens.push_back(nextToken);
-  // now d_currentTokenIdx = d_tokens.size() - 1
-  return d_tokens[d_currentTokenIdx].tag() == tag;
+  // subtrees shifted before a rollback are shifted again with this one
+  while (it != d_moved.end() && it->first < end)
+  {
+    it->second.pNode->shift(shift.inverse());
+    it = d_moved.erase(it);
+  }
+  reusable.pNode->shift(shift);
+  d_moved.emplace(begin, Moved{reusable.pNode, end});
+}
+
+template<TokenSource Source>
+FunctionExpression::LazyBody Parser<Source>::skipFunctionBody(Position* end)
+{
+  // one buffer for all the bodies skipped by this parser
+  if (d_pLazyTokens == nullptr)
+  {
+    d_pLazyTokens = d_pArena->make<std::vector<Token>>();
+    d_pArena->destroyWith(d_pLazyTokens);
+  }
+  std::vector<Token>& tokens = *d_pLazyTokens;
+
+  size_t const begin = tokens.size();
+  size_t depth = 0;
+  do
+  {
+    Token const tok = peek();
+    if (tok.tag() == Token::Eof)
+    {
+      tokens.erase(tokens.begin() + static_cast<std::ptrdiff_t>(begin), tokens.end());
+      throw error(tok, fmt::format("{} expected", Token::RBrace));
+    }
+    depth += static_cast<size_t>(tok.tag() == Token::LBrace);
+    depth -= static_cast<size_t>(tok.tag() == Token::RBrace);
+
+    tokens.push_back(tok);
+    d_currentTokenIdx += 1;
+  }
+  while (depth > 0);
+
+  *end = tokens.back().end();
+  tokens.emplace_back(Token::Eof, *end, *end, "");
+
+  return {
+    .parse = &Parser<Source>::parseLazyBody,
+    .pTokens = &tokens,
+    .begin = begin,
+    .end = tokens.size(),
+    .pArena = d_pArena,
+    .file = d_file,
+    .state = static_cast<uint8_t>(currentState()),
+    .isLazy = d_lazyFunctionBodies,
+  };
+}
+
+template<TokenSource Source>
+BlockExpression::Ptr Parser<Source>::parseLazyBody(FunctionExpression::LazyBody const& body)
+{
+  auto parser = Parser<TokenRange>(
+    TokenRange(*body.pTokens, body.begin, body.end, body.file),
+    *body.pArena,
+    static_cast<State>(body.state));
+  parser.setLazyFunctionBodies(body.isLazy);
+  return parser.blockExpression();
 }
 
-Token Parser::match(Token::Tag tag, std::string const& errorMessage, Position position)
+template<TokenSource Source>
+Token const& Parser<Source>::peek()
 {
-  if (d_currentTokenIdx == d_tokens.size())
+  // reused subtrees skip tokens that were not pulled yet
+  while (d_currentTokenIdx >= d_tokens.size())
   {
-    Token nextToken = d_tokenizer.next();
+    if (!d_tokens.empty() && d_tokens.back().tag() == Token::Eof)
+    {
+      return d_tokens.back();
+    }
+
+    Token nextToken = d_source.next();
     while (nextToken.tag() == Token::Comment) // TODO save these
     {
-      nextToken = d_tokenizer.next();
+      nextToken = d_source.next();
     }
     d_tokens.push_back(nextToken);
   }
+  return d_tokens[d_currentTokenIdx];
+}
 
-  Token const currentToken = d_tokens[d_currentTokenIdx];
+template<TokenSource Source>
+bool Parser<Source>::next(Token::Tag tag)
+{
+  return peek().tag() == tag;
+}
+
+template<TokenSource Source>
+Token Parser<Source>::match(Token::Tag tag, std::string const& errorMessage, Position position)
+{
+  Token const currentToken = peek();
   if (currentToken.tag() != tag)
   {
     if (position.isValid())
@@ -908,11 +1104,12 @@ Token Parser::match(Token::Tag tag, std::string const& errorMessage, Position po
     }
     throw error(currentToken, errorMessage);
   }
-  d_currentTokenIdx++;
+  d_currentTokenIdx = std::min(d_currentTokenIdx + 1, d_tokens.size());
   return currentToken;
 }
 
-Token Parser::match(Token::Tag tag, ErrorStrategy strategy, Position position)
+template<TokenSource Source>
+Token Parser<Source>::match(Token::Tag tag, ErrorStrategy strategy, Position position)
 {
   auto const errorMessage =
     (strategy == ErrorStrategy::Unreachable)
@@ -922,7 +1119,8 @@ Token Parser::match(Token::Tag tag, ErrorStrategy strategy, Position position)
   return match(tag, errorMessage, position);
 }
 
-bool Parser::skip(Token::Tag tag)
+template<TokenSource Source>
+bool Parser<Source>::skip(Token::Tag tag)
 {
   if (next(tag))
   {
@@ -932,7 +1130,8 @@ bool Parser::skip(Token::Tag tag)
   return false;
 }
 
-bool Parser::next(Operator::Tag tag)
+template<TokenSource Source>
+bool Parser<Source>::next(Operator::Tag tag)
 {
   if (!next(Token::Operator))
   {
@@ -943,7 +1142,8 @@ bool Parser::next(Operator::Tag tag)
   return tokOp.text() == fmt::to_string(tag);
 }
 
-Token Parser::match(Operator::Tag tag, std::string const& errorMessage, Position position)
+template<TokenSource Source>
+Token Parser<Source>::match(Operator::Tag tag, std::string const& errorMessage, Position position)
 {
   Token const tokOp = match(Token::Operator, errorMessage, position);
   if (tokOp.text() != fmt::to_string(tag))
@@ -957,7 +1157,8 @@ Token Parser::match(Operator::Tag tag, std::string const& errorMessage, Position
   return tokOp;
 }
 
-Token Parser::match(Operator::Tag tag, ErrorStrategy strategy, Position position)
+template<TokenSource Source>
+Token Parser<Source>::match(Operator::Tag tag, ErrorStrategy strategy, Position position)
 {
   auto const errorMessage =
     (strategy == ErrorStrategy::Unreachable)
@@ -967,7 +1168,8 @@ Token Parser::match(Operator::Tag tag, ErrorStrategy strategy, Position position
   return match(tag, errorMessage, position);
 }
 
-bool Parser::skip(Operator::Tag tag)
+template<TokenSource Source>
+bool Parser<Source>::skip(Operator::Tag tag)
 {
   if (next(tag))
   {
@@ -977,7 +1179,8 @@ bool Parser::skip(Operator::Tag tag)
   return false;
 }
 
-void Parser::matchStatementEnder(Position fallback)
+template<TokenSource Source>
+void Parser<Source>::matchStatementEnder(Position fallback)
 {
   match(Token::Semicolon, ErrorStrategy::DefaultErrorMessage, fallback);
   if (next(Token::Semicolon))
@@ -987,23 +1190,35 @@ void Parser::matchStatementEnder(Position fallback)
   }
 }
 
-Token Parser::lastMatchedToken()
+template<TokenSource Source>
+Token Parser<Source>::lastMatchedToken()
 {
   return d_tokens[std::min(d_currentTokenIdx, d_tokens.size() - 1)];
 }
 
-void Parser::setRollbackPoint()
+template<TokenSource Source>
+void Parser<Source>::setRollbackPoint()
 {
-  d_rollbacks.push_back(d_currentTokenIdx);
+  d_rollbacks.emplace_back(d_currentTokenIdx, (d_pRecorded != nullptr) ? d_pRecorded->size() : 0);
 }
 
-void Parser::rollback()
+template<TokenSource Source>
+void Parser<Source>::rollback()
 {
-  d_currentTokenIdx = d_rollbacks.empty() ? 0 : d_rollbacks.back();
+  auto const [tokenIdx, recordedCount] = d_rollbacks.empty() ? std::pair<size_t, size_t>() : d_rollbacks.back();
+  d_currentTokenIdx = tokenIdx;
   d_rollbacks.pop_back();
+
+  // subtrees parsed since the rollback point are not in the tree, they were
+  // recorded last
+  if (d_pRecorded != nullptr)
+  {
+    d_pRecorded->erase(d_pRecorded->begin() + static_cast<std::ptrdiff_t>(recordedCount), d_pRecorded->end());
+  }
 }
 
-void Parser::commit()
+template<TokenSource Source>
+void Parser<Source>::commit()
 {
   // TODO commit clears the used tokens from the vector
   if (!d_rollbacks.empty())
@@ -1012,27 +1227,32 @@ void Parser::commit()
   }
 }
 
-Error Parser::error(Token token, std::string const& message) const
+template<TokenSource Source>
+Error Parser<Source>::error(Token token, std::string const& message) const
 {
-  return Error(d_tokenizer.sourcePath(), token.start(), token.end(), message);
+  return Error(d_file, token.start(), token.end(), message);
 }
 
-Error Parser::error(Node::SPtr pNode, std::string const& message) const
+template<TokenSource Source>
+Error Parser<Source>::error(Node::Ptr pNode, std::string const& message) const
 {
-  return Error(d_tokenizer.sourcePath(), pNode->start(), pNode->end(), message);
+  return Error(d_file, pNode->start(), pNode->end(), message);
 }
 
-Error Parser::error(Position pos, std::string const& message) const
+template<TokenSource Source>
+Error Parser<Source>::error(Position pos, std::string const& message) const
 {
-  return Error(d_tokenizer.sourcePath(), pos, pos, message);
+  return Error(d_file, pos, pos, message);
 }
 
-Parser::State Parser::currentState() const
+template<TokenSource Source>
+ParserBase::State Parser<Source>::currentState() const
 {
   return d_stateStack.top();
 }
 
-Parser::State Parser::popState()
+template<TokenSource Source>
+ParserBase::State Parser<Source>::popState()
 {
   auto const state = d_stateStack.top();
   if (d_stateStack.size() > 1)
@@ -1042,13 +1262,22 @@ Parser::State Parser::popState()
   return state;
 }
 
-void Parser::pushState(State state)
+template<TokenSource Source>
+void Parser<Source>::pushState(State state)
 {
   d_stateStack.push(state);
 }
 
-bool Parser::isDestructuringExpression(ast::Node::SPtr expression)
+template<TokenSource Source>
+bool Parser<Source>::isDestructuringExpression(ast::Node::Ptr expression)
 {
   // TODO tuple, array
-  return expression->is<SymbolExpression>();
-}
\ No newline at end of file
+  return isAndNonNull<SymbolExpression>(expression);
+}
+
+template struct Parser<Tokenizer>;
+template struct Parser<TokenArray>;
+template struct Parser<TokenRange>;
+template struct Parser<TokenCache>;
+template struct Parser<TokenQueue>;
+template struct Parser<LexerThread>;
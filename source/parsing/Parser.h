@@ -2,14 +2,22 @@
 
 #include <parsing/Error.h>
 #include <parsing/Token.h>
+#include <parsing/TokenSource.h>
 #include <parsing/Tokenizer.h>
 #include <parsing/ast/Nodes.h>
 
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <set>
 #include <stack>
+#include <utility>
+#include <vector>
 
-struct Parser final
+// Types shared by every Parser specialization
+struct ParserBase
 {
-private:
+protected:
   enum class ErrorStrategy
   {
     Unreachable,
@@ -29,52 +37,124 @@ private:
     IfExpression,
   };
 
+  // A let statement, block or function definition parsed from
+  // tokenCount tokens starting at firstTokenIdx
+  struct Reusable
+  {
+    ast::Node::Ptr pNode;
+    size_t firstTokenIdx;
+    size_t tokenCount;
+    State state;
+  };
+
+  // Sorted by the first token, only holds nodes of the parsed tree so the
+  // subtrees of a node follow it
+  using ReuseTable = std::vector<Reusable>;
+
+  // Subtrees of a previous parse whose tokens, the one following them
+  // included, are the first prefixLength or the last suffixLength tokens
+  // of both the old and the new token streams can be reused. The suffix
+  // follows the edit, subtrees the edit moved are shared with the previous
+  // tree and get their positions shifted in place.
+  struct Reuse
+  {
+    ReuseTable const* pTable;
+    size_t oldTokenCount;
+    size_t newTokenCount;
+    size_t prefixLength;
+    size_t suffixLength;
+    PositionShift shift;
+  };
+
+  // A subtree shifted by reuse() and the old token index it ends at
+  struct Moved
+  {
+    ast::Node::Ptr pNode;
+    size_t end;
+  };
+
+  // The entries of the subtrees starting at the tokens [begin, end)
+  static std::pair<ReuseTable::const_iterator, ReuseTable::const_iterator> entries(
+    ReuseTable const& table, size_t begin, size_t end)
+  {
+    auto const byFirstToken = [](Reusable const& reusable, size_t idx) { return reusable.firstTokenIdx < idx; };
+    auto const first = std::lower_bound(table.begin(), table.end(), begin, byFirstToken);
+    return {first, std::lower_bound(first, table.end(), end, byFirstToken)};
+  }
+};
+
+// Specialized for every token source it is instantiated with in
+// Parser.cpp, tokens are pulled without any virtual call
+template<TokenSource Source>
+struct Parser final : ParserBase
+{
+  // Friends
+  template<TokenSource>
+  friend struct Parser;
+  friend struct IncrementalParser;
+
 private:
-  Tokenizer d_tokenizer;
+  Source d_source;
+  ast::Arena* d_pArena; // owns the parsed nodes
+  FileId d_file;
   std::vector<Token> d_tokens;
-  std::vector<size_t> d_rollbacks;
+  // the token and the number of recorded subtrees to return to
+  std::vector<std::pair<size_t, size_t>> d_rollbacks;
   std::stack<State> d_stateStack;
   size_t d_currentTokenIdx;
+  bool d_lazyFunctionBodies;
+  // tokens of the skipped function bodies, owned by the arena
+  std::vector<Token>* d_pLazyTokens;
+  ReuseTable* d_pRecorded;
+  std::optional<Reuse> d_reuse;
+  // reused subtrees of the previous parse, a rollback can reuse a subtree again
+  std::set<ast::Node::Ptr> d_reused;
+  // subtrees shifted by reuse() that no other shifted subtree contains, by
+  // the old index of their first token, to shift back if the parse fails
+  std::map<size_t, Moved> d_moved;
 
 public:
-  template<typename T>
-    requires std::is_same_v<T, Tokenizer>
-  Parser(T&& tokenizer)
-    : d_tokenizer(std::forward<T>(tokenizer))
-    , d_currentTokenIdx(0)
-  {
-    d_stateStack.push(State::Base);
-  }
+  Parser(Source source, ast::Arena& arena);
+
+private:
+  Parser(Source source, ast::Arena& arena, State state);
 
 public:
-  ast::TypeExpression::SPtr root();
+  // When set, function bodies are only brace-matched and their tokens
+  // stored, the body is parsed the first time FunctionExpression::body()
+  // is called. Errors inside skipped bodies are reported at that point.
+  // Forcing a body allocates from the arena, which is not thread safe.
+  void setLazyFunctionBodies(bool value) { d_lazyFunctionBodies = value; }
+  bool lazyFunctionBodies() const { return d_lazyFunctionBodies; }
 
-  ast::TokenExpression::SPtr tokenExpression();
+  ast::TypeExpression::Ptr root();
 
-  ast::TypeExpression::SPtr typeExpression(bool isRoot = false);
+  ast::TokenExpression::Ptr tokenExpression();
 
-  ast::FunctionExpression::SPtr functionExpression();
+  ast::TypeExpression::Ptr typeExpression(bool isRoot = false);
 
-  ast::LetStatement::SPtr letStatement();
+  ast::FunctionExpression::Ptr functionExpression();
 
-  ast::BlockExpression::SPtr blockExpression();
+  ast::LetStatement::Ptr letStatement();
 
-  ast::IfExpression::SPtr ifExpression();
+  ast::BlockExpression::Ptr blockExpression();
 
-  ast::LoopExpression::SPtr loopExpression();
+  ast::IfExpression::Ptr ifExpression();
 
-  ast::SwitchExpression::SPtr switchExpression();
+  ast::LoopExpression::Ptr loopExpression();
 
-  ast::Node::SPtr expression();
+  ast::SwitchExpression::Ptr switchExpression();
 
-  ast::Node::SPtr pred15();
+  ast::Node::Ptr expression();
 
-  ast::Node::SPtr atomic();
+  ast::Node::Ptr pred15();
+
+  ast::Node::Ptr atomic();
 
 private:
-  ast::Part::SPtr part();
+  ast::Part::Ptr part();
 
-  ast::Node::SPtr expressionOrPart(); // use only in typeExpression()
+  ast::Node::Ptr expressionOrPart(); // use only in typeExpression()
 
   std::tuple<Token, bool> comptime();
 
@@ -82,10 +162,10 @@ private:
 
   std::tuple<Token, bool> jumpLabel();
 
-  std::tuple<ast::Node::SPtr, Token> capture();
+  std::tuple<ast::Node::Ptr, Token> capture();
 
   template<typename NodeT = ast::Node>
-  std::shared_ptr<NodeT> expression(
+  NodeT* expression(
     size_t args,
     std::string const& errorMessage,
     Position fallback = Position::invalid())
@@ -96,7 +176,7 @@ private:
 
     if (!optional) assert(fallback.isValid());
 
-    auto pRes = expression();
+    ast::Node::Ptr pRes = expression();
 
     if (pRes == nullptr)
     {
@@ -123,7 +203,7 @@ private:
   }
 
   template<typename NodeT = ast::Node>
-  std::shared_ptr<NodeT> expression(
+  NodeT* expression(
     std::string const& errorMessage,
     Position fallback = Position::invalid())
   {
@@ -131,6 +211,85 @@ private:
   }
 
 private:
+  template<typename NodeT>
+  NodeT* reuse()
+  {
+    if (!d_reuse.has_value())
+    {
+      return nullptr;
+    }
+    auto const& reuse = d_reuse.value();
+
+    size_t const
+      newTokenCount = reuse.newTokenCount,
+      idx = d_currentTokenIdx;
+
+    bool const
+      inPrefix = idx < reuse.prefixLength,
+      inSuffix = idx >= newTokenCount - reuse.suffixLength;
+
+    if (!inPrefix && !inSuffix)
+    {
+      return nullptr;
+    }
+    size_t const oldIdx = inPrefix ? idx : reuse.oldTokenCount - (newTokenCount - idx);
+
+    // expression() labels or marks comptime what follows these,
+    // reused nodes must not be modified in case the parse fails
+    if (idx > 0 && (d_tokens[idx - 1].tag() == Token::Colon || d_tokens[idx - 1].tag() == Token::KwComptime))
+    {
+      return nullptr;
+    }
+
+    auto const [begin, end] = entries(*reuse.pTable, oldIdx, oldIdx + 1);
+    for (auto it = begin; it != end; ++it)
+    {
+      auto const& reusable = *it;
+      // + 1 for the token that ended the subtree
+      size_t const last = idx + reusable.tokenCount + 1;
+      if (!reusable.pNode->is<NodeT>()
+        || reusable.state != currentState()
+        // set by expression() from the tokens preceding the node
+        || reusable.pNode->isComptime()
+        || (reusable.pNode->is<ast::LabeledNode>() && reusable.pNode->as<ast::LabeledNode>()->isLabeled())
+        || (inPrefix && last > reuse.prefixLength)
+        || (inSuffix && last > newTokenCount))
+      {
+        continue;
+      }
+
+      if (d_reused.insert(reusable.pNode).second && inSuffix)
+      {
+        move(reusable);
+      }
+
+      if (d_pRecorded != nullptr)
+      {
+        // the subtrees of the reused node stay reusable, they follow it
+        // in both tables
+        auto const [subBegin, subEnd] = entries(*reuse.pTable, oldIdx, oldIdx + reusable.tokenCount);
+        for (auto sub = subBegin; sub != subEnd; ++sub)
+        {
+          d_pRecorded->push_back(Reusable{sub->pNode, sub->firstTokenIdx - oldIdx + idx, sub->tokenCount, sub->state});
+        }
+      }
+
+      d_currentTokenIdx += reusable.tokenCount;
+      return reusable.pNode->as<NodeT>();
+    }
+    return nullptr;
+  }
+
+  // Shifts a reused subtree of the suffix if the edit moved it
+  void move(Reusable const& reusable);
+
+  void record(ast::Node::Ptr pNode, size_t firstTokenIdx, State state);
+
+  ast::FunctionExpression::LazyBody skipFunctionBody(Position* end);
+  static ast::BlockExpression::Ptr parseLazyBody(ast::FunctionExpression::LazyBody const& body);
+
+  Token const& peek();
+
   bool next(Token::Tag tag);
   Token match(Token::Tag tag, std::string const& errorMessage, Position position = Position::invalid());
   Token match(Token::Tag tag, ErrorStrategy strategy = ErrorStrategy::Unreachable, Position position = Position::invalid());
@@ -151,12 +310,12 @@ private:
   void commit();
 
   [[nodiscard]] Error error(Token token, std::string const& message) const;
-  [[nodiscard]] Error error(ast::Node::SPtr pNode, std::string const& message) const;
+  [[nodiscard]] Error error(ast::Node::Ptr pNode, std::string const& message) const;
   [[nodiscard]] Error error(Position pos, std::string const& message) const;
 
   State currentState() const;
   State popState();
   void pushState(State state);
 
-  static bool isDestructuringExpression(ast::Node::SPtr expression);
+  static bool isDestructuringExpression(ast::Node::Ptr expression);
 };
\ No newline at end of file
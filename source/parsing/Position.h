@@ -30,6 +30,33 @@ struct Position final
   };
 };
 
+// Moves the positions at or after from so that from is at to, for text
+// following an edit that added or removed text. The lines after from keep
+// their columns.
+struct PositionShift final
+{
+  // Data
+  Position from;
+  Position to;
+
+  // Methods
+  constexpr PositionShift inverse() const noexcept { return {to, from}; }
+
+  // Operators
+  constexpr Position operator()(Position pos) const noexcept
+  {
+    if (!pos.isValid() || pos < from)
+    {
+      return pos;
+    }
+    if (pos.line == from.line)
+    {
+      return Position(to.line, pos.column - from.column + to.column);
+    }
+    return Position(pos.line - from.line + to.line, pos.column);
+  }
+};
+
 template<>
 struct fmt::formatter<Position>
 {
@@ -0,0 +1,160 @@
+#include "parsing/SourceManager.h"
+
+#include <parsing/Error.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+SourceManager& SourceManager::instance()
+{
+  static SourceManager inst;
+  return inst;
+}
+
+FileId SourceManager::id(std::string const& path)
+{
+  auto& inst = instance();
+  auto const lock = std::scoped_lock(inst.d_mutex);
+
+  if (auto const it = inst.d_ids.find(path); it != inst.d_ids.end())
+  {
+    return it->second;
+  }
+
+  auto const res = static_cast<FileId>(inst.d_files.size());
+  auto const& pFile = inst.d_files.emplace_back(std::make_unique<File>());
+  pFile->path = path;
+  inst.d_ids.emplace(pFile->path, res);
+  return res;
+}
+
+FileId SourceManager::load(std::string const& path)
+{
+  auto const res = id(path);
+  if (hasText(res))
+  {
+    return res;
+  }
+
+  auto fileStream = std::ifstream(path, std::ios::in | std::ios::binary);
+  if (!fileStream)
+  {
+    throw Error(path, "cannot open file");
+  }
+  std::stringstream text;
+  text << fileStream.rdbuf();
+  return add(path, std::move(text).str());
+}
+
+FileId SourceManager::add(std::string const& path, std::string text)
+{
+  auto const res = id(path);
+  auto lineStarts = computeLineStarts(text);
+
+  auto& inst = instance();
+  auto const lock = std::scoped_lock(inst.d_mutex);
+
+  // texts never change once set, views of them stay valid
+  auto& file = *inst.d_files[static_cast<size_t>(res)];
+  if (!file.hasText.load(std::memory_order_relaxed))
+  {
+    file.text = std::move(text);
+    file.lineStarts = std::move(lineStarts);
+    file.hasText.store(true, std::memory_order_release);
+  }
+  return res;
+}
+
+std::string const& SourceManager::path(FileId file)
+{
+  return instance().file(file).path;
+}
+
+bool SourceManager::hasText(FileId file)
+{
+  return withText(file) != nullptr;
+}
+
+std::string_view SourceManager::text(FileId file)
+{
+  auto const pFile = withText(file);
+  return pFile != nullptr ? std::string_view(pFile->text) : std::string_view();
+}
+
+std::span<size_t const> SourceManager::lineStarts(FileId file)
+{
+  auto const pFile = withText(file);
+  return pFile != nullptr ? std::span<size_t const>(pFile->lineStarts) : std::span<size_t const>();
+}
+
+std::string_view SourceManager::line(FileId file, size_t line)
+{
+  auto const pFile = withText(file);
+  if (pFile == nullptr || line >= pFile->lineStarts.size())
+  {
+    return {};
+  }
+  auto const& f = *pFile;
+
+  size_t const
+    begin = f.lineStarts[line],
+    end = (line + 1 < f.lineStarts.size()) ? f.lineStarts[line + 1] - 1 : f.text.size();
+
+  auto res = std::string_view(f.text).substr(begin, end - begin);
+  if (res.ends_with('\r'))
+  {
+    res.remove_suffix(1);
+  }
+  return res;
+}
+
+size_t SourceManager::offset(FileId file, Position position)
+{
+  auto const pFile = withText(file);
+  assert(pFile != nullptr);
+  auto const& f = *pFile;
+  assert(position.line < f.lineStarts.size());
+  return f.lineStarts[position.line] + position.column;
+}
+
+Position SourceManager::position(FileId file, size_t offset)
+{
+  auto const pFile = withText(file);
+  assert(pFile != nullptr);
+  auto const& f = *pFile;
+
+  // the last line start not after offset
+  auto const it = std::upper_bound(f.lineStarts.begin(), f.lineStarts.end(), offset);
+  auto const line = static_cast<size_t>(it - f.lineStarts.begin()) - 1;
+  return Position(line, offset - f.lineStarts[line]);
+}
+
+SourceManager::File const& SourceManager::file(FileId file) const
+{
+  // the vector can grow on other threads, the files themselves do not move
+  auto const lock = std::scoped_lock(d_mutex);
+  assert(static_cast<size_t>(file) < d_files.size());
+  return *d_files[static_cast<size_t>(file)];
+}
+
+SourceManager::File const* SourceManager::withText(FileId file)
+{
+  auto const& f = instance().file(file);
+  return f.hasText.load(std::memory_order_acquire) ? &f : nullptr;
+}
+
+std::vector<size_t> SourceManager::computeLineStarts(std::string_view text)
+{
+  std::vector<size_t> res = {0};
+  char const* pCurrent = text.data();
+  char const* const pEnd = text.data() + text.size();
+  while (auto const pNewline = static_cast<char const*>(std::memchr(pCurrent, '\n', static_cast<size_t>(pEnd - pCurrent))))
+  {
+    res.push_back(static_cast<size_t>(pNewline - text.data()) + 1);
+    pCurrent = pNewline + 1;
+  }
+  return res;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <parsing/Position.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Identifies a source file registered with the SourceManager
+enum class FileId : uint32_t {};
+
+// Owns the source files of a run. Every path is registered once and
+// referred to by its FileId, tokenizers, parsers and errors keep the id
+// instead of a copy of the path. Files that are loaded also keep their
+// text and the offsets of their line starts so diagnostics do not have to
+// read them again.
+//
+// Paths that name no file, like "<stdin>", are registered without a text.
+// Registered files live until the end of the program, references to their
+// paths, texts and line tables stay valid. Can be used from any thread.
+struct SourceManager final
+{
+private:
+  // Types
+  struct File
+  {
+    std::string path;
+    // set once under the lock, then published by hasText, readers that
+    // see hasText read them without the lock
+    std::string text;
+    std::vector<size_t> lineStarts;
+    std::atomic<bool> hasText = false;
+  };
+
+  // Data
+  std::vector<std::unique_ptr<File>> d_files;
+  std::unordered_map<std::string_view, FileId> d_ids; // views of the paths in d_files
+  mutable std::mutex d_mutex;
+
+  static SourceManager& instance();
+
+public:
+  // Methods
+  // The id of path, registered without a text if it is new
+  static FileId id(std::string const& path);
+
+  // The id of path with its text, reads the file the first time, throws
+  // Error if it cannot be read
+  static FileId load(std::string const& path);
+
+  // Sets the text of path unless it has one, e.g. for text read from stdin
+  static FileId add(std::string const& path, std::string text);
+
+  static std::string const& path(FileId file);
+  static bool hasText(FileId file);
+  // Empty if the file has no text
+  static std::string_view text(FileId file);
+  // Offsets of the line starts, the first is 0, empty if the file has no text
+  static std::span<size_t const> lineStarts(FileId file);
+
+  // The text of a line without its line break, empty if out of range
+  static std::string_view line(FileId file, size_t line);
+  // Byte offset of position, positions past the end of a line are kept
+  static size_t offset(FileId file, Position position);
+  // Line and column of a byte offset by binary search over the line starts
+  static Position position(FileId file, size_t offset);
+
+private:
+  File const& file(FileId file) const;
+  // nullptr if the file has no text yet
+  static File const* withText(FileId file);
+  static std::vector<size_t> computeLineStarts(std::string_view text);
+};
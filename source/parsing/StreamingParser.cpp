@@ -0,0 +1,126 @@
+#include "parsing/StreamingParser.h"
+
+#include <parsing/Parser.h>
+#include <Utils.h>
+
+#include <istream>
+
+using namespace ast;
+
+StreamingParser::StreamingParser(std::string const& sourcePath)
+  : d_pArena(std::make_unique<Arena>())
+  , d_file(SourceManager::id(sourcePath))
+  , d_pendingOffset(0)
+  , d_parsedLength(0)
+  , d_end(0, 0)
+  , d_keepsTree(true)
+  , d_hasFields(false)
+  , d_hasDeclsPost(false)
+  , d_pRoot(nullptr)
+  , d_firstLine(0)
+{}
+
+std::vector<Node::Ptr> StreamingParser::push(std::string_view piece)
+{
+  startCall();
+  d_pending += piece;
+  d_scanner.push(piece);
+
+  std::vector<Node::Ptr> res;
+  auto const& boundaries = d_scanner.boundaries();
+  for (size_t i = 1; i < boundaries.size(); i += 1)
+  {
+    parse(boundaries[i].offset, boundaries[i - 1].position, &res);
+  }
+  d_scanner.dropBoundaries();
+  return res;
+}
+
+std::vector<Node::Ptr> StreamingParser::finish()
+{
+  startCall();
+  d_scanner.finish();
+
+  std::vector<Node::Ptr> res;
+  parse(d_pendingOffset + d_pending.size(), d_scanner.boundaries().back().position, &res);
+
+  if (d_keepsTree)
+  {
+    d_pRoot = TypeExpression::make(
+      *d_pArena, TypeExpression::Struct, Position(0, 0), d_end, d_fields, d_declsPre, d_declsPost);
+  }
+  return res;
+}
+
+void StreamingParser::startCall()
+{
+  if (!d_keepsTree)
+  {
+    d_pArena = std::make_unique<Arena>();
+  }
+
+  // once per call, so that the text is not moved for every declaration
+  d_pending.erase(0, d_parsedLength);
+  d_pendingOffset += d_parsedLength;
+  d_parsedLength = 0;
+
+  // the pending text starts at the last boundary
+  Position const start = d_scanner.boundaries().back().position;
+  d_lineStarts.assign(1, d_pendingOffset - start.column);
+  d_firstLine = start.line;
+}
+
+void StreamingParser::parse(size_t endOffset, Position start, std::vector<Node::Ptr>* res)
+{
+  size_t const chunkOffset = d_pendingOffset + d_parsedLength;
+  auto const chunk = std::string_view(d_pending).substr(d_parsedLength, endOffset - chunkOffset);
+
+  auto buffer = ViewBuffer(chunk);
+  auto textStream = std::istream(&buffer);
+  auto parser = Parser(Tokenizer(textStream, d_file, start), *d_pArena);
+  auto const pRoot = parser.root();
+
+  for (size_t i = 0; i < chunk.size(); i += 1)
+  {
+    if (chunk[i] == '\n')
+    {
+      d_lineStarts.push_back(chunkOffset + i + 1);
+    }
+  }
+  d_parsedLength += chunk.size();
+
+  // the rules Parser::typeExpression() checks across declarations
+  for (auto const& pDecl : pRoot->declsPre())
+  {
+    d_hasDeclsPost = d_hasDeclsPost || d_hasFields;
+    if (d_keepsTree)
+    {
+      (d_hasFields ? d_declsPost : d_declsPre).push_back(pDecl);
+    }
+    res->push_back(pDecl);
+  }
+  for (auto const& pField : pRoot->fields())
+  {
+    if (d_hasDeclsPost)
+    {
+      throw Error(d_file, pField->start(), pField->end(),
+        fmt::format("{:field}s must be grouped together", TypeExpression::Struct));
+    }
+    d_hasFields = true;
+    if (d_keepsTree)
+    {
+      d_fields.push_back(pField);
+    }
+    res->push_back(pField);
+  }
+  for (auto const& pDecl : pRoot->declsPost())
+  {
+    d_hasDeclsPost = true;
+    if (d_keepsTree)
+    {
+      d_declsPost.push_back(pDecl);
+    }
+    res->push_back(pDecl);
+  }
+  d_end = pRoot->end();
+}
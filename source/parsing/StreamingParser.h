@@ -0,0 +1,68 @@
+#pragma once
+
+#include <parsing/DeclarationScanner.h>
+#include <parsing/SourceManager.h>
+#include <parsing/ast/Nodes.h>
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Parses the implicit root type expression of a source that arrives in
+// pieces, e.g. from a pipe. Every top-level declaration and field is
+// parsed and returned as soon as the piece containing its ';' or ',' is
+// pushed instead of waiting for the whole input.
+//
+// Without setKeepsTree(false) the whole tree is kept for root(), otherwise
+// the nodes returned by a call are released by the next one and memory
+// does not grow with the input.
+struct StreamingParser final
+{
+private:
+  // Data
+  std::unique_ptr<ast::Arena> d_pArena;
+  FileId d_file;
+  DeclarationScanner d_scanner;
+  std::string d_pending; // source text from the last boundary of the previous call
+  size_t d_pendingOffset;
+  size_t d_parsedLength; // of d_pending, dropped by the next call
+  Position d_end; // of the last parsed chunk
+  bool d_keepsTree;
+  bool d_hasFields, d_hasDeclsPost;
+  std::vector<ast::Part::Ptr> d_fields;
+  std::vector<ast::LetStatement::Ptr> d_declsPre, d_declsPost;
+  ast::TypeExpression::Ptr d_pRoot;
+  std::vector<size_t> d_lineStarts; // of the text parsed by the last call
+  size_t d_firstLine;
+
+public:
+  // Constructors
+  StreamingParser(std::string const& sourcePath);
+
+  // Methods
+  // Set before the first push()
+  void setKeepsTree(bool value) { d_keepsTree = value; }
+  bool keepsTree() const { return d_keepsTree; }
+
+  // Returns the let statements and fields completed by piece, in source order
+  std::vector<ast::Node::Ptr> push(std::string_view piece);
+
+  // Returns whatever follows the last ';' or ','
+  std::vector<ast::Node::Ptr> finish();
+
+  // The same tree Parser::root() gives, available after finish() if the
+  // tree is kept
+  ast::TypeExpression::Ptr root() const { return d_pRoot; }
+
+  // Byte offsets of the lines of the nodes returned by the last push() or
+  // finish(), lineStarts()[0] is the start of line firstLine()
+  std::span<size_t const> lineStarts() const { return d_lineStarts; }
+  size_t firstLine() const { return d_firstLine; }
+
+private:
+  // Starts the nodes and the line starts returned by the next call
+  void startCall();
+  void parse(size_t endOffset, Position start, std::vector<ast::Node::Ptr>* res);
+};
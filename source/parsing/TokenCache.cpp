@@ -0,0 +1,202 @@
+#include "parsing/TokenCache.h"
+
+#include <parsing/Error.h>
+#include <parsing/Intern.h>
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
+constexpr char magic[4] = {'M', 'I', 'R', 'T'};
+
+template<typename T>
+void writeRaw(std::ofstream& file, T const& value)
+{
+  file.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+} // anonymous namespace
+
+TokenCache::TokenCache(std::string const& cachePath, std::string const& sourcePath)
+  : d_file(SourceManager::id(sourcePath))
+  , d_pMapping(nullptr)
+  , d_mappingSize(0)
+  , d_records(nullptr)
+  , d_strings(nullptr)
+  , d_text(nullptr)
+  , d_tokenCount(0)
+  , d_currentTokenIdx(0)
+{
+  int const fd = ::open(cachePath.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw Error(cachePath, "cannot open token cache");
+  }
+
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header))
+  {
+    ::close(fd);
+    throw Error(cachePath, "invalid token cache");
+  }
+
+  d_mappingSize = static_cast<size_t>(info.st_size);
+  d_pMapping = ::mmap(nullptr, d_mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (d_pMapping == MAP_FAILED)
+  {
+    d_pMapping = nullptr;
+    throw Error(cachePath, "cannot map token cache");
+  }
+
+  auto const* bytes = static_cast<char const*>(d_pMapping);
+  Header header;
+  std::memcpy(&header, bytes, sizeof(Header));
+
+  if (!isValid(header))
+  {
+    ::munmap(d_pMapping, d_mappingSize);
+    d_pMapping = nullptr;
+    throw Error(cachePath, "invalid token cache");
+  }
+
+  d_tokenCount = static_cast<size_t>(header.tokenCount);
+  d_records = reinterpret_cast<Record const*>(bytes + sizeof(Header));
+  d_strings = reinterpret_cast<StringRecord const*>(d_records + d_tokenCount);
+  d_text = reinterpret_cast<char const*>(d_strings + header.stringCount);
+  d_interned.resize(static_cast<size_t>(header.stringCount));
+}
+
+TokenCache::TokenCache(TokenCache&& other) noexcept
+  : d_file(other.d_file)
+  , d_pMapping(other.d_pMapping)
+  , d_mappingSize(other.d_mappingSize)
+  , d_records(other.d_records)
+  , d_strings(other.d_strings)
+  , d_text(other.d_text)
+  , d_tokenCount(other.d_tokenCount)
+  , d_currentTokenIdx(other.d_currentTokenIdx)
+  , d_interned(std::move(other.d_interned))
+{
+  other.d_pMapping = nullptr;
+}
+
+TokenCache::~TokenCache()
+{
+  if (d_pMapping != nullptr)
+  {
+    ::munmap(d_pMapping, d_mappingSize);
+  }
+}
+
+void TokenCache::write(std::string const& cachePath, std::vector<Token> const& tokens)
+{
+  assert(!tokens.empty() && tokens.back().tag() == Token::Eof);
+
+  std::string text;
+  std::vector<StringRecord> strings;
+  std::unordered_map<std::string_view, uint32_t> stringIds;
+  std::vector<Record> records;
+  records.reserve(tokens.size());
+  for (auto const& token : tokens)
+  {
+    auto [it, isNew] = stringIds.try_emplace(token.text(), static_cast<uint32_t>(strings.size()));
+    if (isNew)
+    {
+      strings.push_back({static_cast<uint32_t>(text.size()), static_cast<uint32_t>(token.text().size())});
+      text += token.text();
+    }
+
+    records.push_back(Record{
+      static_cast<uint32_t>(token.tag()),
+      static_cast<uint32_t>(token.start().line),
+      static_cast<uint32_t>(token.start().column),
+      static_cast<uint32_t>(token.end().line),
+      static_cast<uint32_t>(token.end().column),
+      it->second});
+  }
+
+  Header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.tokenCount = records.size();
+  header.stringCount = strings.size();
+  header.textSize = text.size();
+
+  auto file = std::ofstream(cachePath, std::ios::out | std::ios::binary | std::ios::trunc);
+  writeRaw(file, header);
+  file.write(reinterpret_cast<char const*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+  file.write(reinterpret_cast<char const*>(strings.data()), static_cast<std::streamsize>(strings.size() * sizeof(StringRecord)));
+  file.write(text.data(), static_cast<std::streamsize>(text.size()));
+
+  if (!file)
+  {
+    throw Error(cachePath, "cannot write token cache");
+  }
+}
+
+Token TokenCache::next()
+{
+  Record const& record = d_records[d_currentTokenIdx];
+  d_currentTokenIdx += static_cast<size_t>(d_currentTokenIdx + 1 < d_tokenCount);
+
+  // interned since the mapping does not outlive the parser
+  auto& text = d_interned[record.string];
+  if (!text.has_value())
+  {
+    StringRecord const& string = d_strings[record.string];
+    text = Intern::string(d_text + string.offset, string.length);
+  }
+
+  return Token(
+    static_cast<Token::Tag>(record.tag),
+    Position(record.startLine, record.startColumn),
+    Position(record.endLine, record.endColumn),
+    *text);
+}
+
+bool TokenCache::isValid(Header const& header) const
+{
+  // each count is bounded first so the sizes below cannot overflow
+  bool const isHeaderValid =
+    std::memcmp(header.magic, magic, sizeof(magic)) == 0
+    && header.version == version
+    && header.tokenCount > 0
+    && header.tokenCount <= d_mappingSize / sizeof(Record)
+    && header.stringCount <= d_mappingSize / sizeof(StringRecord)
+    && header.textSize <= d_mappingSize
+    && sizeof(Header) + header.tokenCount * sizeof(Record) + header.stringCount * sizeof(StringRecord) + header.textSize
+      == d_mappingSize;
+  if (!isHeaderValid)
+  {
+    return false;
+  }
+
+  auto const* records = reinterpret_cast<Record const*>(static_cast<char const*>(d_pMapping) + sizeof(Header));
+  auto const* strings = reinterpret_cast<StringRecord const*>(records + header.tokenCount);
+
+  for (size_t i = 0; i < header.stringCount; ++i)
+  {
+    if (static_cast<uint64_t>(strings[i].offset) + strings[i].length > header.textSize)
+    {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < header.tokenCount; ++i)
+  {
+    if (records[i].tag > static_cast<uint32_t>(Token::Eof) || records[i].string >= header.stringCount)
+    {
+      return false;
+    }
+  }
+  return records[header.tokenCount - 1].tag == static_cast<uint32_t>(Token::Eof);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <parsing/SourceManager.h>
+#include <parsing/Token.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Token source reading a file written by TokenCache::write(), the file is
+// memory mapped and checked once when it is opened, tokens are decoded
+// only when the parser asks for them. Token texts are deduplicated into a
+// string table and each one is interned the first time a token uses it.
+struct TokenCache final
+{
+private:
+  // Types
+  struct Header
+  {
+    char magic[4];
+    uint32_t version;
+    uint64_t tokenCount;
+    uint64_t stringCount;
+    uint64_t textSize;
+  };
+
+  struct Record
+  {
+    uint32_t tag;
+    uint32_t startLine;
+    uint32_t startColumn;
+    uint32_t endLine;
+    uint32_t endColumn;
+    uint32_t string;
+  };
+
+  struct StringRecord
+  {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  static constexpr uint32_t version = 2;
+
+  // Data
+  FileId d_file;
+  void* d_pMapping;
+  size_t d_mappingSize;
+  Record const* d_records;
+  StringRecord const* d_strings;
+  char const* d_text;
+  size_t d_tokenCount;
+  size_t d_currentTokenIdx;
+  std::vector<std::optional<std::string_view>> d_interned; // by string
+
+public:
+  // Constructors
+  TokenCache(std::string const& cachePath, std::string const& sourcePath);
+  TokenCache(TokenCache&& other) noexcept;
+  TokenCache(TokenCache const&) = delete;
+  ~TokenCache();
+
+  // Methods
+  // tokens must end with an Eof token
+  static void write(std::string const& cachePath, std::vector<Token> const& tokens);
+
+  Token next();
+  FileId fileId() const { return d_file; }
+  size_t size() const { return d_tokenCount; }
+
+  // Operators
+  TokenCache& operator=(TokenCache const&) = delete;
+  TokenCache& operator=(TokenCache&&) = delete;
+
+private:
+  // Checks the sizes in the header and every record against the mapping
+  bool isValid(Header const& header) const;
+};
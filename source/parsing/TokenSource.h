@@ -0,0 +1,139 @@
+#pragma once
+
+#include <parsing/SourceManager.h>
+#include <parsing/Token.h>
+
+#include <cassert>
+#include <concepts>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Anything the parser can pull tokens from. Once next() returns an Eof
+// token the parser stops asking for more. Token texts must outlive the
+// source, like the interned ones the Tokenizer produces.
+template<typename T>
+concept TokenSource = requires(T& source)
+{
+  { source.next() } -> std::same_as<Token>;
+  { source.fileId() } -> std::same_as<FileId>;
+};
+
+// Tokens lexed ahead of time, must end with an Eof token
+struct TokenArray final
+{
+private:
+  // Data
+  std::vector<Token> d_tokens;
+  FileId d_file;
+  size_t d_currentTokenIdx;
+
+public:
+  // Constructors
+  TokenArray(std::vector<Token>&& tokens, FileId file)
+    : d_tokens(std::move(tokens))
+    , d_file(file)
+    , d_currentTokenIdx(0)
+  {
+    assert(!d_tokens.empty() && d_tokens.back().tag() == Token::Eof);
+  }
+
+  TokenArray(std::vector<Token>&& tokens, std::string const& sourcePath)
+    : TokenArray(std::move(tokens), SourceManager::id(sourcePath))
+  {}
+
+  // Methods
+  Token next()
+  {
+    Token const& res = d_tokens[d_currentTokenIdx];
+    d_currentTokenIdx += static_cast<size_t>(d_currentTokenIdx + 1 < d_tokens.size());
+    return res;
+  }
+
+  FileId fileId() const { return d_file; }
+};
+
+// Tokens [begin, end) of a buffer owned by someone else, the range must
+// end with an Eof token. Tokens are read by index so the buffer can grow
+// while the range is read.
+struct TokenRange final
+{
+private:
+  // Data
+  std::vector<Token> const* d_pTokens;
+  size_t d_currentTokenIdx;
+  size_t d_end;
+  FileId d_file;
+
+public:
+  // Constructors
+  TokenRange(std::vector<Token> const& tokens, size_t begin, size_t end, FileId file)
+    : d_pTokens(&tokens)
+    , d_currentTokenIdx(begin)
+    , d_end(end)
+    , d_file(file)
+  {
+    assert(begin < end && end <= tokens.size() && tokens[end - 1].tag() == Token::Eof);
+  }
+
+  // Methods
+  Token next()
+  {
+    Token const& res = (*d_pTokens)[d_currentTokenIdx];
+    d_currentTokenIdx += static_cast<size_t>(d_currentTokenIdx + 1 < d_end);
+    return res;
+  }
+
+  FileId fileId() const { return d_file; }
+};
+
+// Tokens pushed by a producer thread while the parser consumes them,
+// copies share the same queue
+struct TokenQueue final
+{
+private:
+  // Types
+  struct Shared
+  {
+    std::mutex mutex;
+    std::condition_variable pushed;
+    std::deque<Token> tokens;
+  };
+
+  // Data
+  std::shared_ptr<Shared> d_pShared;
+  FileId d_file;
+
+public:
+  // Constructors
+  TokenQueue(std::string const& sourcePath)
+    : d_pShared(std::make_shared<Shared>())
+    , d_file(SourceManager::id(sourcePath))
+  {}
+
+  // Methods
+  // the producer must end the stream with an Eof token
+  void push(Token token)
+  {
+    {
+      auto const lock = std::scoped_lock(d_pShared->mutex);
+      d_pShared->tokens.push_back(token);
+    }
+    d_pShared->pushed.notify_one();
+  }
+
+  Token next()
+  {
+    auto lock = std::unique_lock(d_pShared->mutex);
+    d_pShared->pushed.wait(lock, [this]() { return !d_pShared->tokens.empty(); });
+
+    Token const res = d_pShared->tokens.front();
+    d_pShared->tokens.pop_front();
+    return res;
+  }
+
+  FileId fileId() const { return d_file; }
+};
@@ -49,11 +49,15 @@ std::map<std::string_view, Token::Tag> const keywords
 } // anonymous
 
 // TODO support for utf8 unicode & better error messages
-Tokenizer::Tokenizer(std::istream& input, std::string const& sourcePath)
+Tokenizer::Tokenizer(std::istream& input, FileId file, Position start)
   : d_inputStream(input)
-  , d_sourcePath(sourcePath)
-  , d_currentPos(0, 0)
-  , d_nextPos(0, 0)
+  , d_file(file)
+  , d_currentPos(start)
+  , d_nextPos(start)
+{}
+
+Tokenizer::Tokenizer(std::istream& input, std::string const& sourcePath, Position start)
+  : Tokenizer(input, SourceManager::id(sourcePath), start)
 {}
 
 Token Tokenizer::next()
@@ -436,13 +440,13 @@ Token Tokenizer::next()
 
   if (d_currentState == StringLiteral)
   {
-    throw Error(d_sourcePath, d_nextPos, "string literal missing terminating '\"'")
+    throw Error(d_file, d_nextPos, "string literal missing terminating '\"'")
       .note(d_currentToken.d_start, "string literal starts here");
   }
 
   if (d_currentState == BlockComment && commentNestLevel > 0)
   {
-    throw Error(d_sourcePath, d_nextPos, "block comment missing terminating '*/'")
+    throw Error(d_file, d_nextPos, "block comment missing terminating '*/'")
       .note(d_currentToken.d_start, "block comment starts here");
   }
 
@@ -460,11 +464,6 @@ Token Tokenizer::next()
   return Token(Token::Eof, d_nextPos, d_nextPos, "");
 }
 
-std::string const& Tokenizer::sourcePath() const
-{
-  return d_sourcePath;
-}
-
 bool Tokenizer::inputStreamFinished() const
 {
   return d_inputStream.eof() && !d_leftOver;
@@ -478,8 +477,8 @@ char Tokenizer::inputPeek()
 
 char Tokenizer::inputNext()
 {
-  // TODO return \0 on Eof
-  char res;
+  // \0 on Eof, get() leaves res untouched
+  char res = '\0';
   d_inputStream.get(res);
   return res;
 }
@@ -566,7 +565,7 @@ Token Tokenizer::tokenEnd()
     auto const errMsg = Operator::validate(d_currentToken.d_text);
     if (!errMsg.empty())
     {
-      throw Error(d_sourcePath, d_currentToken.d_start, d_currentToken.d_end, errMsg);
+      throw Error(d_file, d_currentToken.d_start, d_currentToken.d_end, errMsg);
     }
   }
 
@@ -575,5 +574,5 @@ Token Tokenizer::tokenEnd()
 
 Error Tokenizer::error(std::string const& message) const
 {
-  return Error(d_sourcePath, d_currentPos, d_currentPos.nextColumn(), message);
+  return Error(d_file, d_currentPos, d_currentPos.nextColumn(), message);
 }
@@ -37,29 +37,37 @@ private:
   // Data
   std::istream& d_inputStream;
 
-	std::string const d_sourcePath;
+	FileId const d_file;
 
   bool d_leftOver = false;
-  char d_currentChar;
-  char d_nextChar;
+  char d_currentChar = '\0';
+  char d_nextChar = '\0';
 
   Position d_currentPos;
 	Position d_nextPos;
 
   std::string d_currentTokenText;
 
-  State d_currentState;
+  // set by every next(), initialized so that moving a fresh tokenizer
+  // does not read an indeterminate value
+  State d_currentState = Start;
 	Token d_currentToken;
 
 public:
   // Constructors
   Tokenizer(
     std::istream& input,
-    std::string const& sourcePath);
+    FileId file,
+    Position start = Position(0, 0)); // position of the first character of input
+
+  Tokenizer(
+    std::istream& input,
+    std::string const& sourcePath,
+    Position start = Position(0, 0));
 
   // Methods
 	Token next();
-  std::string const& sourcePath() const;
+  FileId fileId() const { return d_file; }
 
 private:
   bool inputStreamFinished() const;
@@ -0,0 +1,66 @@
+#include "parsing/ast/Arena.h"
+
+using namespace ast;
+
+Arena::Arena()
+  : Arena(nullptr)
+{}
+
+Arena::Arena(Arena* pRoot)
+  : d_pRoot(pRoot != nullptr ? pRoot : this)
+  , d_idsReserved(0)
+  , d_nextId(0)
+  , d_idsEnd(0)
+  , d_nodeCount(0)
+  , d_bytesUsed(0)
+{}
+
+Arena::~Arena()
+{
+  for (auto it = d_finalizers.rbegin(); it != d_finalizers.rend(); ++it)
+  {
+    it->destroy(it->pObject);
+  }
+}
+
+Arena& Arena::fork()
+{
+  auto const lock = std::scoped_lock(d_forksMutex);
+  return *d_forks.emplace_back(new Arena(d_pRoot));
+}
+
+size_t Arena::nodeCount() const
+{
+  size_t res = d_nodeCount;
+  for (auto const& pFork : d_forks)
+  {
+    res += pFork->nodeCount();
+  }
+  return res;
+}
+
+size_t Arena::bytesUsed() const
+{
+  size_t res = d_bytesUsed;
+  for (auto const& pFork : d_forks)
+  {
+    res += pFork->bytesUsed();
+  }
+  return res;
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+  d_bytesUsed += size;
+  return d_resource.allocate(size, alignment);
+}
+
+uint32_t Arena::nextId()
+{
+  if (d_nextId == d_idsEnd)
+  {
+    d_nextId = d_pRoot->d_idsReserved.fetch_add(IdBlockSize);
+    d_idsEnd = d_nextId + IdBlockSize;
+  }
+  return d_nextId++;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ast
+{
+
+struct Node;
+
+// Owns syntax trees. Nodes and their child arrays are bump allocated from
+// blocks that are released all at once when the arena is destroyed, node
+// destructors are not run. Objects that own memory outside of the arena
+// must be registered with destroyWith().
+//
+// An arena is not thread safe, threads building parts of the same tree
+// allocate from their own fork().
+//
+// Nodes get ids that are unique among the nodes of an arena and its forks.
+// Forks reserve ids in blocks so the ids of a tree are dense enough to
+// index side tables like ParentTable.
+struct Arena final
+{
+private:
+  // Types
+  struct Finalizer
+  {
+    void (*destroy)(void*);
+    void* pObject;
+  };
+
+  static constexpr uint32_t IdBlockSize = 1024;
+
+  // Data
+  std::pmr::monotonic_buffer_resource d_resource;
+  std::vector<Finalizer> d_finalizers;
+  std::vector<std::unique_ptr<Arena>> d_forks;
+  std::mutex d_forksMutex;
+  Arena* d_pRoot; // hands out id blocks to forks
+  std::atomic<uint32_t> d_idsReserved; // only used by the root
+  uint32_t d_nextId;
+  uint32_t d_idsEnd;
+  size_t d_nodeCount;
+  size_t d_bytesUsed;
+
+public:
+  // Constructors
+  Arena();
+  Arena(Arena const&) = delete;
+  ~Arena();
+
+  // Methods
+  template<typename NodeT, typename... Args>
+  NodeT* make(Args&&... args)
+  {
+    void* const pMemory = allocate(sizeof(NodeT), alignof(NodeT));
+    d_nodeCount += 1;
+    auto* const pRes = new (pMemory) NodeT(std::forward<Args>(args)...);
+    if constexpr (std::is_base_of_v<Node, NodeT>)
+    {
+      pRes->d_id = nextId();
+    }
+    return pRes;
+  }
+
+  template<typename T>
+  std::span<T const> copy(std::vector<T> const& elements)
+  {
+    static_assert(std::is_trivially_destructible_v<T>);
+
+    if (elements.empty())
+    {
+      return {};
+    }
+    auto* const pRes = static_cast<T*>(allocate(elements.size() * sizeof(T), alignof(T)));
+    std::uninitialized_copy(elements.begin(), elements.end(), pRes);
+    return {pRes, elements.size()};
+  }
+
+  // runs object's destructor when the arena is destroyed
+  template<typename T>
+  void destroyWith(T* pObject)
+  {
+    d_finalizers.push_back({[](void* p) { static_cast<T*>(p)->~T(); }, pObject});
+  }
+
+  // A new arena destroyed together with this one, can be called from any thread
+  Arena& fork();
+
+  // including forks
+  size_t nodeCount() const;
+  size_t bytesUsed() const;
+
+  // Operators
+  Arena& operator=(Arena const&) = delete;
+
+private:
+  explicit Arena(Arena* pRoot);
+
+  void* allocate(size_t size, size_t alignment);
+  uint32_t nextId();
+};
+
+} // namespace ast
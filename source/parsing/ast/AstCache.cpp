@@ -0,0 +1,503 @@
+#include "parsing/ast/AstCache.h"
+
+#include <parsing/Error.h>
+#include <parsing/Intern.h>
+#include <parsing/ast/Nodes.h>
+#include <parsing/ast/Unflatten.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ast;
+
+namespace
+{
+
+constexpr char magic[4] = {'M', 'I', 'R', 'A'};
+
+// every array starts at a multiple of this
+constexpr size_t alignment = alignof(uint64_t);
+
+constexpr uint32_t invalidPosition = std::numeric_limits<uint32_t>::max();
+
+size_t align(size_t offset)
+{
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+uint32_t encode(size_t value)
+{
+  // Position::invalid() is the only position that does not fit
+  assert(value < invalidPosition || value == Position::invalid().line);
+  return value < invalidPosition ? static_cast<uint32_t>(value) : invalidPosition;
+}
+
+size_t decode(uint32_t value)
+{
+  return value != invalidPosition ? value : Position::invalid().line;
+}
+
+template<typename T>
+void writeRaw(std::ofstream& file, T const& value)
+{
+  file.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template<typename T>
+void writeArray(std::ofstream& file, T const* data, size_t count)
+{
+  file.write(reinterpret_cast<char const*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+
+  static constexpr char padding[alignment] = {};
+  size_t const size = count * sizeof(T);
+  file.write(padding, static_cast<std::streamsize>(align(size) - size));
+}
+
+// Interns the texts of the tokens so that the rebuilt nodes outlive the mapping
+struct Interned
+{
+  AstCache const& cache;
+
+  Node::Kind kind(AstCache::Index node) const { return cache.kind(node); }
+  Token mainToken(AstCache::Index node) const { return intern(cache.mainToken(node)); }
+  FlatTree::Data data(AstCache::Index node) const { return cache.data(node); }
+  AstCache::Index extra(AstCache::Index idx) const { return cache.extra(idx); }
+  std::span<AstCache::Index const> extra(AstCache::Index begin, AstCache::Index count) const { return cache.extra(begin, count); }
+  Token token(AstCache::Index idx) const { return intern(cache.token(idx)); }
+
+  std::optional<Token> label(AstCache::Index node) const { return intern(cache.label(node)); }
+  std::optional<Token> tokComptime(AstCache::Index node) const { return intern(cache.tokComptime(node)); }
+
+  static Token intern(Token token)
+  {
+    return Token(token.tag(), token.start(), token.end(), Intern::string(token.text().data(), token.text().size()));
+  }
+
+  static std::optional<Token> intern(std::optional<Token> token)
+  {
+    return token.has_value() ? std::optional(intern(*token)) : std::nullopt;
+  }
+};
+
+} // anonymous namespace
+
+AstCache::AstCache(std::string const& cachePath, std::string_view source)
+  : d_pMapping(nullptr)
+  , d_mappingSize(0)
+  , d_header()
+  , d_kinds(nullptr)
+  , d_mainTokens(nullptr)
+  , d_data(nullptr)
+  , d_extra(nullptr)
+  , d_tokens(nullptr)
+  , d_labels(nullptr)
+  , d_comptimeTokens(nullptr)
+  , d_strings(nullptr)
+  , d_text(nullptr)
+{
+  int const fd = ::open(cachePath.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw Error(cachePath, "cannot open ast cache");
+  }
+
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header))
+  {
+    ::close(fd);
+    throw Error(cachePath, "invalid ast cache");
+  }
+
+  d_mappingSize = static_cast<size_t>(info.st_size);
+  d_pMapping = ::mmap(nullptr, d_mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (d_pMapping == MAP_FAILED)
+  {
+    d_pMapping = nullptr;
+    throw Error(cachePath, "cannot map ast cache");
+  }
+
+  auto const* bytes = static_cast<char const*>(d_pMapping);
+  std::memcpy(&d_header, bytes, sizeof(Header));
+
+  bool const isHeaderValid =
+    std::memcmp(d_header.magic, magic, sizeof(magic)) == 0
+    && d_header.version == version
+    && d_header.nodeCount > 0
+    && d_header.textSize <= d_mappingSize
+    && layout(d_header).size == d_mappingSize;
+  if (!isHeaderValid)
+  {
+    ::munmap(d_pMapping, d_mappingSize);
+    d_pMapping = nullptr;
+    throw Error(cachePath, "invalid ast cache");
+  }
+  if (d_header.sourceSize != source.size() || d_header.sourceHash != hash(source))
+  {
+    ::munmap(d_pMapping, d_mappingSize);
+    d_pMapping = nullptr;
+    throw Error(cachePath, "ast cache was written from another source");
+  }
+
+  Layout const offsets = layout(d_header);
+  d_kinds = reinterpret_cast<Node::Kind const*>(bytes + offsets.kinds);
+  d_mainTokens = reinterpret_cast<Index const*>(bytes + offsets.mainTokens);
+  d_data = reinterpret_cast<FlatTree::Data const*>(bytes + offsets.data);
+  d_extra = reinterpret_cast<Index const*>(bytes + offsets.extra);
+  d_tokens = reinterpret_cast<TokenRecord const*>(bytes + offsets.tokens);
+  d_labels = reinterpret_cast<SideRecord const*>(bytes + offsets.labels);
+  d_comptimeTokens = reinterpret_cast<SideRecord const*>(bytes + offsets.comptimeTokens);
+  d_strings = reinterpret_cast<StringRecord const*>(bytes + offsets.strings);
+  d_text = bytes + offsets.text;
+
+  if (!isValid())
+  {
+    ::munmap(d_pMapping, d_mappingSize);
+    d_pMapping = nullptr;
+    throw Error(cachePath, "invalid ast cache");
+  }
+}
+
+AstCache::AstCache(AstCache&& other) noexcept
+  : d_pMapping(other.d_pMapping)
+  , d_mappingSize(other.d_mappingSize)
+  , d_header(other.d_header)
+  , d_kinds(other.d_kinds)
+  , d_mainTokens(other.d_mainTokens)
+  , d_data(other.d_data)
+  , d_extra(other.d_extra)
+  , d_tokens(other.d_tokens)
+  , d_labels(other.d_labels)
+  , d_comptimeTokens(other.d_comptimeTokens)
+  , d_strings(other.d_strings)
+  , d_text(other.d_text)
+{
+  other.d_pMapping = nullptr;
+}
+
+AstCache::~AstCache()
+{
+  if (d_pMapping != nullptr)
+  {
+    ::munmap(d_pMapping, d_mappingSize);
+  }
+}
+
+void AstCache::write(std::string const& cachePath, FlatTree const& tree, std::string_view source)
+{
+  assert(tree.size() > 0);
+
+  std::string text;
+  std::vector<StringRecord> strings;
+  std::unordered_map<std::string_view, uint32_t> stringIds;
+  std::vector<TokenRecord> tokens;
+  tokens.reserve(tree.d_tokens.size());
+
+  for (auto const& token : tree.d_tokens)
+  {
+    auto [it, isNew] = stringIds.try_emplace(token.text(), static_cast<uint32_t>(strings.size()));
+    if (isNew)
+    {
+      strings.push_back({static_cast<uint32_t>(text.size()), static_cast<uint32_t>(token.text().size())});
+      text += token.text();
+    }
+
+    tokens.push_back(TokenRecord{
+      static_cast<uint32_t>(token.tag()),
+      encode(token.start().line),
+      encode(token.start().column),
+      encode(token.end().line),
+      encode(token.end().column),
+      it->second});
+  }
+
+  auto const sideRecords = [](std::vector<std::pair<Index, Index>> const& table)
+  {
+    std::vector<SideRecord> res;
+    res.reserve(table.size());
+    for (auto const& [node, token] : table)
+    {
+      res.push_back({node, token});
+    }
+    return res;
+  };
+  auto const labels = sideRecords(tree.d_labels);
+  auto const comptimeTokens = sideRecords(tree.d_comptimeTokens);
+
+  Header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.nodeCount = static_cast<uint32_t>(tree.d_kinds.size());
+  header.extraCount = static_cast<uint32_t>(tree.d_extra.size());
+  header.tokenCount = static_cast<uint32_t>(tokens.size());
+  header.labelCount = static_cast<uint32_t>(labels.size());
+  header.comptimeCount = static_cast<uint32_t>(comptimeTokens.size());
+  header.stringCount = static_cast<uint32_t>(strings.size());
+  header.textSize = text.size();
+  header.sourceSize = source.size();
+  header.sourceHash = hash(source);
+
+  auto file = std::ofstream(cachePath, std::ios::out | std::ios::binary | std::ios::trunc);
+  writeRaw(file, header);
+  writeArray(file, tree.d_kinds.data(), tree.d_kinds.size());
+  writeArray(file, tree.d_mainTokens.data(), tree.d_mainTokens.size());
+  writeArray(file, tree.d_data.data(), tree.d_data.size());
+  writeArray(file, tree.d_extra.data(), tree.d_extra.size());
+  writeArray(file, tokens.data(), tokens.size());
+  writeArray(file, labels.data(), labels.size());
+  writeArray(file, comptimeTokens.data(), comptimeTokens.size());
+  writeArray(file, strings.data(), strings.size());
+  file.write(text.data(), static_cast<std::streamsize>(text.size()));
+
+  if (!file)
+  {
+    throw Error(cachePath, "cannot write ast cache");
+  }
+}
+
+Token AstCache::token(Index idx) const
+{
+  TokenRecord const& record = d_tokens[idx];
+  StringRecord const& string = d_strings[record.string];
+
+  return Token(
+    static_cast<Token::Tag>(record.tag),
+    Position(decode(record.startLine), decode(record.startColumn)),
+    Position(decode(record.endLine), decode(record.endColumn)),
+    std::string_view(d_text + string.offset, string.length));
+}
+
+std::optional<Token> AstCache::label(Index node) const
+{
+  return find(d_labels, d_header.labelCount, node);
+}
+
+std::optional<Token> AstCache::tokComptime(Index node) const
+{
+  return find(d_comptimeTokens, d_header.comptimeCount, node);
+}
+
+Node::Ptr AstCache::toNode(Arena& arena) const
+{
+  return unflatten(Interned{*this}, arena, 0);
+}
+
+AstCache::Layout AstCache::layout(Header const& header)
+{
+  Layout res;
+  size_t offset = align(sizeof(Header));
+
+  auto const next = [&offset](size_t bytes)
+  {
+    size_t const res = offset;
+    offset = align(offset + bytes);
+    return res;
+  };
+
+  res.kinds = next(header.nodeCount * sizeof(Node::Kind));
+  res.mainTokens = next(header.nodeCount * sizeof(Index));
+  res.data = next(header.nodeCount * sizeof(FlatTree::Data));
+  res.extra = next(header.extraCount * sizeof(Index));
+  res.tokens = next(header.tokenCount * sizeof(TokenRecord));
+  res.labels = next(header.labelCount * sizeof(SideRecord));
+  res.comptimeTokens = next(header.comptimeCount * sizeof(SideRecord));
+  res.strings = next(header.stringCount * sizeof(StringRecord));
+  res.text = offset;
+  res.size = offset + header.textSize;
+  return res;
+}
+
+Hash AstCache::hash(std::string_view source)
+{
+  Hasher hasher;
+  hasher.add(source);
+  return hasher.finish();
+}
+
+bool AstCache::isValid() const
+{
+  size_t const
+    nodeCount = d_header.nodeCount,
+    extraCount = d_header.extraCount,
+    tokenCount = d_header.tokenCount;
+
+  for (size_t i = 0; i < d_header.stringCount; ++i)
+  {
+    if (static_cast<uint64_t>(d_strings[i].offset) + d_strings[i].length > d_header.textSize)
+    {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < tokenCount; ++i)
+  {
+    // tokens do not span lines
+    TokenRecord const& record = d_tokens[i];
+    if (record.tag > static_cast<uint32_t>(Token::Eof)
+      || record.string >= d_header.stringCount
+      || record.startLine != record.endLine
+      || record.startColumn > record.endColumn)
+    {
+      return false;
+    }
+  }
+
+  auto const isSideTableValid = [&](SideRecord const* table, size_t count)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      // sorted for find()
+      if (table[i].node >= nodeCount || table[i].token >= tokenCount || (i > 0 && table[i - 1].node >= table[i].node))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (!isSideTableValid(d_labels, d_header.labelCount) || !isSideTableValid(d_comptimeTokens, d_header.comptimeCount))
+  {
+    return false;
+  }
+
+  // children come after their parent, which also rules out cycles
+  for (size_t node = 0; node < nodeCount; ++node)
+  {
+    auto const isChild = [&](size_t child)
+    {
+      return child > node && child < nodeCount;
+    };
+    auto const isChildOf = [&](size_t child, Node::Kind kind)
+    {
+      return isChild(child) && d_kinds[child] == kind;
+    };
+    auto const isOptional = [&](size_t child)
+    {
+      return child == FlatTree::Null || isChild(child);
+    };
+    auto const isExtra = [&](size_t begin, size_t count)
+    {
+      return begin <= extraCount && count <= extraCount - begin;
+    };
+    auto const areChildrenOf = [&](size_t begin, size_t count, std::optional<Node::Kind> kind)
+    {
+      if (!isExtra(begin, count))
+      {
+        return false;
+      }
+      return std::all_of(d_extra + begin, d_extra + begin + count, [&](Index child)
+      {
+        return kind.has_value() ? isChildOf(child, *kind) : isChild(child);
+      });
+    };
+
+    FlatTree::Data const data = d_data[node];
+    size_t const lhs = data.lhs, rhs = data.rhs;
+    if (d_mainTokens[node] >= tokenCount)
+    {
+      return false;
+    }
+
+    bool isNodeValid = true;
+    switch (d_kinds[node])
+    {
+    case Node::Kind::TypeExpression:
+      isNodeValid = isExtra(lhs, 4)
+        && d_extra[lhs] < tokenCount
+        && areChildrenOf(lhs + 4, d_extra[lhs + 2], Node::Kind::LetStatement)
+        && areChildrenOf(lhs + 4 + d_extra[lhs + 2], d_extra[lhs + 1], Node::Kind::Part)
+        && areChildrenOf(lhs + 4 + static_cast<size_t>(d_extra[lhs + 2]) + d_extra[lhs + 1], d_extra[lhs + 3], Node::Kind::LetStatement)
+        && isOptional(rhs);
+      break;
+    case Node::Kind::FunctionExpression:
+      isNodeValid = isExtra(lhs, 2)
+        && isChild(d_extra[lhs])
+        && areChildrenOf(lhs + 2, d_extra[lhs + 1], Node::Kind::Part)
+        && (rhs == FlatTree::Null || isChildOf(rhs, Node::Kind::BlockExpression));
+      break;
+    case Node::Kind::LetStatement:
+      isNodeValid = isExtra(lhs, 1) && areChildrenOf(lhs + 1, d_extra[lhs], Node::Kind::Part);
+      break;
+    case Node::Kind::Part:
+      isNodeValid = isChild(lhs) && isExtra(rhs, 2) && isOptional(d_extra[rhs]) && isOptional(d_extra[rhs + 1]);
+      break;
+    case Node::Kind::SwitchExpression:
+      isNodeValid = isChild(lhs) && isExtra(rhs, 2) && d_extra[rhs] < tokenCount && isExtra(rhs + 2, 3 * static_cast<size_t>(d_extra[rhs + 1]));
+      for (size_t i = rhs + 2; isNodeValid && i < rhs + 2 + 3 * static_cast<size_t>(d_extra[rhs + 1]); i += 3)
+      {
+        isNodeValid = isChild(d_extra[i]) && isOptional(d_extra[i + 1]) && isChild(d_extra[i + 2]);
+      }
+      break;
+    case Node::Kind::ReturnStatement:
+    case Node::Kind::BreakStatement:
+      isNodeValid = isOptional(lhs);
+      break;
+    case Node::Kind::DeferStatement:
+      isNodeValid = isChild(lhs);
+      break;
+    case Node::Kind::BlockExpression:
+      isNodeValid = isExtra(lhs, 2) && d_extra[lhs] < tokenCount && areChildrenOf(lhs + 2, d_extra[lhs + 1], std::nullopt);
+      break;
+    case Node::Kind::IfExpression:
+      isNodeValid = isExtra(lhs, 1) && d_extra[lhs] > 0 && isExtra(lhs + 1, 5 * static_cast<size_t>(d_extra[lhs]));
+      for (size_t i = lhs + 1; isNodeValid && i < lhs + 1 + 5 * static_cast<size_t>(d_extra[lhs]); i += 5)
+      {
+        isNodeValid = d_extra[i] <= static_cast<Index>(IfExpression::Clause::Else)
+          && d_extra[i + 1] < tokenCount
+          && isOptional(d_extra[i + 2])
+          && isOptional(d_extra[i + 3])
+          && isChildOf(d_extra[i + 4], Node::Kind::BlockExpression);
+      }
+      break;
+    case Node::Kind::LoopExpression:
+      isNodeValid = isChild(lhs)
+        && isExtra(rhs, 5)
+        && isOptional(d_extra[rhs])
+        && isChildOf(d_extra[rhs + 1], Node::Kind::BlockExpression)
+        && d_extra[rhs + 2] < tokenCount
+        && isOptional(d_extra[rhs + 3])
+        && (d_extra[rhs + 4] == FlatTree::Null || isChildOf(d_extra[rhs + 4], Node::Kind::BlockExpression));
+      break;
+    case Node::Kind::ContinueStatement:
+    case Node::Kind::SymbolExpression:
+    case Node::Kind::BuiltinExpression:
+    case Node::Kind::StringExpression:
+    case Node::Kind::NumberExpression:
+    case Node::Kind::BoolExpression:
+    case Node::Kind::NullExpression:
+    case Node::Kind::UndefinedExpression:
+    case Node::Kind::UnreachableExpression:
+      break;
+    default:
+      // printing only kinds and values that are not kinds at all
+      isNodeValid = false;
+      break;
+    }
+    if (!isNodeValid)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<Token> AstCache::find(SideRecord const* table, size_t count, Index node) const
+{
+  auto const it = std::lower_bound(table, table + count, node, [](SideRecord const& record, Index value)
+  {
+    return record.node < value;
+  });
+  if (it == table + count || it->node != node)
+  {
+    return std::nullopt;
+  }
+  return token(it->token);
+}
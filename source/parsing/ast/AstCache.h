@@ -0,0 +1,146 @@
+#pragma once
+
+#include <parsing/Token.h>
+#include <parsing/ast/FlatTree.h>
+#include <parsing/ast/Hash.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace ast
+{
+
+// A FlatTree written to disk by AstCache::write() and read back in place.
+// The file is memory mapped and its arrays are used as they are, nothing
+// is copied or allocated per node. Token texts are deduplicated into a
+// string table.
+//
+// The accessors mirror the ones of FlatTree, tokens returned by them point
+// into the mapping and must not outlive the cache. toNode() interns the
+// texts so the rebuilt tree does not depend on the cache.
+//
+// Opening is not constant time: the source is hashed to check that the
+// cache was written from it, and every index and string range is checked
+// once so the accessors need no checks. Both are linear scans, far cheaper
+// than lexing and parsing the source again.
+struct AstCache final
+{
+public:
+  // Types
+  using Index = FlatTree::Index;
+
+private:
+  struct Header
+  {
+    char magic[4];
+    uint32_t version;
+    uint32_t nodeCount;
+    uint32_t extraCount;
+    uint32_t tokenCount;
+    uint32_t labelCount;
+    uint32_t comptimeCount;
+    uint32_t stringCount;
+    uint64_t textSize;
+    uint64_t sourceSize;
+    Hash sourceHash;
+  };
+
+  struct TokenRecord
+  {
+    uint32_t tag;
+    uint32_t startLine;
+    uint32_t startColumn;
+    uint32_t endLine;
+    uint32_t endColumn;
+    uint32_t string;
+  };
+
+  struct StringRecord
+  {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  struct SideRecord
+  {
+    Index node;
+    Index token;
+  };
+
+  // byte offsets of the arrays in file order and the file size
+  struct Layout
+  {
+    size_t kinds;
+    size_t mainTokens;
+    size_t data;
+    size_t extra;
+    size_t tokens;
+    size_t labels;
+    size_t comptimeTokens;
+    size_t strings;
+    size_t text;
+    size_t size;
+  };
+
+  static constexpr uint32_t version = 2;
+
+  // Data
+  void* d_pMapping;
+  size_t d_mappingSize;
+  Header d_header;
+  Node::Kind const* d_kinds;
+  Index const* d_mainTokens;
+  FlatTree::Data const* d_data;
+  Index const* d_extra;
+  TokenRecord const* d_tokens;
+  SideRecord const* d_labels;
+  SideRecord const* d_comptimeTokens;
+  StringRecord const* d_strings;
+  char const* d_text;
+
+public:
+  // Constructors
+  // Throws if the cache was not written from source
+  AstCache(std::string const& cachePath, std::string_view source);
+  AstCache(AstCache&& other) noexcept;
+  AstCache(AstCache const&) = delete;
+  ~AstCache();
+
+  // Methods
+  // tree must have been parsed from source
+  static void write(std::string const& cachePath, FlatTree const& tree, std::string_view source);
+
+  size_t size() const { return d_header.nodeCount; }
+  std::span<Node::Kind const> kinds() const { return {d_kinds, d_header.nodeCount}; }
+
+  Node::Kind kind(Index node) const { return d_kinds[node]; }
+  Token mainToken(Index node) const { return token(d_mainTokens[node]); }
+  FlatTree::Data data(Index node) const { return d_data[node]; }
+  Index extra(Index idx) const { return d_extra[idx]; }
+  std::span<Index const> extra(Index begin, Index count) const { return {d_extra + begin, count}; }
+  Token token(Index idx) const;
+
+  std::optional<Token> label(Index node) const;
+  std::optional<Token> tokComptime(Index node) const;
+
+  // Rebuilds the pointer based tree, equal to the one the cache was written from
+  Node::Ptr toNode(Arena& arena) const;
+
+  // Operators
+  AstCache& operator=(AstCache const&) = delete;
+  AstCache& operator=(AstCache&&) = delete;
+
+private:
+  static Layout layout(Header const& header);
+  static Hash hash(std::string_view source);
+
+  // Checks every index and string range against the sizes in the header
+  bool isValid() const;
+
+  std::optional<Token> find(SideRecord const* table, size_t count, Index node) const;
+};
+
+} // namespace ast
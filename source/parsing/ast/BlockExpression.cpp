@@ -6,27 +6,31 @@
 using namespace ast;
 
 void BlockExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
-  *subNodes = statements();
+  subNodes->assign(statements().begin(), statements().end());
   *nodeName = "BlockExpression";
   *additionalInfo = isLabeled() ? fmt::format(fmt::emphasis::italic, "{}", label().text()) : "";
 }
 
-BlockExpression::SPtr BlockExpression::make_shared(
+void BlockExpression::shiftData(PositionShift const& shift)
+{
+  LabeledNode::shiftData(shift);
+  d_start = shift(d_start);
+  d_end = shift(d_end);
+}
+
+BlockExpression::Ptr BlockExpression::make(
+  Arena& arena,
   Position start,
   Position end,
-  std::vector<Node::SPtr>&& statements,
-  Node::SPtr pParent)
+  std::vector<Node::Ptr> const& statements)
 {
-  auto pRes = std::make_shared<BlockExpression>(
-    start, end, std::move(statements), pParent);
-
-  for (auto pStatement : pRes->d_statements)
-  {
-    pStatement->setParent(pRes);
-  }
+  auto pRes = arena.make<BlockExpression>(
+    start, end, arena.copy(statements));
+  pRes->rehash();
   return pRes;
 }
\ No newline at end of file
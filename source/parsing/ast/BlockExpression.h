@@ -8,28 +8,31 @@ namespace ast
 struct BlockExpression final : public LabeledNode
 {
   PTR(BlockExpression)
+  KIND(BlockExpression)
 
 private:
   Position d_start;
   Position d_end;
-  std::vector<Node::SPtr> d_statements;
+  std::span<Node::Ptr const> d_statements;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override;
 
 public:
   BlockExpression(
     Position start,
     Position end,
-    std::vector<Node::SPtr>&& statements,
-    Node::SPtr pParent = nullptr)
-    : LabeledNode(pParent)
+    std::span<Node::Ptr const> statements)
+    : LabeledNode(Kind::BlockExpression)
     , d_start(start)
     , d_end(end)
-    , d_statements(std::move(statements))
+    , d_statements(statements)
   {}
 
   virtual Position start() const override { return d_start; }
@@ -38,13 +41,13 @@ public:
   // TODO check for break statements
   virtual bool isExpression() const override { return true; }
 
-  std::vector<Node::SPtr> const& statements() const { return d_statements; }
+  std::span<Node::Ptr const> statements() const { return d_statements; }
 
-  static BlockExpression::SPtr make_shared(
+  static BlockExpression::Ptr make(
+    Arena& arena,
     Position start,
     Position end,
-    std::vector<Node::SPtr>&& statements,
-    Node::SPtr pParent = nullptr);
+    std::vector<Node::Ptr> const& statements);
 };
 
 } // namespace ast
\ No newline at end of file
@@ -6,9 +6,10 @@
 using namespace ast;
 
 void BreakStatement::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   if (value() != nullptr)
@@ -34,17 +35,23 @@ Position BreakStatement::end() const
   return d_tokBreak.end();
 }
 
-BreakStatement::SPtr BreakStatement::make_shared(
+void BreakStatement::shiftData(PositionShift const& shift)
+{
+  d_tokBreak.shift(shift);
+  if (isLabeled())
+  {
+    d_tokLabel.shift(shift);
+  }
+}
+
+BreakStatement::Ptr BreakStatement::make(
+  Arena& arena,
   Token _break,
   bool isLabeled,
   Token label,
-  Node::SPtr pValue,
-  Node::SPtr pParent)
+  Node::Ptr pValue)
 {
-  auto pRes = std::make_shared<BreakStatement>(_break, isLabeled, label, pValue, pParent);
-  if (pValue != nullptr)
-  {
-    pValue->setParent(pRes);
-  }
+  auto pRes = arena.make<BreakStatement>(_break, isLabeled, label, pValue);
+  pRes->rehash();
   return pRes;
 }
\ No newline at end of file
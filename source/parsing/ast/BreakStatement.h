@@ -8,48 +8,55 @@ namespace ast
 struct BreakStatement final : public Node
 {
   PTR(BreakStatement)
+  KIND(BreakStatement)
 
 private:
-  Token d_tokBreak;
-  bool d_isLabeled;
-  Token d_tokLabel;
-  Node::SPtr d_pValue;
+  CompactToken d_tokBreak;
+  CompactToken d_tokLabel;
+  Node::Ptr d_pValue;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override;
 
 public:
   BreakStatement(
     Token _break,
     bool isLabeled,
     Token label,
-    Node::SPtr pValue,
-    Node::SPtr pParent = nullptr)
-    : Node(pParent)
+    Node::Ptr pValue)
+    : Node(Kind::BreakStatement)
     , d_tokBreak(_break)
-    , d_isLabeled(isLabeled)
     , d_tokLabel(label)
     , d_pValue(pValue)
-  {}
+  {
+    if (isLabeled)
+    {
+      d_flags |= Labeled;
+    }
+  }
 
   virtual Position start() const override { return d_tokBreak.start(); }
   virtual Position end() const override;
 
   virtual bool isExpression() const override { return false; }
 
-  bool isLabeled() const { return d_isLabeled; }
+  Token tokBreak() const { return d_tokBreak; }
+  bool isLabeled() const { return (d_flags & Labeled) != 0; }
   Token label() const { return d_tokLabel; }
-  Node::SPtr value() const { return d_pValue; }
+  Node::Ptr value() const { return d_pValue; }
 
-  static BreakStatement::SPtr make_shared(
+  static BreakStatement::Ptr make(
+    Arena& arena,
     Token _break,
     bool isLabeled,
     Token label,
-    Node::SPtr pValue,
-    Node::SPtr pParent = nullptr);
+    Node::Ptr pValue);
 };
 
 } // namespace ast
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <parsing/Token.h>
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+namespace ast
+{
+
+// A position in 8 instead of 16 bytes, Position::invalid() is kept as the
+// largest 32 bit line and column
+struct CompactPosition final
+{
+  // Data
+  uint32_t line;
+  uint32_t column;
+
+  // Constructors
+  constexpr CompactPosition() noexcept
+    : line(0), column(0)
+  {}
+
+  constexpr CompactPosition(Position position) noexcept
+    : line(narrow(position.line)), column(narrow(position.column))
+  {}
+
+  // Methods
+  constexpr Position position() const noexcept { return {widen(line), widen(column)}; }
+
+private:
+  static constexpr uint32_t narrow(size_t value) noexcept
+  {
+    if (value == std::numeric_limits<size_t>::max())
+    {
+      return std::numeric_limits<uint32_t>::max();
+    }
+    assert(value < std::numeric_limits<uint32_t>::max());
+    return static_cast<uint32_t>(value);
+  }
+
+  static constexpr size_t widen(uint32_t value) noexcept
+  {
+    if (value == std::numeric_limits<uint32_t>::max())
+    {
+      return std::numeric_limits<size_t>::max();
+    }
+    return value;
+  }
+};
+
+// A token as stored inside nodes, 32 instead of 56 bytes. The text, which
+// is interned, is kept as a pointer and a length. Converts to and from Token.
+struct CompactToken final
+{
+private:
+  // Data
+  char const* d_pText;
+  uint32_t d_length;
+  CompactPosition d_start;
+  CompactPosition d_end;
+  uint8_t d_tag;
+
+public:
+  // Constructors
+  CompactToken() noexcept
+    : CompactToken(Token())
+  {}
+
+  CompactToken(Token const& token) noexcept
+    : d_pText(token.text().data())
+    , d_length(static_cast<uint32_t>(token.text().size()))
+    , d_start(token.start())
+    , d_end(token.end())
+    , d_tag(static_cast<uint8_t>(token.tag()))
+  {}
+
+  // Methods
+  Token::Tag tag() const noexcept { return static_cast<Token::Tag>(d_tag); }
+  Position start() const noexcept { return d_start.position(); }
+  Position end() const noexcept { return d_end.position(); }
+  std::string_view text() const noexcept { return {d_pText, d_length}; }
+
+  Token token() const noexcept { return Token(tag(), start(), end(), text()); }
+
+  void shift(PositionShift const& shift) noexcept
+  {
+    d_start = shift(start());
+    d_end = shift(end());
+  }
+
+  // Operators
+  operator Token() const noexcept { return token(); }
+};
+
+static_assert(sizeof(CompactPosition) == 8);
+static_assert(sizeof(CompactToken) == 32);
+
+} // namespace ast
@@ -6,9 +6,10 @@
 using namespace ast;
 
 void ContinueStatement::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
 
@@ -24,4 +25,13 @@ Position ContinueStatement::end() const
     return label().end();
   }
   return d_tokContinue.end();
+}
+
+void ContinueStatement::shiftData(PositionShift const& shift)
+{
+  d_tokContinue.shift(shift);
+  if (isLabeled())
+  {
+    d_tokLabel.shift(shift);
+  }
 }
\ No newline at end of file
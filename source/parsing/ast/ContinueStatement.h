@@ -8,36 +8,43 @@ namespace ast
 struct ContinueStatement final : public Node
 {
   PTR(ContinueStatement)
+  KIND(ContinueStatement)
 
 private:
-  Token d_tokContinue;
-  bool d_isLabeled;
-  Token d_tokLabel;
+  CompactToken d_tokContinue;
+  CompactToken d_tokLabel;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override;
 
 public:
   ContinueStatement(
     Token _continue,
     bool isLabeled,
-    Token label,
-    Node::SPtr pParent = nullptr)
-    : Node(pParent)
+    Token label)
+    : Node(Kind::ContinueStatement)
     , d_tokContinue(_continue)
-    , d_isLabeled(isLabeled)
     , d_tokLabel(label)
-  {}
+  {
+    if (isLabeled)
+    {
+      d_flags |= Labeled;
+    }
+  }
 
   virtual Position start() const override { return d_tokContinue.start(); }
   virtual Position end() const override;
 
   virtual bool isExpression() const override { return false; }
 
-  bool isLabeled() const { return d_isLabeled; }
+  Token tokContinue() const { return d_tokContinue; }
+  bool isLabeled() const { return (d_flags & Labeled) != 0; }
   Token label() const { return d_tokLabel; }
 };
 
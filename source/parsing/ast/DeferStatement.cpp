@@ -3,9 +3,10 @@
 using namespace ast;
 
 void DeferStatement::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   subNodes->push_back(target());
@@ -15,12 +16,12 @@ void DeferStatement::toStringData(
   *additionalInfo = "";
 }
 
-DeferStatement::SPtr DeferStatement::make_shared(
+DeferStatement::Ptr DeferStatement::make(
+  Arena& arena,
   Token defer,
-  Node::SPtr pTarget,
-  Node::SPtr pParent)
+  Node::Ptr pTarget)
 {
-  auto pRes = std::make_shared<DeferStatement>(defer, pTarget, pParent);
-  pTarget->setParent(pRes);
+  auto pRes = arena.make<DeferStatement>(defer, pTarget);
+  pRes->rehash();
   return pRes;
 }
\ No newline at end of file
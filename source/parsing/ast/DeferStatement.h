@@ -8,23 +8,26 @@ namespace ast
 struct DeferStatement final : public Node
 {
   PTR(DeferStatement)
+  KIND(DeferStatement)
 
 private:
-  Token d_tokDefer;
-  Node::SPtr d_pTarget;
+  CompactToken d_tokDefer;
+  Node::Ptr d_pTarget;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override { d_tokDefer.shift(shift); }
 
 public:
   DeferStatement(
     Token defer,
-    Node::SPtr pTarget,
-    Node::SPtr pParent = nullptr)
-    : Node(pParent)
+    Node::Ptr pTarget)
+    : Node(Kind::DeferStatement)
     , d_tokDefer(defer)
     , d_pTarget(pTarget)
   {}
@@ -34,12 +37,13 @@ public:
 
   virtual bool isExpression() const override { return false; }
 
-  Node::SPtr target() const { return d_pTarget; }
+  Token tokDefer() const { return d_tokDefer; }
+  Node::Ptr target() const { return d_pTarget; }
 
-  static DeferStatement::SPtr make_shared(
+  static DeferStatement::Ptr make(
+    Arena& arena,
     Token defer,
-    Node::SPtr pTarget,
-    Node::SPtr pParent = nullptr);
+    Node::Ptr pTarget);
 };
 
 } // namespace ast
\ No newline at end of file
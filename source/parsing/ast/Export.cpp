@@ -0,0 +1,390 @@
+#include "parsing/ast/Export.h"
+
+#include <parsing/ast/Nodes.h>
+#include <parsing/ast/Walker.h>
+#include <Utils.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+using namespace ast;
+
+namespace
+{
+
+// buffered output is written to the file whenever it grows past this
+constexpr size_t flushSize = 64 * 1024;
+
+char const* kindName(Node::Kind kind)
+{
+  switch (kind)
+  {
+  case Node::Kind::TypeExpression: return "TypeExpression";
+  case Node::Kind::FunctionExpression: return "FunctionExpression";
+  case Node::Kind::LetStatement: return "LetStatement";
+  case Node::Kind::Part: return "Part";
+  case Node::Kind::SwitchExpression: return "SwitchExpression";
+  case Node::Kind::ReturnStatement: return "ReturnStatement";
+  case Node::Kind::BreakStatement: return "BreakStatement";
+  case Node::Kind::ContinueStatement: return "ContinueStatement";
+  case Node::Kind::DeferStatement: return "DeferStatement";
+  case Node::Kind::BlockExpression: return "BlockExpression";
+  case Node::Kind::IfExpression: return "IfExpression";
+  case Node::Kind::LoopExpression: return "LoopExpression";
+  case Node::Kind::SymbolExpression: return "SymbolExpression";
+  case Node::Kind::BuiltinExpression: return "BuiltinExpression";
+  case Node::Kind::StringExpression: return "StringExpression";
+  case Node::Kind::NumberExpression: return "NumberExpression";
+  case Node::Kind::BoolExpression: return "BoolExpression";
+  case Node::Kind::NullExpression: return "NullExpression";
+  case Node::Kind::UndefinedExpression: return "UndefinedExpression";
+  case Node::Kind::UnreachableExpression: return "UnreachableExpression";
+  case Node::Kind::Clause: return "Clause";
+  case Node::Kind::Case: return "Case";
+  }
+  return "";
+}
+
+struct Writer final
+{
+private:
+  // Types
+  struct Frame
+  {
+    Node::Ptr pNode;
+    char const* field;
+    bool isExit;
+  };
+
+  // Data
+  ExportFormat d_format;
+  std::span<size_t const> d_lineStarts;
+  size_t d_firstLine; // of d_lineStarts[0]
+  fmt::memory_buffer& d_out;
+  std::FILE* d_pFile;
+  std::vector<Frame> d_stack;
+  // one entry per node being written, set once it wrote a child
+  std::vector<bool> d_hasChildren;
+
+public:
+  // Constructors
+  Writer(
+    ExportFormat format,
+    std::span<size_t const> lineStarts,
+    size_t firstLine,
+    fmt::memory_buffer& out,
+    std::FILE* pFile)
+    : d_format(format)
+    , d_lineStarts(lineStarts)
+    , d_firstLine(firstLine)
+    , d_out(out)
+    , d_pFile(pFile)
+  {}
+
+  // Methods
+  void write(Node::Ptr pRoot)
+  {
+    d_stack.push_back({pRoot, nullptr, false});
+    while (!d_stack.empty())
+    {
+      Frame const frame = d_stack.back();
+      d_stack.pop_back();
+
+      if (frame.isExit)
+      {
+        close();
+        continue;
+      }
+
+      open(frame.pNode, frame.field);
+      d_stack.push_back({frame.pNode, nullptr, true});
+
+      // pushed in reverse so that they are popped in source order
+      size_t const first = d_stack.size();
+      forEachChild(frame.pNode, [&](char const* field, Node::Ptr pChild)
+      {
+        d_stack.push_back({pChild, field, false});
+      });
+      std::reverse(d_stack.begin() + static_cast<std::ptrdiff_t>(first), d_stack.end());
+
+      flushIfLarge();
+    }
+    raw("\n");
+    flush();
+  }
+
+private:
+  bool isJson() const { return d_format == ExportFormat::Json; }
+
+  void raw(std::string_view text)
+  {
+    d_out.append(text.data(), text.data() + text.size());
+  }
+
+  void open(Node::Ptr pNode, char const* field)
+  {
+    if (!d_hasChildren.empty())
+    {
+      if (isJson())
+      {
+        raw(d_hasChildren.back() ? "," : ",\"children\":[");
+      }
+      else
+      {
+        raw(" ");
+      }
+      d_hasChildren.back() = true;
+    }
+    d_hasChildren.push_back(false);
+
+    raw(isJson() ? "{\"kind\":\"" : "(");
+    raw(kindName(pNode->kind()));
+    raw(isJson() ? "\"" : "");
+
+    if (field != nullptr)
+    {
+      attribute("field");
+      string(field);
+    }
+
+    attribute("start");
+    position(pNode->start());
+    attribute("end");
+    position(pNode->end());
+    if (!d_lineStarts.empty())
+    {
+      attribute("range");
+      range(pNode->start(), pNode->end());
+    }
+
+    if (pNode->isComptime())
+    {
+      attribute("comptime");
+      raw("true");
+    }
+    details(pNode);
+  }
+
+  void close()
+  {
+    if (isJson())
+    {
+      raw(d_hasChildren.back() ? "]}" : "}");
+    }
+    else
+    {
+      raw(")");
+    }
+    d_hasChildren.pop_back();
+  }
+
+  // attributes of the concrete kind, flags only if set
+  void details(Node::Ptr pNode)
+  {
+    switch (pNode->kind())
+    {
+    case Node::Kind::TypeExpression:
+    {
+      static constexpr char const* tags[] = {"struct", "enum", "union"};
+      attribute("tag");
+      string(tags[pNode->as<TypeExpression>()->tag()]);
+      break;
+    }
+    case Node::Kind::LetStatement:
+    {
+      auto const pLet = pNode->as<LetStatement>();
+      flag("pub", pLet->isPub());
+      flag("mut", pLet->isMut());
+      break;
+    }
+    case Node::Kind::Part:
+    {
+      static constexpr char const* roles[] = {"declaration", "field", "variant", "parameter"};
+      attribute("role");
+      string(roles[pNode->as<Part>()->role()]);
+      break;
+    }
+    case Node::Kind::BreakStatement:
+    {
+      auto const pBreak = pNode->as<BreakStatement>();
+      if (pBreak->isLabeled())
+      {
+        attribute("label");
+        string(pBreak->label().text());
+      }
+      break;
+    }
+    case Node::Kind::ContinueStatement:
+    {
+      auto const pContinue = pNode->as<ContinueStatement>();
+      if (pContinue->isLabeled())
+      {
+        attribute("label");
+        string(pContinue->label().text());
+      }
+      break;
+    }
+    case Node::Kind::IfExpression:
+    {
+      static constexpr char const* tags[] = {"if", "else if", "else"};
+      attribute("clauses");
+      raw(isJson() ? "[" : "(");
+      bool first = true;
+      for (auto const& clause : pNode->as<IfExpression>()->clauses())
+      {
+        raw(first ? "" : isJson() ? "," : " ");
+        string(tags[clause.tag]);
+        first = false;
+      }
+      raw(isJson() ? "]" : ")");
+      [[fallthrough]];
+    }
+    case Node::Kind::BlockExpression:
+    case Node::Kind::LoopExpression:
+    {
+      auto const pLabeled = pNode->as<LabeledNode>();
+      if (pLabeled->isLabeled())
+      {
+        attribute("label");
+        string(pLabeled->labelName());
+      }
+      break;
+    }
+    case Node::Kind::SymbolExpression:
+    case Node::Kind::BuiltinExpression:
+    case Node::Kind::StringExpression:
+    case Node::Kind::NumberExpression:
+    case Node::Kind::BoolExpression:
+    case Node::Kind::NullExpression:
+    case Node::Kind::UndefinedExpression:
+    case Node::Kind::UnreachableExpression:
+      attribute("text");
+      string(pNode->as<TokenExpression>()->token().text());
+      break;
+    case Node::Kind::FunctionExpression:
+    case Node::Kind::SwitchExpression:
+    case Node::Kind::ReturnStatement:
+    case Node::Kind::DeferStatement:
+    case Node::Kind::Clause:
+    case Node::Kind::Case:
+      break;
+    }
+  }
+
+  void attribute(std::string_view name)
+  {
+    raw(isJson() ? ",\"" : " :");
+    raw(name);
+    raw(isJson() ? "\":" : " ");
+  }
+
+  void flag(std::string_view name, bool value)
+  {
+    if (value)
+    {
+      attribute(name);
+      raw("true");
+    }
+  }
+
+  void pair(size_t first, size_t second)
+  {
+    if (isJson())
+    {
+      fmt::format_to(std::back_inserter(d_out), "[{},{}]", first, second);
+    }
+    else
+    {
+      fmt::format_to(std::back_inserter(d_out), "({} {})", first, second);
+    }
+  }
+
+  void null()
+  {
+    raw(isJson() ? "null" : "nil");
+  }
+
+  void position(Position position)
+  {
+    if (!position.isValid())
+    {
+      null();
+      return;
+    }
+    pair(position.line, position.column);
+  }
+
+  void range(Position start, Position end)
+  {
+    if (!start.isValid() || !end.isValid()
+      || start.line < d_firstLine || end.line < d_firstLine
+      || start.line - d_firstLine >= d_lineStarts.size() || end.line - d_firstLine >= d_lineStarts.size())
+    {
+      null();
+      return;
+    }
+    pair(
+      d_lineStarts[start.line - d_firstLine] + start.column,
+      d_lineStarts[end.line - d_firstLine] + end.column);
+  }
+
+  // quoted, escaped the way JSON requires which s-expression readers accept
+  void string(std::string_view text)
+  {
+    appendJsonString(d_out, text);
+  }
+
+  void flushIfLarge()
+  {
+    if (d_out.size() >= flushSize)
+    {
+      flush();
+    }
+  }
+
+  void flush()
+  {
+    if (d_pFile != nullptr)
+    {
+      std::fwrite(d_out.data(), 1, d_out.size(), d_pFile);
+      d_out.clear();
+    }
+  }
+};
+
+} // anonymous namespace
+
+std::optional<ExportFormat> ast::exportFormat(std::string_view name)
+{
+  if (name == "json")
+  {
+    return ExportFormat::Json;
+  }
+  if (name == "sexpr")
+  {
+    return ExportFormat::Sexpr;
+  }
+  return std::nullopt;
+}
+
+void ast::exportTree(
+  Node::Ptr pRoot,
+  ExportFormat format,
+  std::span<size_t const> lineStarts,
+  fmt::memory_buffer& out,
+  size_t firstLine)
+{
+  Writer(format, lineStarts, firstLine, out, nullptr).write(pRoot);
+}
+
+void ast::exportTree(
+  Node::Ptr pRoot,
+  ExportFormat format,
+  std::span<size_t const> lineStarts,
+  std::FILE* pFile,
+  size_t firstLine)
+{
+  fmt::memory_buffer out;
+  Writer(format, lineStarts, firstLine, out, pFile).write(pRoot);
+}
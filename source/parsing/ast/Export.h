@@ -0,0 +1,57 @@
+#pragma once
+
+#include <parsing/ast/Node.h>
+
+#include <fmt/format.h>
+
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace ast
+{
+
+// Machine readable forms of a tree for tools, without any styling.
+//
+// Every node is written with its kind, its start and end as line and
+// column, its byte range if the byte offsets of the line starts are
+// given, the texts of its tokens, flags that are set and its children.
+// Children name the field of their parent that holds them:
+//
+//   {"kind":"Part","start":[0,4],"end":[0,9],"range":[4,9],"role":"declaration",
+//    "children":[{"field":"asign","kind":"SymbolExpression",...},...]}
+//
+//   (Part :start (0 4) :end (0 9) :range (4 9) :role "declaration"
+//     (SymbolExpression :field "asign" ...) ...)
+//
+// The s-expression form is written on a single line as well. Lines and
+// columns start at 0, unknown positions are null or nil. Nodes are written
+// while the tree is walked, the output is flushed in blocks and nothing but
+// the walk's stack is kept.
+enum class ExportFormat
+{
+  Json,
+  Sexpr,
+};
+
+std::optional<ExportFormat> exportFormat(std::string_view name);
+
+// Writes the tree rooted at pRoot followed by a newline, the bodies of
+// lazily parsed functions are parsed. lineStarts[0] is the start of line
+// firstLine, so a tree can be written with the line starts of its own lines.
+void exportTree(
+  Node::Ptr pRoot,
+  ExportFormat format,
+  std::span<size_t const> lineStarts,
+  fmt::memory_buffer& out,
+  size_t firstLine = 0);
+
+void exportTree(
+  Node::Ptr pRoot,
+  ExportFormat format,
+  std::span<size_t const> lineStarts,
+  std::FILE* pFile,
+  size_t firstLine = 0);
+
+} // namespace ast
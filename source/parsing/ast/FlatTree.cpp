@@ -0,0 +1,325 @@
+#include "parsing/ast/FlatTree.h"
+
+#include <parsing/ast/Nodes.h>
+#include <parsing/ast/Unflatten.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace ast;
+
+namespace
+{
+
+using Index = FlatTree::Index;
+
+std::optional<Token> find(
+  std::vector<std::pair<Index, Index>> const& table,
+  std::vector<Token> const& tokens,
+  Index node)
+{
+  auto const it = std::lower_bound(table.begin(), table.end(), std::make_pair(node, Index(0)));
+  if (it == table.end() || it->first != node)
+  {
+    return std::nullopt;
+  }
+  return tokens[it->second];
+}
+
+template<typename T>
+size_t bytes(std::vector<T> const& vec)
+{
+  return vec.capacity() * sizeof(T);
+}
+
+} // anonymous namespace
+
+FlatTree::FlatTree(Node::Ptr pRoot)
+{
+  add(pRoot);
+
+  d_kinds.shrink_to_fit();
+  d_mainTokens.shrink_to_fit();
+  d_data.shrink_to_fit();
+  d_extra.shrink_to_fit();
+  d_tokens.shrink_to_fit();
+}
+
+std::optional<Token> FlatTree::label(Index node) const
+{
+  return find(d_labels, d_tokens, node);
+}
+
+std::optional<Token> FlatTree::tokComptime(Index node) const
+{
+  return find(d_comptimeTokens, d_tokens, node);
+}
+
+size_t FlatTree::bytesUsed() const
+{
+  return bytes(d_kinds) + bytes(d_mainTokens) + bytes(d_data) + bytes(d_extra)
+    + bytes(d_tokens) + bytes(d_labels) + bytes(d_comptimeTokens);
+}
+
+Node::Ptr FlatTree::toNode(Arena& arena) const
+{
+  assert(size() > 0);
+  return unflatten(*this, arena, 0);
+}
+
+FlatTree::Index FlatTree::add(Node::Ptr pNode)
+{
+  assert(d_kinds.size() < std::numeric_limits<Index>::max());
+
+  auto const node = static_cast<Index>(d_kinds.size());
+  d_kinds.push_back(pNode->kind());
+  d_mainTokens.push_back(0);
+  d_data.push_back({Null, Null});
+
+  // before the children so that the side tables stay sorted
+  if (pNode->isComptime())
+  {
+    d_comptimeTokens.emplace_back(node, addToken(pNode->tokComptime()));
+  }
+  if (pNode->is<LabeledNode>() && pNode->as<LabeledNode>()->isLabeled())
+  {
+    d_labels.emplace_back(node, addToken(pNode->as<LabeledNode>()->label()));
+  }
+
+  Index mainToken = 0;
+  Data data = {Null, Null};
+
+  switch (pNode->kind())
+  {
+  case Node::Kind::TypeExpression:
+  {
+    static constexpr Token::Tag tags[] = {Token::KwStruct, Token::KwEnum, Token::KwUnion};
+
+    auto const pType = pNode->as<TypeExpression>();
+    mainToken = addPosition(tags[pType->tag()], pType->start());
+    data.rhs = addOptional(pType->underlyingType());
+
+    std::vector<Index> children;
+    children.reserve(pType->declsPre().size() + pType->fields().size() + pType->declsPost().size());
+    for (auto const pDecl : pType->declsPre())
+    {
+      children.push_back(add(pDecl));
+    }
+    for (auto const pField : pType->fields())
+    {
+      children.push_back(add(pField));
+    }
+    for (auto const pDecl : pType->declsPost())
+    {
+      children.push_back(add(pDecl));
+    }
+
+    data.lhs = static_cast<Index>(d_extra.size());
+    d_extra.push_back(addPosition(Token::RBrace, pType->end()));
+    d_extra.push_back(static_cast<Index>(pType->fields().size()));
+    d_extra.push_back(static_cast<Index>(pType->declsPre().size()));
+    d_extra.push_back(static_cast<Index>(pType->declsPost().size()));
+    d_extra.insert(d_extra.end(), children.begin(), children.end());
+    break;
+  }
+  case Node::Kind::FunctionExpression:
+  {
+    auto const pFn = pNode->as<FunctionExpression>();
+    mainToken = addToken(pFn->tokFn());
+
+    std::vector<Index> parameters;
+    parameters.reserve(pFn->parameters().size());
+    for (auto const pParameter : pFn->parameters())
+    {
+      parameters.push_back(add(pParameter));
+    }
+    Index const returnType = add(pFn->returnType());
+    data.rhs = pFn->isType() ? Null : add(pFn->body());
+
+    data.lhs = static_cast<Index>(d_extra.size());
+    d_extra.push_back(returnType);
+    d_extra.push_back(static_cast<Index>(parameters.size()));
+    d_extra.insert(d_extra.end(), parameters.begin(), parameters.end());
+    break;
+  }
+  case Node::Kind::LetStatement:
+  {
+    auto const pLet = pNode->as<LetStatement>();
+    mainToken = addPosition(Token::KwLet, pLet->start());
+
+    std::vector<Index> parts;
+    parts.reserve(pLet->parts().size());
+    for (auto const pPart : pLet->parts())
+    {
+      parts.push_back(add(pPart));
+    }
+
+    data.lhs = static_cast<Index>(d_extra.size());
+    d_extra.push_back(static_cast<Index>(parts.size()));
+    d_extra.insert(d_extra.end(), parts.begin(), parts.end());
+    data.rhs = (pLet->isPub() ? Index(Pub) : 0) | (pLet->isMut() ? Index(Mut) : 0);
+    break;
+  }
+  case Node::Kind::Part:
+  {
+    auto const pPart = pNode->as<Part>();
+    data.lhs = add(pPart->asign());
+    mainToken = d_mainTokens[data.lhs];
+    Index const type = addOptional(pPart->type());
+    Index const value = addOptional(pPart->value());
+
+    data.rhs = static_cast<Index>(d_extra.size());
+    d_extra.push_back(type);
+    d_extra.push_back(value);
+    break;
+  }
+  case Node::Kind::SwitchExpression:
+  {
+    auto const pSwitch = pNode->as<SwitchExpression>();
+    mainToken = addToken(pSwitch->tokSwitch());
+    data.lhs = add(pSwitch->value());
+
+    std::vector<Index> cases;
+    cases.reserve(3 * pSwitch->cases().size());
+    for (auto const& _case : pSwitch->cases())
+    {
+      cases.push_back(add(_case.value));
+      cases.push_back(addOptional(_case.capture));
+      cases.push_back(add(_case.result));
+    }
+
+    data.rhs = static_cast<Index>(d_extra.size());
+    d_extra.push_back(addPosition(Token::RBrace, pSwitch->end()));
+    d_extra.push_back(static_cast<Index>(pSwitch->cases().size()));
+    d_extra.insert(d_extra.end(), cases.begin(), cases.end());
+    break;
+  }
+  case Node::Kind::ReturnStatement:
+  {
+    auto const pReturn = pNode->as<ReturnStatement>();
+    mainToken = addToken(pReturn->tokReturn());
+    data.lhs = addOptional(pReturn->value());
+    break;
+  }
+  case Node::Kind::BreakStatement:
+  {
+    auto const pBreak = pNode->as<BreakStatement>();
+    mainToken = addToken(pBreak->tokBreak());
+    if (pBreak->isLabeled())
+    {
+      d_labels.emplace_back(node, addToken(pBreak->label()));
+    }
+    data.lhs = addOptional(pBreak->value());
+    break;
+  }
+  case Node::Kind::ContinueStatement:
+  {
+    auto const pContinue = pNode->as<ContinueStatement>();
+    mainToken = addToken(pContinue->tokContinue());
+    if (pContinue->isLabeled())
+    {
+      d_labels.emplace_back(node, addToken(pContinue->label()));
+    }
+    break;
+  }
+  case Node::Kind::DeferStatement:
+  {
+    auto const pDefer = pNode->as<DeferStatement>();
+    mainToken = addToken(pDefer->tokDefer());
+    data.lhs = add(pDefer->target());
+    break;
+  }
+  case Node::Kind::BlockExpression:
+  {
+    auto const pBlock = pNode->as<BlockExpression>();
+    mainToken = addPosition(Token::LBrace, pBlock->start());
+
+    std::vector<Index> statements;
+    statements.reserve(pBlock->statements().size());
+    for (auto const pStatement : pBlock->statements())
+    {
+      statements.push_back(add(pStatement));
+    }
+
+    data.lhs = static_cast<Index>(d_extra.size());
+    d_extra.push_back(addPosition(Token::RBrace, pBlock->end()));
+    d_extra.push_back(static_cast<Index>(statements.size()));
+    d_extra.insert(d_extra.end(), statements.begin(), statements.end());
+    break;
+  }
+  case Node::Kind::IfExpression:
+  {
+    auto const pIf = pNode->as<IfExpression>();
+    mainToken = addToken(pIf->clauses().front().tokStart);
+
+    std::vector<Index> clauses;
+    clauses.reserve(5 * pIf->clauses().size());
+    for (auto const& clause : pIf->clauses())
+    {
+      clauses.push_back(static_cast<Index>(clause.tag));
+      clauses.push_back(addToken(clause.tokStart));
+      clauses.push_back(addOptional(clause.condition));
+      clauses.push_back(addOptional(clause.capture));
+      clauses.push_back(add(clause.body));
+    }
+
+    data.lhs = static_cast<Index>(d_extra.size());
+    d_extra.push_back(static_cast<Index>(pIf->clauses().size()));
+    d_extra.insert(d_extra.end(), clauses.begin(), clauses.end());
+    break;
+  }
+  case Node::Kind::LoopExpression:
+  {
+    auto const pLoop = pNode->as<LoopExpression>();
+    mainToken = addToken(pLoop->tokLoop());
+    data.lhs = add(pLoop->condition());
+
+    Index const
+      capture = addOptional(pLoop->capture()),
+      body = add(pLoop->body()),
+      tokElse = addToken(pLoop->tokElse()),
+      elseCapture = addOptional(pLoop->elseCapture()),
+      elseBody = addOptional(pLoop->elseBody());
+
+    data.rhs = static_cast<Index>(d_extra.size());
+    d_extra.insert(d_extra.end(), {capture, body, tokElse, elseCapture, elseBody});
+    break;
+  }
+  case Node::Kind::BoolExpression:
+    data.lhs = static_cast<Index>(pNode->as<BoolExpression>()->value());
+    [[fallthrough]];
+  case Node::Kind::SymbolExpression:
+  case Node::Kind::BuiltinExpression:
+  case Node::Kind::StringExpression:
+  case Node::Kind::NumberExpression:
+  case Node::Kind::NullExpression:
+  case Node::Kind::UndefinedExpression:
+  case Node::Kind::UnreachableExpression:
+    mainToken = addToken(pNode->as<TokenExpression>()->token());
+    break;
+  case Node::Kind::Clause:
+  case Node::Kind::Case:
+    assert(false && "printing only nodes are never part of a tree");
+    break;
+  }
+
+  d_mainTokens[node] = mainToken;
+  d_data[node] = data;
+  return node;
+}
+
+FlatTree::Index FlatTree::addOptional(Node::Ptr pNode)
+{
+  return pNode != nullptr ? add(pNode) : Null;
+}
+
+FlatTree::Index FlatTree::addToken(Token token)
+{
+  d_tokens.push_back(token);
+  return static_cast<Index>(d_tokens.size() - 1);
+}
+
+FlatTree::Index FlatTree::addPosition(Token::Tag tag, Position position)
+{
+  return addToken(Token(tag, position, position, ""));
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <parsing/Token.h>
+#include <parsing/ast/Node.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace ast
+{
+
+// A syntax tree stored as parallel arrays in the style of Zig's std.zig.Ast.
+// Every node has a kind, a main token and two data slots whose meaning
+// depends on the kind, lists of children live in the extra array. Nodes
+// are stored in pre-order with the root at index 0, visiting every node
+// is a linear scan and 0 doubles as the null child.
+//
+// Positions that nodes keep without a token, e.g. where a block starts,
+// are stored as zero-width tokens of the rune they stand for.
+//
+//   kind                 main token       lhs                 rhs
+//   TypeExpression       struct/enum/     extra: end, fields  underlying type
+//                        union at start   count, pre count,
+//                                         post count, pre..,
+//                                         fields.., post..
+//   FunctionExpression   fn               extra: return type, body
+//                                         count, params..
+//   LetStatement         let at start     extra: count,       1 if pub | 2 if mut
+//                                         parts..
+//   Part                 first of asign   asign               extra: type, value
+//   SwitchExpression     switch           value               extra: end, count,
+//                                                             (value, capture,
+//                                                             result)..
+//   ReturnStatement      return           value
+//   BreakStatement       break            value
+//   ContinueStatement    continue
+//   DeferStatement       defer            target
+//   BlockExpression      { at start       extra: end, count,
+//                                         statements..
+//   IfExpression         if               extra: count,
+//                                         (tag, token,
+//                                         condition, capture,
+//                                         body)..
+//   LoopExpression       loop             condition           extra: capture, body,
+//                                                             else, else capture,
+//                                                             else body
+//   BoolExpression       literal          value
+//   other tokens         literal
+//
+// Tokens in extra are indices into tokens(). Labels and comptime tokens
+// are rare and kept in sorted side tables.
+struct FlatTree final
+{
+  // Friends
+  friend struct AstCache;
+
+public:
+  // Types
+  using Index = uint32_t;
+
+  struct Data
+  {
+    Index lhs;
+    Index rhs;
+  };
+
+  static constexpr Index Null = 0;
+
+  enum LetFlags : Index
+  {
+    Pub = 1 << 0,
+    Mut = 1 << 1,
+  };
+
+private:
+  // Data
+  std::vector<Node::Kind> d_kinds;
+  std::vector<Index> d_mainTokens;
+  std::vector<Data> d_data;
+  std::vector<Index> d_extra;
+  std::vector<Token> d_tokens;
+  std::vector<std::pair<Index, Index>> d_labels; // node, token
+  std::vector<std::pair<Index, Index>> d_comptimeTokens; // node, token
+
+public:
+  // Constructors
+  // Parses the bodies of lazily parsed functions
+  explicit FlatTree(Node::Ptr pRoot);
+
+  // Methods
+  size_t size() const { return d_kinds.size(); }
+  std::span<Node::Kind const> kinds() const { return d_kinds; }
+  std::span<Token const> tokens() const { return d_tokens; }
+
+  Node::Kind kind(Index node) const { return d_kinds[node]; }
+  Token const& mainToken(Index node) const { return d_tokens[d_mainTokens[node]]; }
+  Data data(Index node) const { return d_data[node]; }
+  std::span<Index const> extra() const { return d_extra; }
+  Index extra(Index idx) const { return d_extra[idx]; }
+  std::span<Index const> extra(Index begin, Index count) const { return {d_extra.data() + begin, count}; }
+  Token const& token(Index idx) const { return d_tokens[idx]; }
+
+  std::optional<Token> label(Index node) const;
+  std::optional<Token> tokComptime(Index node) const;
+
+  // Bytes taken by the arrays
+  size_t bytesUsed() const;
+
+  // Rebuilds the pointer based tree, equal to the one the flat tree was built from
+  Node::Ptr toNode(Arena& arena) const;
+
+private:
+  Index add(Node::Ptr pNode);
+  Index addOptional(Node::Ptr pNode);
+  Index addToken(Token token);
+  Index addPosition(Token::Tag tag, Position position);
+};
+
+} // namespace ast
\ No newline at end of file
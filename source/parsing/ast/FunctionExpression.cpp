@@ -5,9 +5,10 @@
 using namespace ast;
 
 void FunctionExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   // + 2 for the return type and body
@@ -26,24 +27,64 @@ void FunctionExpression::toStringData(
   *additionalInfo = isType() ? "type" : "";
 }
 
-FunctionExpression::SPtr FunctionExpression::make_shared(
+Position FunctionExpression::end() const
+{
+  if (isBodyLazy())
+  {
+    return d_bodyEnd;
+  }
+  return (d_pBody != nullptr ? d_pBody : d_pReturnType)->end();
+}
+
+void FunctionExpression::shiftData(PositionShift const& shift)
+{
+  d_fn.shift(shift);
+  d_bodyEnd = shift(d_bodyEnd);
+}
+
+BlockExpression::Ptr FunctionExpression::body() const
+{
+  if (isBodyLazy())
+  {
+    d_pBody = d_lazyBody->parse(*d_lazyBody);
+    d_lazyBody.reset();
+  }
+  return d_pBody;
+}
+
+FunctionExpression::Ptr FunctionExpression::make(
+  Arena& arena,
   Token fn,
-  std::vector<Part::SPtr>&& parameters,
-  Node::SPtr pReturnType,
-  BlockExpression::SPtr pBody,
-  Node::SPtr pParent)
+  std::vector<Part::Ptr> const& parameters,
+  Node::Ptr pReturnType,
+  BlockExpression::Ptr pBody)
 {
-  auto pRes = std::make_shared<FunctionExpression>(
-    fn, std::move(parameters), pReturnType, pBody, pParent);
+  auto pRes = arena.make<FunctionExpression>(
+    fn, arena.copy(parameters), pReturnType, pBody);
 
-  for (auto& pParameter : pRes->d_parameters)
+  for (auto pParameter : pRes->d_parameters)
   {
-    pParameter->setParent(pRes);
+    pParameter->setRole(Part::Parameter);
   }
-  pRes->d_pReturnType->setParent(pRes);
-  if (pRes->d_pBody != nullptr)
+  pRes->rehash();
+  return pRes;
+}
+
+FunctionExpression::Ptr FunctionExpression::make(
+  Arena& arena,
+  Token fn,
+  std::vector<Part::Ptr> const& parameters,
+  Node::Ptr pReturnType,
+  Position bodyEnd,
+  LazyBody const& lazyBody)
+{
+  auto pRes = arena.make<FunctionExpression>(
+    fn, arena.copy(parameters), pReturnType, bodyEnd, lazyBody);
+
+  for (auto pParameter : pRes->d_parameters)
   {
-    pRes->d_pBody->setParent(pRes);
+    pParameter->setRole(Part::Parameter);
   }
+  pRes->rehash();
   return pRes;
 }
\ No newline at end of file
@@ -3,6 +3,10 @@
 #include <parsing/ast/Node.h>
 #include <parsing/ast/Part.h>
 #include <parsing/ast/BlockExpression.h>
+#include <parsing/SourceManager.h>
+#include <parsing/Token.h>
+
+#include <optional>
 
 namespace ast
 {
@@ -10,48 +14,99 @@ namespace ast
 struct FunctionExpression final : public Node
 {
   PTR(FunctionExpression)
+  KIND(FunctionExpression)
+
+public:
+  // A body that was skipped by the parser, see Parser::setLazyFunctionBodies().
+  // Its tokens are [begin, end) of a buffer the parser keeps in pArena.
+  struct LazyBody
+  {
+    BlockExpression::Ptr (*parse)(LazyBody const& body);
+    std::vector<Token> const* pTokens;
+    size_t begin;
+    size_t end;
+    Arena* pArena;
+    FileId file;
+    uint8_t state; // of the parser the body was skipped by
+    bool isLazy; // the functions of the body are skipped too
+  };
 
 private:
-  Token d_fn;
-  std::vector<Part::SPtr> d_parameters;
-  Node::SPtr d_pReturnType;
-  BlockExpression::SPtr d_pBody;
+  CompactToken d_fn;
+  std::span<Part::Ptr const> d_parameters;
+  Node::Ptr d_pReturnType;
+  mutable BlockExpression::Ptr d_pBody;
+  mutable std::optional<LazyBody> d_lazyBody; // empty once the body is parsed
+  Position d_bodyEnd;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override;
 
 public:
   FunctionExpression(
     Token fn,
-    std::vector<Part::SPtr>&& parameters,
-    Node::SPtr pReturnType,
-    BlockExpression::SPtr pBody = nullptr,
-    Node::SPtr pParent = nullptr)
-    : Node(pParent)
+    std::span<Part::Ptr const> parameters,
+    Node::Ptr pReturnType,
+    BlockExpression::Ptr pBody = nullptr)
+    : Node(Kind::FunctionExpression)
     , d_fn(fn)
-    , d_parameters(std::move(parameters))
+    , d_parameters(parameters)
     , d_pReturnType(pReturnType)
     , d_pBody(pBody)
+    , d_bodyEnd(Position::invalid())
+  {}
+
+  FunctionExpression(
+    Token fn,
+    std::span<Part::Ptr const> parameters,
+    Node::Ptr pReturnType,
+    Position bodyEnd,
+    LazyBody const& lazyBody)
+    : Node(Kind::FunctionExpression)
+    , d_fn(fn)
+    , d_parameters(parameters)
+    , d_pReturnType(pReturnType)
+    , d_pBody(nullptr)
+    , d_lazyBody(lazyBody)
+    , d_bodyEnd(bodyEnd)
   {}
 
   virtual Position start() const override { return d_fn.start(); }
-  virtual Position end() const override { return (d_pBody != nullptr ? d_pBody : d_pReturnType)->end(); }
+  virtual Position end() const override;
   virtual bool isExpression() const override { return true; }
 
-  std::vector<Part::SPtr> const& parameters() const { return d_parameters; }
-  Node::SPtr returnType() const { return d_pReturnType; }
-  bool isType() const { return d_pBody == nullptr; }
-  BlockExpression::SPtr body() const { return d_pBody; }
+  Token tokFn() const { return d_fn; }
+  std::span<Part::Ptr const> parameters() const { return d_parameters; }
+  Node::Ptr returnType() const { return d_pReturnType; }
+  bool isType() const { return d_pBody == nullptr && !isBodyLazy(); }
+  // true until the body of a lazily parsed function is first accessed
+  bool isBodyLazy() const { return d_lazyBody.has_value(); }
+  // Parses the body on first access if it was skipped by the parser. The
+  // body is allocated from the arena of the tree, which is not thread safe,
+  // so lazy bodies must be forced from one thread, e.g. with hash(), before
+  // the tree is shared.
+  BlockExpression::Ptr body() const;
+
+  static FunctionExpression::Ptr make(
+    Arena& arena,
+    Token fn,
+    std::vector<Part::Ptr> const& parameters,
+    Node::Ptr pReturnType,
+    BlockExpression::Ptr pBody = nullptr);
 
-  static FunctionExpression::SPtr make_shared(
+  static FunctionExpression::Ptr make(
+    Arena& arena,
     Token fn,
-    std::vector<Part::SPtr>&& parameters,
-    Node::SPtr pReturnType,
-    BlockExpression::SPtr pBody = nullptr,
-    Node::SPtr pParent = nullptr);
+    std::vector<Part::Ptr> const& parameters,
+    Node::Ptr pReturnType,
+    Position bodyEnd,
+    LazyBody const& lazyBody);
 };
 
 } // namespace ast
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "parsing/ast/Hash.h"
+
+#include <parsing/ast/Nodes.h>
+
+#include <bit>
+#include <cstring>
+#include <span>
+
+using namespace ast;
+
+namespace
+{
+
+constexpr uint64_t
+  k0 = 0x9e3779b97f4a7c15,
+  k1 = 0xc2b2ae3d27d4eb4f;
+
+// MurmurHash3's 64 bit finalizer
+uint64_t mix(uint64_t value)
+{
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccd;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53;
+  value ^= value >> 33;
+  return value;
+}
+
+struct Builder
+{
+  Hasher hasher;
+  bool parseLazyBodies;
+  bool isComplete = true;
+
+  void add(uint64_t value) { hasher.add(value); }
+  void add(std::string_view text) { hasher.add(text); }
+
+  void label(LabeledNode const* pNode)
+  {
+    add(uint64_t(pNode->isLabeled()));
+    add(pNode->labelName());
+  }
+
+  void child(Node const* pChild)
+  {
+    if (!isComplete)
+    {
+      return;
+    }
+
+    auto const hash = parseLazyBodies ? std::optional(pChild->hash()) : pChild->tryHash();
+    if (!hash.has_value())
+    {
+      isComplete = false;
+      return;
+    }
+    hasher.add(*hash);
+  }
+
+  void optional(Node const* pChild)
+  {
+    add(uint64_t(pChild != nullptr));
+    if (pChild != nullptr)
+    {
+      child(pChild);
+    }
+  }
+
+  template<typename Ptr>
+  void children(std::span<Ptr const> nodes)
+  {
+    add(nodes.size());
+    for (auto const pNode : nodes)
+    {
+      child(pNode);
+    }
+  }
+};
+
+} // anonymous namespace
+
+Hasher::Hasher() noexcept
+  : d_lo(k0)
+  , d_hi(k1)
+{}
+
+void Hasher::add(uint64_t value) noexcept
+{
+  // two lanes mixed differently so that they collide independently
+  d_lo = mix(d_lo ^ value);
+  d_hi = mix(std::rotl(d_hi, 23) + value * k0);
+}
+
+void Hasher::add(std::string_view text) noexcept
+{
+  add(text.size());
+
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= text.size(); i += sizeof(uint64_t))
+  {
+    uint64_t chunk;
+    std::memcpy(&chunk, text.data() + i, sizeof(uint64_t));
+    add(chunk);
+  }
+  if (i < text.size())
+  {
+    uint64_t chunk = 0;
+    std::memcpy(&chunk, text.data() + i, text.size() - i);
+    add(chunk);
+  }
+}
+
+void Hasher::add(Hash hash) noexcept
+{
+  add(hash.lo);
+  add(hash.hi);
+}
+
+Hash Hasher::finish() const noexcept
+{
+  return Hash{mix(d_lo + k1), mix(d_hi ^ k0)};
+}
+
+std::optional<Hash> ast::structuralHash(Node const* pNode, bool parseLazyBodies)
+{
+  Builder builder = {Hasher(), parseLazyBodies};
+  builder.add(static_cast<uint64_t>(pNode->kind()));
+  builder.add(uint64_t(pNode->isComptime()));
+
+  // the node types only provide non-const access to their children
+  auto const pMutable = const_cast<Node*>(pNode);
+
+  switch (pNode->kind())
+  {
+  case Node::Kind::TypeExpression:
+  {
+    auto const pType = pMutable->as<TypeExpression>();
+    builder.add(static_cast<uint64_t>(pType->tag()));
+    builder.optional(pType->underlyingType());
+    builder.children(pType->declsPre());
+    builder.children(pType->fields());
+    builder.children(pType->declsPost());
+    break;
+  }
+  case Node::Kind::FunctionExpression:
+  {
+    auto const pFn = pMutable->as<FunctionExpression>();
+    if (pFn->isBodyLazy() && !parseLazyBodies)
+    {
+      return std::nullopt;
+    }
+    builder.children(pFn->parameters());
+    builder.child(pFn->returnType());
+    builder.optional(pFn->body());
+    break;
+  }
+  case Node::Kind::LetStatement:
+  {
+    auto const pLet = pMutable->as<LetStatement>();
+    builder.add(uint64_t(pLet->isPub()));
+    builder.add(uint64_t(pLet->isMut()));
+    builder.children(pLet->parts());
+    break;
+  }
+  case Node::Kind::Part:
+  {
+    auto const pPart = pMutable->as<Part>();
+    builder.child(pPart->asign());
+    builder.optional(pPart->type());
+    builder.optional(pPart->value());
+    break;
+  }
+  case Node::Kind::SwitchExpression:
+  {
+    auto const pSwitch = pMutable->as<SwitchExpression>();
+    builder.child(pSwitch->value());
+    builder.add(pSwitch->cases().size());
+    for (auto const& _case : pSwitch->cases())
+    {
+      builder.child(_case.value);
+      builder.optional(_case.capture);
+      builder.child(_case.result);
+    }
+    break;
+  }
+  case Node::Kind::ReturnStatement:
+    builder.optional(pMutable->as<ReturnStatement>()->value());
+    break;
+  case Node::Kind::BreakStatement:
+  {
+    auto const pBreak = pMutable->as<BreakStatement>();
+    builder.add(uint64_t(pBreak->isLabeled()));
+    builder.add(pBreak->isLabeled() ? pBreak->label().text() : "");
+    builder.optional(pBreak->value());
+    break;
+  }
+  case Node::Kind::ContinueStatement:
+  {
+    auto const pContinue = pMutable->as<ContinueStatement>();
+    builder.add(uint64_t(pContinue->isLabeled()));
+    builder.add(pContinue->isLabeled() ? pContinue->label().text() : "");
+    break;
+  }
+  case Node::Kind::DeferStatement:
+    builder.child(pMutable->as<DeferStatement>()->target());
+    break;
+  case Node::Kind::BlockExpression:
+  {
+    auto const pBlock = pMutable->as<BlockExpression>();
+    builder.label(pBlock);
+    builder.children(pBlock->statements());
+    break;
+  }
+  case Node::Kind::IfExpression:
+  {
+    auto const pIf = pMutable->as<IfExpression>();
+    builder.label(pIf);
+    builder.add(pIf->clauses().size());
+    for (auto const& clause : pIf->clauses())
+    {
+      builder.add(static_cast<uint64_t>(clause.tag));
+      builder.optional(clause.condition);
+      builder.optional(clause.capture);
+      builder.child(clause.body);
+    }
+    break;
+  }
+  case Node::Kind::LoopExpression:
+  {
+    auto const pLoop = pMutable->as<LoopExpression>();
+    builder.label(pLoop);
+    builder.child(pLoop->condition());
+    builder.optional(pLoop->capture());
+    builder.child(pLoop->body());
+    builder.optional(pLoop->elseCapture());
+    builder.optional(pLoop->elseBody());
+    break;
+  }
+  case Node::Kind::BoolExpression:
+    builder.add(uint64_t(pMutable->as<BoolExpression>()->value()));
+    break;
+  case Node::Kind::SymbolExpression:
+  case Node::Kind::BuiltinExpression:
+  case Node::Kind::StringExpression:
+  case Node::Kind::NumberExpression:
+    builder.add(pMutable->as<TokenExpression>()->token().text());
+    break;
+  case Node::Kind::NullExpression:
+  case Node::Kind::UndefinedExpression:
+  case Node::Kind::UnreachableExpression:
+    break;
+  case Node::Kind::Clause:
+  case Node::Kind::Case:
+    assert(false && "printing only nodes are never part of a tree");
+    break;
+  }
+
+  if (!builder.isComplete)
+  {
+    return std::nullopt;
+  }
+  return builder.hasher.finish();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace ast
+{
+
+struct Node;
+
+// 128 bit structural hash of a subtree, see Node::hash()
+struct Hash final
+{
+  // Data
+  uint64_t lo;
+  uint64_t hi;
+
+  // Operators
+  constexpr bool operator==(Hash const&) const noexcept = default;
+};
+
+// Combines values into a Hash, the result depends on their order
+struct Hasher final
+{
+private:
+  // Data
+  uint64_t d_lo;
+  uint64_t d_hi;
+
+public:
+  // Constructors
+  Hasher() noexcept;
+
+  // Methods
+  void add(uint64_t value) noexcept;
+  void add(std::string_view text) noexcept;
+  void add(Hash hash) noexcept;
+
+  Hash finish() const noexcept;
+};
+
+// Hashes the kind of pNode, the token texts and flags that tell nodes of
+// that kind apart and the hashes of its children, positions are ignored.
+// Returns nothing if parseLazyBodies is false and a child has an unparsed
+// function body below it.
+std::optional<Hash> structuralHash(Node const* pNode, bool parseLazyBodies);
+
+} // namespace ast
@@ -8,19 +8,21 @@ namespace
 struct ClauseNode final : public Node
 {
   PTR(ClauseNode)
+  KIND(Clause)
 
 private:
   IfExpression::Clause d_caluse;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
   ClauseNode(IfExpression::Clause clause)
-    : Node(nullptr)
+    : Node(Kind::Clause)
     , d_caluse(clause)
   {}
 
@@ -31,9 +33,10 @@ public:
 };
 
 void ClauseNode::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   subNodes->reserve(3);
@@ -75,9 +78,10 @@ Position IfExpression::end() const
 }
 
 void IfExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena* pTemporaries) const
 {
   assert(subNodes->size() == 0);
   subNodes->reserve(2 * (1 + clauses().size()));
@@ -92,7 +96,7 @@ void IfExpression::toStringData(
 
   for (size_t i = 1; i < clauses().size(); i += 1)
   {
-    subNodes->push_back(std::make_shared<ClauseNode>(clauses()[i]));
+    subNodes->push_back(pTemporaries->make<ClauseNode>(clauses()[i]));
   }
 
   *nodeName = "If";
@@ -101,21 +105,21 @@ void IfExpression::toStringData(
   *additionalInfo = "";
 }
 
-IfExpression::SPtr IfExpression::make_shared(
-  std::vector<Clause>&& clauses,
-  Node::SPtr pParent)
+void IfExpression::shiftData(PositionShift const& shift)
 {
-  auto pRes = std::make_shared<IfExpression>(std::move(clauses), pParent);
-  for (auto& clause : pRes->d_clauses)
+  LabeledNode::shiftData(shift);
+  // the clauses are allocated from the arena as mutable objects
+  for (auto const& clause : d_clauses)
   {
-    if (clause.condition != nullptr)
-    {
-      clause.condition->setParent(pRes);
-    }
-    if (clause.capture != nullptr)
-    {
-      clause.capture->setParent(pRes);
-    }
+    const_cast<Clause&>(clause).tokStart.shift(shift);
   }
+}
+
+IfExpression::Ptr IfExpression::make(
+  Arena& arena,
+  std::vector<Clause> const& clauses)
+{
+  auto pRes = arena.make<IfExpression>(arena.copy(clauses));
+  pRes->rehash();
   return pRes;
 }
\ No newline at end of file
@@ -9,6 +9,7 @@ namespace ast
 struct IfExpression final : public LabeledNode
 {
   PTR(IfExpression)
+  KIND(IfExpression)
 
 public:
   struct Clause
@@ -21,27 +22,29 @@ public:
     };
 
     Tag tag;
-    Token tokStart;
-    Node::SPtr condition;
-    Node::SPtr capture;
-    BlockExpression::SPtr body;
+    CompactToken tokStart;
+    Node::Ptr condition;
+    Node::Ptr capture;
+    BlockExpression::Ptr body;
   };
 
 private:
-  std::vector<Clause> d_clauses;
+  std::span<Clause const> d_clauses;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override;
 
 public:
   IfExpression(
-    std::vector<Clause>&& clauses,
-    Node::SPtr pParent = nullptr)
-    : LabeledNode(pParent)
-    , d_clauses(std::move(clauses))
+    std::span<Clause const> clauses)
+    : LabeledNode(Kind::IfExpression)
+    , d_clauses(clauses)
   {
     assert(d_clauses.size() > 0);
   }
@@ -52,11 +55,11 @@ public:
   // TODO check for break statements
   virtual bool isExpression() const override { return true; }
 
-  std::vector<Clause> const& clauses() const { return d_clauses; }
+  std::span<Clause const> clauses() const { return d_clauses; }
 
-  static IfExpression::SPtr make_shared(
-    std::vector<Clause>&& clauses,
-    Node::SPtr pParent = nullptr);
+  static IfExpression::Ptr make(
+    Arena& arena,
+    std::vector<Clause> const& clauses);
 };
 
 } // namespace ast
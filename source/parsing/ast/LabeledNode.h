@@ -10,18 +10,26 @@ namespace ast
 struct LabeledNode : public Node
 {
   PTR(LabeledNode)
+  KINDS(BlockExpression, LoopExpression)
 
 private:
-  bool d_isLabeled;
-  Token d_label;
+  CompactToken d_label;
+
+protected:
+  virtual void shiftData(PositionShift const& shift) override
+  {
+    if (isLabeled())
+    {
+      d_label.shift(shift);
+    }
+  }
 
 public:
-  LabeledNode(Node::SPtr pParent = nullptr)
-    : Node(pParent)
-    , d_isLabeled(false)
+  explicit LabeledNode(Kind kind)
+    : Node(kind)
   {}
 
-  bool isLabeled() const noexcept { return d_isLabeled; }
+  bool isLabeled() const noexcept { return (d_flags & Labeled) != 0; }
 
   std::string_view labelName() const noexcept { return d_label.text(); }
 
@@ -29,8 +37,9 @@ public:
 
   void setLabel(Token label) noexcept
   {
-    d_isLabeled = true;
+    d_flags |= Labeled;
     d_label = label;
+    rehash();
   }
 };
 
@@ -3,9 +3,10 @@
 using namespace ast;
 
 void LetStatement::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   subNodes->reserve(parts().size());
@@ -28,17 +29,14 @@ void LetStatement::toStringData(
   }
 }
 
-LetStatement::SPtr LetStatement::make_shared(
+LetStatement::Ptr LetStatement::make(
+  Arena& arena,
   Position start,
   bool isPub,
   bool isMut,
-  std::vector<Part::SPtr>&& parts,
-  Node::SPtr pParent)
+  std::vector<Part::Ptr> const& parts)
 {
-  auto pRes = std::make_shared<LetStatement>(start, isMut, isPub, std::move(parts), pParent);
-  for (auto pPart : pRes->d_parts)
-  {
-    pPart->setParent(pRes);
-  }
+  auto pRes = arena.make<LetStatement>(start, isPub, isMut, arena.copy(parts));
+  pRes->rehash();
   return pRes;
 }
\ No newline at end of file
@@ -10,31 +10,34 @@ namespace ast
 struct LetStatement final : public Node
 {
   PTR(LetStatement)
+  KIND(LetStatement)
 
 private:
   Position d_start;
   bool d_isPub;
   bool d_isMut;
-  std::vector<Part::SPtr> d_parts;
+  std::span<Part::Ptr const> d_parts;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override { d_start = shift(d_start); }
 
 public:
   LetStatement(
     Position start,
     bool isPub,
     bool isMut,
-    std::vector<Part::SPtr>&& parts,
-    Node::SPtr pParent = nullptr)
-    : Node(pParent)
+    std::span<Part::Ptr const> parts)
+    : Node(Kind::LetStatement)
     , d_start(start)
     , d_isPub(isPub)
     , d_isMut(isMut)
-    , d_parts(std::move(parts))
+    , d_parts(parts)
   {}
 
   virtual Position start() const override { return d_start; }
@@ -43,14 +46,14 @@ public:
 
   bool isPub() const { return d_isPub; }
   bool isMut() const { return d_isMut; }
-  std::vector<Part::SPtr> const& parts() const { return d_parts; }
+  std::span<Part::Ptr const> parts() const { return d_parts; }
 
-  static LetStatement::SPtr make_shared(
+  static LetStatement::Ptr make(
+    Arena& arena,
     Position start,
     bool isPub,
     bool isMut,
-    std::vector<Part::SPtr>&& parts,
-    Node::SPtr pParent = nullptr);
+    std::vector<Part::Ptr> const& parts);
 };
 
 } // namespace ast
\ No newline at end of file
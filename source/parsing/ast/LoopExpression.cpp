@@ -8,24 +8,26 @@ namespace
 struct ClauseNode final : public Node
 {
   PTR(ClauseNode)
+  KIND(Clause)
 
 private:
   Token _else;
-  Node::SPtr capture;
-  BlockExpression::SPtr body;
+  Node::Ptr capture;
+  BlockExpression::Ptr body;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
   ClauseNode(
     Token _else,
-    Node::SPtr capture,
-    BlockExpression::SPtr body)
-  : Node(nullptr)
+    Node::Ptr capture,
+    BlockExpression::Ptr body)
+  : Node(Kind::Clause)
   , _else(_else)
   , capture(capture)
   , body(body)
@@ -38,9 +40,10 @@ public:
 };
 
 void ClauseNode::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   subNodes->reserve(2);
@@ -58,9 +61,10 @@ void ClauseNode::toStringData(
 } // anonymous namespace
 
 void LoopExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena* pTemporaries) const
 {
   assert(subNodes->empty());
   subNodes->reserve(4);
@@ -72,7 +76,7 @@ void LoopExpression::toStringData(
   subNodes->push_back(body());
   if (hasElseClause())
   {
-    subNodes->push_back(std::make_shared<ClauseNode>(d_tokElse, d_pElseCapture, d_pElseBody));
+    subNodes->push_back(pTemporaries->make<ClauseNode>(d_tokElse, d_pElseCapture, d_pElseBody));
   }
 
   *nodeName = "Loop";
@@ -82,14 +86,13 @@ void LoopExpression::toStringData(
 
 LoopExpression::LoopExpression(
   Token loop,
-  Node::SPtr pCondition,
-  Node::SPtr pCapture,
-  BlockExpression::SPtr pBody,
+  Node::Ptr pCondition,
+  Node::Ptr pCapture,
+  BlockExpression::Ptr pBody,
   Token _else,
-  Node::SPtr pElseCapture,
-  BlockExpression::SPtr pElseBody,
-  Node::SPtr pParent)
-: LabeledNode(pParent)
+  Node::Ptr pElseCapture,
+  BlockExpression::Ptr pElseBody)
+: LabeledNode(Kind::LoopExpression)
 , d_tokLoop(loop)
 , d_pCondition(pCondition)
 , d_pCapture(pCapture)
@@ -104,34 +107,28 @@ Position LoopExpression::end() const
   return hasElseClause() ? d_pElseBody->end() : d_pBody->end();
 }
 
-LoopExpression::SPtr LoopExpression::make_shared(
-  Token loop,
-  Node::SPtr pCondition,
-  Node::SPtr pCapture,
-  BlockExpression::SPtr pBody,
-  Token _else,
-  Node::SPtr pElseCapture,
-  BlockExpression::SPtr pElseBody,
-  Node::SPtr pParent)
+void LoopExpression::shiftData(PositionShift const& shift)
 {
-  auto pRes = std::make_shared<LoopExpression>(
-    loop, pCondition, pCapture, pBody, _else, pElseCapture, pElseBody, pParent);
-
-  pCondition->setParent(pRes);
-  if (pCapture != nullptr)
-  {
-    pCapture->setParent(pRes);
-  }
-  pBody->setParent(pRes);
-
-  if (pElseCapture != nullptr)
-  {
-    pElseCapture->setParent(pRes);
-  }
-  if (pElseBody != nullptr)
+  LabeledNode::shiftData(shift);
+  d_tokLoop.shift(shift);
+  if (hasElseClause())
   {
-    pElseBody->setParent(pRes);
+    d_tokElse.shift(shift);
   }
+}
 
+LoopExpression::Ptr LoopExpression::make(
+  Arena& arena,
+  Token loop,
+  Node::Ptr pCondition,
+  Node::Ptr pCapture,
+  BlockExpression::Ptr pBody,
+  Token _else,
+  Node::Ptr pElseCapture,
+  BlockExpression::Ptr pElseBody)
+{
+  auto pRes = arena.make<LoopExpression>(
+    loop, pCondition, pCapture, pBody, _else, pElseCapture, pElseBody);
+  pRes->rehash();
   return pRes;
 }
\ No newline at end of file
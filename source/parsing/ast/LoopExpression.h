@@ -13,32 +13,35 @@ namespace ast
 struct LoopExpression final : public LabeledNode
 {
   PTR(LoopExpression)
+  KIND(LoopExpression)
 
 private:
-  Token d_tokLoop;
-  Node::SPtr d_pCondition;
-  Node::SPtr d_pCapture;
-  BlockExpression::SPtr d_pBody;
-  Token d_tokElse;
-  Node::SPtr d_pElseCapture;
-  BlockExpression::SPtr d_pElseBody;
+  CompactToken d_tokLoop;
+  Node::Ptr d_pCondition;
+  Node::Ptr d_pCapture;
+  BlockExpression::Ptr d_pBody;
+  CompactToken d_tokElse;
+  Node::Ptr d_pElseCapture;
+  BlockExpression::Ptr d_pElseBody;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override;
 
 public:
   LoopExpression(
     Token loop,
-    Node::SPtr pCondition,
-    Node::SPtr pCapture,
-    BlockExpression::SPtr pBody,
+    Node::Ptr pCondition,
+    Node::Ptr pCapture,
+    BlockExpression::Ptr pBody,
     Token _else,
-    Node::SPtr pElseCapture,
-    BlockExpression::SPtr pElseBody,
-    Node::SPtr pParent = nullptr);
+    Node::Ptr pElseCapture,
+    BlockExpression::Ptr pElseBody);
 
   virtual Position start() const override { return d_tokLoop.start(); };
   virtual Position end() const override;
@@ -46,24 +49,26 @@ public:
   // TODO check for break statements
   virtual bool isExpression() const override { return true; }
 
-  Node::SPtr condition() const { return d_pCondition; }
+  Token tokLoop() const { return d_tokLoop; }
+  Node::Ptr condition() const { return d_pCondition; }
   bool hasCapture() const { return d_pCapture != nullptr; }
-  Node::SPtr capture() const { return d_pCapture; }
-  BlockExpression::SPtr body() const { return d_pBody; }
+  Node::Ptr capture() const { return d_pCapture; }
+  BlockExpression::Ptr body() const { return d_pBody; }
   bool hasElseClause() const { return d_pElseBody != nullptr; }
+  Token tokElse() const { return d_tokElse; }
   bool hasElseCapture() const { return d_pElseCapture != nullptr; }
-  Node::SPtr elseCapture() const { return d_pElseCapture; }
-  BlockExpression::SPtr elseBody() const { return d_pElseBody; }
+  Node::Ptr elseCapture() const { return d_pElseCapture; }
+  BlockExpression::Ptr elseBody() const { return d_pElseBody; }
 
-  static LoopExpression::SPtr make_shared(
+  static LoopExpression::Ptr make(
+    Arena& arena,
     Token loop,
-    Node::SPtr pCondition,
-    Node::SPtr pCapture,
-    BlockExpression::SPtr pBody,
+    Node::Ptr pCondition,
+    Node::Ptr pCapture,
+    BlockExpression::Ptr pBody,
     Token _else,
-    Node::SPtr pElseCapture,
-    BlockExpression::SPtr pElseBody,
-    Node::SPtr pParent = nullptr);
+    Node::Ptr pElseCapture,
+    BlockExpression::Ptr pElseBody);
 };
 
 } // namespace ast
\ No newline at end of file
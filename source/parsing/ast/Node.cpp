@@ -1,135 +1,248 @@
 #include "parsing/ast/Node.h"
 
+#include <parsing/ast/Walker.h>
+
 #include <fmt/core.h>
 #include <fmt/color.h>
 
+#include <iterator>
+
 using namespace ast;
 
 namespace
 {
 
-std::string hUnderline(std::string const& str)
-{
-  static constexpr auto style = fmt::emphasis::bold | fmt::fg(fmt::color::medium_spring_green);
-  static constexpr auto underlinedStyle = style | fmt::emphasis::underline;
-  static constexpr size_t LEN = 1;
+constexpr auto nameStyle = fmt::emphasis::bold | fmt::fg(fmt::color::medium_spring_green);
+constexpr auto positionStyle = fmt::fg(fmt::color::yellow);
+constexpr auto prefixStyle = fmt::fg(fmt::color::steel_blue);
 
-  return fmt::format(underlinedStyle, "{}", str.substr(0, LEN))
-    + fmt::format(style, "{}", str.substr(LEN));
-}
+// the buffer is written to the file whenever it grows past this
+constexpr size_t flushSize = 64 * 1024;
 
-std::string hNormal(std::string const& str)
+void header(fmt::memory_buffer& out, std::string_view name, Position start, Position end, bool hasChildren)
 {
-  static constexpr auto style = fmt::emphasis::bold | fmt::fg(fmt::color::medium_spring_green);
-  return fmt::format(style, "{}", str);
-}
+  static constexpr auto underlinedStyle = nameStyle | fmt::emphasis::underline;
+  static constexpr size_t LEN = 1;
+
+  auto const it = std::back_inserter(out);
+  if (hasChildren)
+  {
+    fmt::format_to(it, underlinedStyle, "{}", name.substr(0, LEN));
+    fmt::format_to(it, nameStyle, "{}", name.substr(LEN));
+  }
+  else
+  {
+    fmt::format_to(it, nameStyle, "{}", name);
+  }
 
-std::string header(std::string const& name, Position start, Position end, bool hasChildren)
-{
   // TODO {:+1}
-  static constexpr auto style = fmt::fg(fmt::color::yellow);
-  auto const coloredStart = fmt::format(style, "{}", start);
-  auto const coloredEnd = fmt::format(style, "{}", end);
-  return fmt::format("{} ({}, {})", (hasChildren ? hUnderline(name) : hNormal(name)), coloredStart, coloredEnd);
+  fmt::format_to(it, " (");
+  fmt::format_to(it, positionStyle, "{}", start);
+  fmt::format_to(it, ", ");
+  fmt::format_to(it, positionStyle, "{}", end);
+  fmt::format_to(it, ")");
 }
 
-std::string prefix(size_t indent, std::vector<size_t> lines, bool isLast)
+// guides[i] is set if a line has to be drawn in column i
+void prefix(fmt::memory_buffer& out, size_t indent, std::vector<bool> const& guides, bool isLast, std::string& scratch)
 {
   // │ ─ ┌ ┐ └ ┘ ┬ ┴ ├ ┤ ┼
   // ║ ═ ╔ ╗ ╚ ╝ ╦ ╩ ╠ ╣ ╬
 
-  static constexpr auto style = fmt::fg(fmt::color::steel_blue);
   static constexpr auto
     middlePrefix = "├╾",  // ├─ ├╼ ├╾ ╞╾
     lastPrefix = "└╾",    // └─ ╰╼ ╰╾ ╘╾ ⸦
     longLine = "│ ";      // ┆ ┊ ╎
 
-  std::string res = "";
-
   if (indent == 0)
   {
-    return res;
+    return;
   }
 
-  if (indent == 1)
+  scratch.clear();
+  for (size_t i = 0; i < indent - 1; i += 1)
   {
-    return fmt::format(style, "{}", (isLast ? lastPrefix : middlePrefix));
+    scratch += guides[i] ? longLine : "  ";
   }
+  scratch += (isLast ? lastPrefix : middlePrefix);
 
-  size_t front = 0;
-  for (size_t i = 0; i < indent - 1; i += 1)
+  fmt::format_to(std::back_inserter(out), prefixStyle, "{}", scratch);
+}
+
+} // anonymous
+
+void Node::print(fmt::memory_buffer& out) const
+{
+  print(out, nullptr);
+}
+
+void Node::print(std::FILE* pFile) const
+{
+  fmt::memory_buffer out;
+  print(out, pFile);
+}
+
+std::string Node::toString() const
+{
+  fmt::memory_buffer out;
+  print(out);
+  return fmt::to_string(out);
+}
+
+void Node::print(fmt::memory_buffer& out, std::FILE* pFile) const
+{
+  struct Frame
+  {
+    Node const* pNode;
+    size_t indent;
+    bool isLast;
+  };
+
+  // the guide of a column is set by the node in the column after it and
+  // stays valid for all its descendants, so one bit per column is enough
+  std::vector<bool> guides;
+  std::vector<Frame> stack = {{this, 0, true}};
+  std::vector<Node::Ptr> subNodes;
+  std::string name, additionalInfo, scratch;
+  Arena temporaries;
+
+  while (!stack.empty())
   {
-    if (front < lines.size() && lines[front] == i)
+    Frame const frame = stack.back();
+    stack.pop_back();
+
+    if (frame.indent > 0)
     {
-      res += longLine;
-      front += 1;
+      out.push_back('\n');
+
+      size_t const column = frame.indent - 1;
+      if (column == guides.size())
+      {
+        guides.push_back(!frame.isLast);
+      }
+      else
+      {
+        guides[column] = !frame.isLast;
+      }
     }
-    else
+
+    subNodes.clear();
+    name.clear();
+    additionalInfo.clear();
+    frame.pNode->toStringData(&subNodes, &name, &additionalInfo, &temporaries);
+
+    prefix(out, frame.indent, guides, frame.isLast, scratch);
+    header(out, name, frame.pNode->start(), frame.pNode->end(), !subNodes.empty());
+    if (!additionalInfo.empty())
+    {
+      out.push_back(' ');
+      out.append(additionalInfo);
+    }
+    if (frame.pNode->isComptime())
+    {
+      fmt::format_to(std::back_inserter(out), fmt::fg(fmt::color::gray), " comptime");
+    }
+
+    // pushed in reverse so that they are popped in order
+    for (size_t i = subNodes.size(); i > 0; i -= 1)
+    {
+      stack.push_back({subNodes[i - 1], frame.indent + 1, i == subNodes.size()});
+    }
+
+    if (pFile != nullptr && out.size() >= flushSize)
     {
-      res += "  ";
+      std::fwrite(out.data(), 1, out.size(), pFile);
+      out.clear();
     }
   }
-  res += (isLast ? lastPrefix : middlePrefix);
 
-  return fmt::format(style, "{}", res);
+  if (pFile != nullptr)
+  {
+    std::fwrite(out.data(), 1, out.size(), pFile);
+    out.clear();
+  }
 }
 
-template<typename T>
-std::string childrenToString(std::vector<T> const& nodes, size_t indent, std::vector<size_t> lines)
+void Node::shift(PositionShift const& shift)
 {
-  std::string res = "";
-  if (nodes.empty())
+  // hashes do not depend on positions and stay valid
+  std::vector<Node::Ptr> stack = {this};
+  while (!stack.empty())
   {
-    return res;
+    Node::Ptr const pNode = stack.back();
+    stack.pop_back();
+
+    if ((pNode->d_flags & (Comptime | ImplicitComptime)) == Comptime)
+    {
+      pNode->d_comptimeStart = shift(pNode->d_comptimeStart.position());
+    }
+    pNode->shiftData(shift);
+    forEachChild(pNode, [&stack](Node::Ptr pChild) { stack.push_back(pChild); });
   }
+}
 
-  for (size_t i = 0; i < nodes.size() - 1; i += 1)
+Hash Node::hash() const
+{
+  if (d_hashState != HashState::Done)
   {
-    auto newLines = lines; // TODO use set
-    newLines.push_back(indent);
-    std::sort(newLines.begin(), newLines.end());
+    d_hash = structuralHash(this, true).value();
+    d_hashState = HashState::Done;
+  }
+  return d_hash;
+}
 
-    res += nodes[i]->toString(indent + 1, newLines, false) + "\n";
+std::optional<Hash> Node::tryHash() const
+{
+  if (d_hashState == HashState::Unknown)
+  {
+    auto const hash = structuralHash(this, false);
+    d_hash = hash.value_or(Hash());
+    d_hashState = hash.has_value() ? HashState::Done : HashState::Pending;
   }
-  res += nodes[nodes.size() - 1]->toString(indent + 1, lines, true);
 
-  return res;
+  if (d_hashState == HashState::Pending)
+  {
+    return std::nullopt;
+  }
+  return d_hash;
 }
 
-} // anonymous
-
-std::string Node::toString(size_t indent = 0, std::vector<size_t> lines = {}, bool isLast = false) const
+void Node::rehash() const
 {
-  std::vector<Node::SPtr> subNodes;
-  std::string name, additionalInfo;
-  toStringData(&subNodes, &name, &additionalInfo);
-
-  std::string comptime = isComptime()
-    ? fmt::format(fmt::fg(fmt::color::gray), " comptime")
-    : "";
-
-  return fmt::format(
-    "{}{}{}{}",
-    prefix(indent, lines, isLast),
-    header(name, start(), end(), !subNodes.empty()),
-    (additionalInfo.empty() ? "" : (" " + additionalInfo)) + comptime,
-    (subNodes.empty() ? "" : ("\n" + childrenToString(subNodes, indent, lines))));
+  d_hashState = HashState::Unknown;
+  tryHash();
 }
 
-
 void Node::setIsComptime(Token tokComptime)
 {
-  d_tokComptime = tokComptime;
-  d_isComptime = true;
+  assert(tokComptime.tag() == Token::KwComptime && tokComptime.text() == "comptime");
+  assert(tokComptime.start().line == tokComptime.end().line);
+
+  d_comptimeStart = tokComptime.start();
+  d_flags = static_cast<uint8_t>((d_flags & ~ImplicitComptime) | Comptime);
+  rehash();
 }
 
 void Node::setIsComptime(bool value)
 {
-  d_isComptime = value;
+  // nodes can be comptime implicitly, without a comptime keyword
+  d_flags = static_cast<uint8_t>(d_flags & ~(Comptime | ImplicitComptime));
   if (value)
   {
-    // nodes can be comptime implicitly so we need to treat the edge
-    // case where d_isComptime == true without a tokComptime being set
-    d_tokComptime = Token(Token::KwComptime, start(), start(), "");
+    d_flags |= Comptime | ImplicitComptime;
+  }
+  rehash();
+}
+
+Token Node::tokComptime() const
+{
+  if ((d_flags & ImplicitComptime) != 0)
+  {
+    return Token(Token::KwComptime, start(), start(), "");
   }
+
+  static constexpr std::string_view keyword = "comptime";
+  auto const start = d_comptimeStart.position();
+  auto const end = start.isValid() ? Position(start.line, start.column + keyword.size()) : start;
+  return Token(Token::KwComptime, start, end, keyword);
 }
\ No newline at end of file
@@ -3,99 +3,190 @@
 #include <parsing/Position.h>
 #include <parsing/Operator.h>
 
+#include <parsing/ast/Arena.h>
+#include <parsing/ast/CompactToken.h>
+#include <parsing/ast/Hash.h>
+
+#include <fmt/format.h>
+
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <span>
 #include <vector>
-#include <memory>
 
-#define SPTR(type) using SPtr = std::shared_ptr<type>;
-#define WPTR(type) using WPtr = std::weak_ptr<type>;
-#define UPTR(type) using UPtr = std::unique_ptr<type>;
+// nodes are owned by an Arena and referenced by raw pointers
+#define PTR(type) using Ptr = type*;
 
-#define PTR(type) \
-  SPTR(type) \
-  WPTR(type) \
-  UPTR(type)
+// the range of Node::Kind values of a node type and the types deriving from it
+#define KINDS(first, last) \
+  static constexpr Node::Kind FirstKind = Node::Kind::first; \
+  static constexpr Node::Kind LastKind = Node::Kind::last;
+
+#define KIND(kind) KINDS(kind, kind)
 
 namespace ast
 {
 
-struct Node : public std::enable_shared_from_this<Node>
+struct Node
 {
   PTR(Node)
 
+  // Friends
+  friend struct Arena; // assigns ids
+
+public:
+  // The concrete type of a node, the kinds of the types deriving from
+  // a common base are contiguous so is<Base>() is a range check
+  enum class Kind : uint8_t
+  {
+    TypeExpression,
+    FunctionExpression,
+    LetStatement,
+    Part,
+    SwitchExpression,
+    ReturnStatement,
+    BreakStatement,
+    ContinueStatement,
+    DeferStatement,
+
+    // LabeledNode
+    BlockExpression,
+    IfExpression,
+    LoopExpression,
+
+    // TokenExpression
+    SymbolExpression,
+    BuiltinExpression,
+    StringExpression,
+    NumberExpression,
+    BoolExpression,
+    NullExpression,
+    UndefinedExpression,
+    UnreachableExpression,
+
+    // only created while printing
+    Clause,
+    Case,
+  };
+
+  KINDS(TypeExpression, Case)
+
 private:
-  Node::WPtr d_pParent;
-  Token d_tokComptime;
-  bool d_isComptime;
+  enum class HashState : uint8_t
+  {
+    Unknown,
+    Pending, // a lazily parsed function body below was not parsed yet
+    Done,
+  };
 
 protected:
-  Node(Node::SPtr pParent)
-    : d_pParent(pParent)
-    , d_isComptime(false)
+  enum Flags : uint8_t
+  {
+    Comptime = 1 << 0,
+    ImplicitComptime = 1 << 1, // comptime without a comptime keyword
+    Labeled = 1 << 2, // LabeledNode, BreakStatement and ContinueStatement
+  };
+
+private:
+  mutable Hash d_hash;
+  uint32_t d_id;
+  // the comptime keyword's text and tag are known, only its start is kept
+  CompactPosition d_comptimeStart;
+  Kind d_kind;
+  mutable HashState d_hashState;
+
+protected:
+  uint8_t d_flags;
+
+  explicit Node(Kind kind)
+    : d_hash()
+    , d_id(0)
+    , d_comptimeStart()
+    , d_kind(kind)
+    , d_hashState(HashState::Unknown)
+    , d_flags(0)
   {}
 
+  // Recomputes the hash once the node is complete, factories call it after
+  // building a node and setters after changing it. The hashes of children
+  // are computed first so a tree is hashed bottom-up while it is built.
+  void rehash() const;
+
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const = 0;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const = 0; // owns nodes created only for printing
+
+  // Moves the positions the node keeps itself, those of its children are
+  // moved by shift()
+  virtual void shiftData(PositionShift const&) {}
 
 public:
   virtual ~Node() = default;
 
-  bool isComptime() const { return d_isComptime; }
+  Kind kind() const { return d_kind; }
+  // Unique among the nodes of an arena and its forks, see ParentTable
+  uint32_t id() const { return d_id; }
+
+  bool isComptime() const { return (d_flags & Comptime) != 0; }
   void setIsComptime(Token tokComptime);
   void setIsComptime(bool value);
-  Token tokComptime() const { return d_tokComptime; }
+  // Zero-width at start() for nodes that are comptime without the keyword
+  Token tokComptime() const;
 
   virtual Position start() const = 0;
   virtual Position end() const = 0;
   virtual bool isExpression() const = 0;
 
-  void setParent(Node::SPtr pParent) { d_pParent = pParent; }
-
-  template<typename NodeT = Node>
-  std::weak_ptr<NodeT> parent() const
-  {
-    if (auto pSharedParent = d_pParent.lock(); pSharedParent != nullptr)
-    {
-      auto pParentAsNodeT = std::dynamic_pointer_cast<NodeT>(pSharedParent);
-      assert(pParentAsNodeT != nullptr);
-      return pParentAsNodeT;
-    }
-    return std::weak_ptr<NodeT>();
-  }
+  // Structural hash of the subtree, equal for subtrees that only differ in
+  // positions. Parses lazily parsed function bodies below the node.
+  Hash hash() const;
+  // The hash if no lazily parsed function body below the node has to be parsed
+  std::optional<Hash> tryHash() const;
 
+  // The node must not be null, see isAndNonNull and asOrNull
   template<typename NodeT>
   bool is() const
   {
-    #pragma GCC diagnostic push
-    #pragma GCC diagnostic ignored "-Wnonnull-compare"
-
-    return dynamic_cast<NodeT const*>(this) != nullptr;
-
-    #pragma GCC diagnostic pop
+    return d_kind >= NodeT::FirstKind && d_kind <= NodeT::LastKind;
   }
 
   template<typename NodeT>
-  std::shared_ptr<NodeT> as()
+  NodeT* as()
   {
-    #pragma GCC diagnostic push
-    #pragma GCC diagnostic ignored "-Wnonnull-compare"
-
-    if (this == nullptr)
-    {
-      return nullptr;
-    }
+    assert(is<NodeT>());
+    return static_cast<NodeT*>(this);
+  }
 
-    #pragma GCC diagnostic pop
+  // Writes the tree rooted at this node, one line per node and without a
+  // trailing newline. Runs in time linear in the size of the output.
+  void print(fmt::memory_buffer& out) const;
+  void print(std::FILE* pFile) const;
+  std::string toString() const;
 
-    auto pRes = std::dynamic_pointer_cast<NodeT>(shared_from_this());
-    assert(pRes != nullptr);
-    return pRes;
-  }
+  // Moves the positions of the subtree in place, for subtrees reused after
+  // an edit moved their text. Parses lazily parsed function bodies below
+  // the node.
+  void shift(PositionShift const& shift);
 
-  std::string toString(size_t indent, std::vector<size_t> lines, bool isLast) const;
-  std::string toString() const { return toString(0, {}, true); }
+private:
+  // Writes out to pFile, if not null, whenever it grows large
+  void print(fmt::memory_buffer& out, std::FILE* pFile) const;
 };
 
+template<typename NodeT>
+bool isAndNonNull(Node const* pNode)
+{
+  return pNode != nullptr && pNode->is<NodeT>();
+}
+
+template<typename NodeT>
+NodeT* asOrNull(Node* pNode)
+{
+  return pNode != nullptr ? pNode->as<NodeT>() : nullptr;
+}
+
 } // namespace ast
\ No newline at end of file
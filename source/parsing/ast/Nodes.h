@@ -15,7 +15,6 @@
 #include <parsing/ast/ContinueStatement.h>
 #include <parsing/ast/DeferStatement.h>
 
-#undef SPTR
-#undef WPTR
-#undef UPTR
-#undef PTR
\ No newline at end of file
+#undef PTR
+#undef KINDS
+#undef KIND
\ No newline at end of file
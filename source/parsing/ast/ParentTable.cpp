@@ -0,0 +1,25 @@
+#include "parsing/ast/ParentTable.h"
+
+#include <parsing/ast/Walker.h>
+
+using namespace ast;
+
+ParentTable::ParentTable(Node::Ptr pRoot)
+{
+  std::vector<Node::Ptr> stack = {pRoot};
+  while (!stack.empty())
+  {
+    auto const pNode = stack.back();
+    stack.pop_back();
+
+    forEachChild(pNode, [&](Node::Ptr pChild)
+    {
+      if (pChild->id() >= d_parents.size())
+      {
+        d_parents.resize(pChild->id() + size_t(1), nullptr);
+      }
+      d_parents[pChild->id()] = pNode;
+      stack.push_back(pChild);
+    });
+  }
+}
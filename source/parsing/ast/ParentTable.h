@@ -0,0 +1,40 @@
+#pragma once
+
+#include <parsing/ast/Node.h>
+
+#include <vector>
+
+namespace ast
+{
+
+// Parent links of a tree kept out of the nodes, indexed by Node::id().
+// Nodes are shared between versions of a tree by the incremental parser so
+// a node has a parent only relative to a root.
+//
+// The nodes of the tree must come from one arena and its forks.
+struct ParentTable final
+{
+private:
+  // Data
+  std::vector<Node::Ptr> d_parents;
+
+public:
+  // Constructors
+  // One pass over the tree, parses the bodies of lazily parsed functions
+  explicit ParentTable(Node::Ptr pRoot);
+
+  // Methods
+  // nullptr for the root and for nodes that are not part of the tree
+  template<typename NodeT = Node>
+  NodeT* parent(Node const* pNode) const
+  {
+    auto const id = pNode->id();
+    if (id >= d_parents.size() || d_parents[id] == nullptr)
+    {
+      return nullptr;
+    }
+    return d_parents[id]->template as<NodeT>();
+  }
+};
+
+} // namespace ast
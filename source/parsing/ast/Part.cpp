@@ -1,14 +1,12 @@
 #include "parsing/ast/Part.h"
 
-#include <parsing/ast/TypeExpression.h>
-#include <parsing/ast/FunctionExpression.h>
-
 using namespace ast;
 
 void Part::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   subNodes->reserve(3);
@@ -22,24 +20,8 @@ void Part::toStringData(
     subNodes->push_back(value());
   }
 
-  *nodeName = "Part";
-  auto const pParent = parent().lock();
-  if (pParent->is<TypeExpression>())
-  {
-    auto const tag = pParent->as<TypeExpression>()->tag();
-    if (tag == TypeExpression::Struct)
-    {
-      *nodeName = "Field";
-    }
-    else
-    {
-      *nodeName = "Variant";
-    }
-  }
-  else if (pParent->is<FunctionExpression>())
-  {
-    *nodeName = "Parameter";
-  }
+  static constexpr char const* names[] = {"Part", "Field", "Variant", "Parameter"};
+  *nodeName = names[d_role];
 
   *additionalInfo = "";
 }
@@ -55,21 +37,13 @@ Position Part::end() const
     : d_pAsign->end();
 }
 
-Part::SPtr Part::make_shared(
-  Node::SPtr pAsign,
-  Node::SPtr pType,
-  Node::SPtr pValue,
-  Node::SPtr pParent)
+Part::Ptr Part::make(
+  Arena& arena,
+  Node::Ptr pAsign,
+  Node::Ptr pType,
+  Node::Ptr pValue)
 {
-  auto pRes = std::make_shared<Part>(pAsign, pType, pValue, pParent);
-  pAsign->setParent(pRes);
-  if (pType != nullptr)
-  {
-    pType->setParent(pRes);
-  }
-  if (pValue != nullptr)
-  {
-    pRes->d_pValue->setParent(pRes);
-  }
+  auto pRes = arena.make<Part>(pAsign, pType, pValue);
+  pRes->rehash();
   return pRes;
 }
\ No newline at end of file
@@ -8,45 +8,61 @@ namespace ast
 struct Part final : public Node
 {
   PTR(Part)
+  KIND(Part)
+
+public:
+  // Types
+  // What the part declares, set by the node it belongs to
+  enum Role : uint8_t
+  {
+    Declaration,
+    Field,
+    Variant,
+    Parameter,
+  };
 
 private:
-  Node::SPtr d_pAsign;
-  Node::SPtr d_pType;
-  Node::SPtr d_pValue;
+  Node::Ptr d_pAsign;
+  Node::Ptr d_pType;
+  Node::Ptr d_pValue;
+  Role d_role;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
   Part(
-    Node::SPtr pAsign,
-    Node::SPtr pType,
-    Node::SPtr pValue,
-    Node::SPtr pParent = nullptr)
-    : Node(pParent)
+    Node::Ptr pAsign,
+    Node::Ptr pType,
+    Node::Ptr pValue)
+    : Node(Kind::Part)
     , d_pAsign(pAsign)
     , d_pType(pType)
     , d_pValue(pValue)
+    , d_role(Declaration)
   {}
 
   virtual Position start() const override { return d_pAsign->start(); }
   virtual Position end() const override;
   virtual bool isExpression() const override { return false; }
 
-  Node::SPtr asign() const { return d_pAsign; }
+  Node::Ptr asign() const { return d_pAsign; }
   bool hasType() const { return d_pType != nullptr; }
-  Node::SPtr type() const { return d_pType; }
+  Node::Ptr type() const { return d_pType; }
   bool hasValue() const { return d_pValue != nullptr; }
-  Node::SPtr value() const { return d_pValue; }
+  Node::Ptr value() const { return d_pValue; }
+  Role role() const { return d_role; }
+  void setRole(Role role) { d_role = role; }
 
-  static Part::SPtr make_shared(
-    Node::SPtr pAsign,
-    Node::SPtr pType,
-    Node::SPtr pValue,
-    Node::SPtr pParent = nullptr);
+  static Part::Ptr make(
+    Arena& arena,
+    Node::Ptr pAsign,
+    Node::Ptr pType,
+    Node::Ptr pValue);
 };
 
 } // namespace ast
\ No newline at end of file
@@ -3,9 +3,10 @@
 using namespace ast;
 
 void ReturnStatement::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   if (value() != nullptr)
@@ -27,15 +28,12 @@ Position ReturnStatement::end() const
   return d_tokReturn.end();
 }
 
-ReturnStatement::SPtr ReturnStatement::make_shared(
+ReturnStatement::Ptr ReturnStatement::make(
+  Arena& arena,
   Token defer,
-  Node::SPtr pValue,
-  Node::SPtr pParent)
+  Node::Ptr pValue)
 {
-  auto pRes = std::make_shared<ReturnStatement>(defer, pValue, pParent);
-  if (pValue != nullptr)
-  {
-    pValue->setParent(pRes);
-  }
+  auto pRes = arena.make<ReturnStatement>(defer, pValue);
+  pRes->rehash();
   return pRes;
 }
\ No newline at end of file
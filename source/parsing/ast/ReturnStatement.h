@@ -8,23 +8,26 @@ namespace ast
 struct ReturnStatement final : public Node
 {
   PTR(ReturnStatement)
+  KIND(ReturnStatement)
 
 private:
-  Token d_tokReturn;
-  Node::SPtr d_pValue;
+  CompactToken d_tokReturn;
+  Node::Ptr d_pValue;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override { d_tokReturn.shift(shift); }
 
 public:
   ReturnStatement(
     Token _return,
-    Node::SPtr pValue,
-    Node::SPtr pParent = nullptr)
-    : Node(pParent)
+    Node::Ptr pValue)
+    : Node(Kind::ReturnStatement)
     , d_tokReturn(_return)
     , d_pValue(pValue)
   {}
@@ -34,12 +37,13 @@ public:
 
   virtual bool isExpression() const override { return false; }
 
-  Node::SPtr value() const { return d_pValue; }
+  Token tokReturn() const { return d_tokReturn; }
+  Node::Ptr value() const { return d_pValue; }
 
-  static ReturnStatement::SPtr make_shared(
+  static ReturnStatement::Ptr make(
+    Arena& arena,
     Token _return,
-    Node::SPtr pValue,
-    Node::SPtr pParent = nullptr);
+    Node::Ptr pValue);
 };
 
 } // namespace ast
\ No newline at end of file
@@ -8,19 +8,21 @@ namespace
 struct CaseNode final : public Node
 {
   PTR(CaseNode)
+  KIND(Case)
 
 private:
   SwitchExpression::Case d_case;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
   CaseNode(SwitchExpression::Case _case)
-    : Node(nullptr)
+    : Node(Kind::Case)
     , d_case(_case)
   {}
 
@@ -31,9 +33,10 @@ public:
 };
 
 void CaseNode::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->size() == 0);
   subNodes->reserve(3);
@@ -52,16 +55,17 @@ void CaseNode::toStringData(
 } // anonymous namespace
 
 void SwitchExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena* pTemporaries) const
 {
   assert(subNodes->size() == 0);
   subNodes->reserve(1 + d_cases.size());
   subNodes->push_back(d_pValue);
   for (auto const& _case : d_cases)
   {
-    subNodes->push_back(std::make_shared<CaseNode>(_case));
+    subNodes->push_back(pTemporaries->make<CaseNode>(_case));
   }
 
   *nodeName = "Switch";
@@ -69,26 +73,21 @@ void SwitchExpression::toStringData(
   *additionalInfo = "";
 }
 
-SwitchExpression::SPtr SwitchExpression::make_shared(
-  Token tokSwitch,
-  Node::SPtr pValue,
-  std::vector<Case>&& cases,
-  Position end,
-  Node::SPtr pParent)
+void SwitchExpression::shiftData(PositionShift const& shift)
 {
-  auto pRes = std::make_shared<SwitchExpression>(
-    tokSwitch, pValue, std::move(cases), end, pParent);
-
-  pValue->setParent(pRes);
-  for (auto& _case : pRes->d_cases)
-  {
-    _case.value->setParent(pRes);
-    if (_case.capture != nullptr)
-    {
-      _case.capture->setParent(pRes);
-    }
-    _case.result->setParent(pRes);
-  }
+  d_tokSwitch.shift(shift);
+  d_end = shift(d_end);
+}
 
+SwitchExpression::Ptr SwitchExpression::make(
+  Arena& arena,
+  Token tokSwitch,
+  Node::Ptr pValue,
+  std::vector<Case> const& cases,
+  Position end)
+{
+  auto pRes = arena.make<SwitchExpression>(
+    tokSwitch, pValue, arena.copy(cases), end);
+  pRes->rehash();
   return pRes;
 }
@@ -13,38 +13,41 @@ namespace ast
 struct SwitchExpression final : public Node
 {
   PTR(SwitchExpression)
+  KIND(SwitchExpression)
 
 public:
   struct Case
   {
-    Node::SPtr value;
-    Node::SPtr capture;
-    Node::SPtr result;
+    Node::Ptr value;
+    Node::Ptr capture;
+    Node::Ptr result;
   };
 
 private:
-  Token d_tokSwitch;
-  Node::SPtr d_pValue;
-  std::vector<Case> d_cases;
+  CompactToken d_tokSwitch;
+  Node::Ptr d_pValue;
+  std::span<Case const> d_cases;
   Position d_end;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override;
 
 public:
   SwitchExpression(
     Token tokSwitch,
-    Node::SPtr pValue,
-    std::vector<Case>&& cases,
-    Position end,
-    Node::SPtr pParent = nullptr)
-    : Node(pParent)
+    Node::Ptr pValue,
+    std::span<Case const> cases,
+    Position end)
+    : Node(Kind::SwitchExpression)
     , d_tokSwitch(tokSwitch)
     , d_pValue(pValue)
-    , d_cases(std::move(cases))
+    , d_cases(cases)
     , d_end(end)
   {}
 
@@ -54,15 +57,16 @@ public:
   // TODO check in sema
   virtual bool isExpression() const override { return true; }
 
-  Node::SPtr value() const { return d_pValue; }
-  std::vector<Case> const& cases() { return d_cases; }
+  Token tokSwitch() const { return d_tokSwitch; }
+  Node::Ptr value() const { return d_pValue; }
+  std::span<Case const> cases() const { return d_cases; }
 
-  static SwitchExpression::SPtr make_shared(
+  static SwitchExpression::Ptr make(
+    Arena& arena,
     Token tokSwitch,
-    Node::SPtr pValue,
-    std::vector<Case>&& cases,
-    Position end,
-    Node::SPtr pParent = nullptr);
+    Node::Ptr pValue,
+    std::vector<Case> const& cases,
+    Position end);
 };
 
 } // namespace ast
\ No newline at end of file
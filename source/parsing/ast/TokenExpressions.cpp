@@ -3,9 +3,10 @@
 using namespace ast;
 
 void SymbolExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   *nodeName = "Identifier";
@@ -13,9 +14,10 @@ void SymbolExpression::toStringData(
 }
 
 void BuiltinExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   *nodeName = "Builtin";
@@ -23,9 +25,10 @@ void BuiltinExpression::toStringData(
 }
 
 void StringExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   *nodeName = "StringLiteral";
@@ -39,9 +42,10 @@ std::string_view StringExpression::value() const
 }
 
 void NumberExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   *nodeName = "NumberLiteral";
@@ -49,9 +53,10 @@ void NumberExpression::toStringData(
 }
 
 void BoolExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   *nodeName = "BoolLiteral";
@@ -59,9 +64,10 @@ void BoolExpression::toStringData(
 }
 
 void NullExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   *nodeName = "Null";
@@ -69,9 +75,10 @@ void NullExpression::toStringData(
 }
 
 void UndefinedExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   *nodeName = "Undefined";
@@ -79,9 +86,10 @@ void UndefinedExpression::toStringData(
 }
 
 void UnreachableExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   *nodeName = "Unreachable";
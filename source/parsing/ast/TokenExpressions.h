@@ -11,20 +11,25 @@ namespace ast
 struct TokenExpression : public Node
 {
   PTR(TokenExpression)
+  KINDS(SymbolExpression, UnreachableExpression)
 
 protected:
-  Token d_token;
+  CompactToken d_token;
 
 protected:
-  TokenExpression(Token token, Node::SPtr pParent = nullptr)
-    : Node(pParent)
+  TokenExpression(Kind kind, Token token)
+    : Node(kind)
     , d_token(token)
   {}
 
+  virtual void shiftData(PositionShift const& shift) override { d_token.shift(shift); }
+
 public:
   virtual Position start() const override { return d_token.start(); }
   virtual Position end() const override { return d_token.end(); }
   virtual bool isExpression() const override { return true; }
+
+  Token token() const { return d_token; }
 };
 
 /* ===================== SymbolExpression ===================== */
@@ -32,16 +37,18 @@ public:
 struct SymbolExpression final : public TokenExpression
 {
   PTR(SymbolExpression)
+  KIND(SymbolExpression)
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
-  SymbolExpression(Token token, Node::SPtr pParent = nullptr)
-    : TokenExpression(token, pParent)
+  SymbolExpression(Token token)
+    : TokenExpression(Kind::SymbolExpression, token)
   {}
 
   std::string_view name() const { return d_token.text(); }
@@ -52,16 +59,18 @@ public:
 struct BuiltinExpression final : public TokenExpression
 {
   PTR(BuiltinExpression)
+  KIND(BuiltinExpression)
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
-  BuiltinExpression(Token token, Node::SPtr pParent = nullptr)
-    : TokenExpression(token, pParent)
+  BuiltinExpression(Token token)
+    : TokenExpression(Kind::BuiltinExpression, token)
   {
     assert(d_token.text()[0] == '@');
   }
@@ -74,16 +83,18 @@ public:
 struct StringExpression final : public TokenExpression
 {
   PTR(StringExpression)
+  KIND(StringExpression)
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
-  StringExpression(Token token, Node::SPtr pParent = nullptr)
-    : TokenExpression(token, pParent)
+  StringExpression(Token token)
+    : TokenExpression(Kind::StringExpression, token)
   {}
 
   std::string_view value() const;
@@ -95,16 +106,18 @@ public:
 struct NumberExpression final : public TokenExpression
 {
   PTR(NumberExpression)
+  KIND(NumberExpression)
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
-  NumberExpression(Token token, Node::SPtr pParent = nullptr)
-    : TokenExpression(token, pParent)
+  NumberExpression(Token token)
+    : TokenExpression(Kind::NumberExpression, token)
   {}
 
   std::string_view valueToString() const { return d_token.text(); }
@@ -115,19 +128,21 @@ public:
 struct BoolExpression final : public TokenExpression
 {
   PTR(BoolExpression)
+  KIND(BoolExpression)
 
 private:
   bool d_value;
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
-  BoolExpression(Token token, bool value, Node::SPtr pParent = nullptr)
-    : TokenExpression(token, pParent)
+  BoolExpression(Token token, bool value)
+    : TokenExpression(Kind::BoolExpression, token)
     , d_value(value)
   {
     assert(token.text() == "true" || token.text() == "false");
@@ -141,16 +156,18 @@ public:
 struct NullExpression final : public TokenExpression
 {
   PTR(NullExpression)
+  KIND(NullExpression)
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
-  NullExpression(Token token, Node::SPtr pParent = nullptr)
-    : TokenExpression(token, pParent)
+  NullExpression(Token token)
+    : TokenExpression(Kind::NullExpression, token)
   {
     assert(token.text() == "null");
   }
@@ -161,16 +178,18 @@ public:
 struct UndefinedExpression final : public TokenExpression
 {
   PTR(UndefinedExpression)
+  KIND(UndefinedExpression)
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
-  UndefinedExpression(Token token, Node::SPtr pParent = nullptr)
-    : TokenExpression(token, pParent)
+  UndefinedExpression(Token token)
+    : TokenExpression(Kind::UndefinedExpression, token)
   {
     assert(token.text() == "undefined");
   }
@@ -181,16 +200,18 @@ public:
 struct UnreachableExpression final : public TokenExpression
 {
   PTR(UnreachableExpression)
+  KIND(UnreachableExpression)
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
 
 public:
-  UnreachableExpression(Token token, Node::SPtr pParent = nullptr)
-    : TokenExpression(token, pParent)
+  UnreachableExpression(Token token)
+    : TokenExpression(Kind::UnreachableExpression, token)
   {
     assert(token.text() == "unreachable");
   }
@@ -3,9 +3,10 @@
 using namespace ast;
 
 void TypeExpression::toStringData(
-  std::vector<Node::SPtr>* subNodes,
+  std::vector<Node::Ptr>* subNodes,
   std::string* nodeName,
-  std::string* additionalInfo) const
+  std::string* additionalInfo,
+  Arena*) const
 {
   assert(subNodes->empty());
   // TODO: size, aligmnent, wasted bits
@@ -24,48 +25,42 @@ void TypeExpression::toStringData(
   *additionalInfo = fmt::to_string(tag());
 }
 
-std::vector<LetStatement::SPtr> TypeExpression::decls() const
+void TypeExpression::shiftData(PositionShift const& shift)
 {
-  std::vector<LetStatement::SPtr> res;
+  d_start = shift(d_start);
+  d_end = shift(d_end);
+}
+
+std::vector<LetStatement::Ptr> TypeExpression::decls() const
+{
+  std::vector<LetStatement::Ptr> res;
   res.reserve(d_declsPre.size() + d_declsPost.size());
   res.insert(res.end(), d_declsPre.begin(), d_declsPre.end());
   res.insert(res.end(), d_declsPost.begin(), d_declsPost.end());
   return res;
 }
 
-TypeExpression::SPtr TypeExpression::make_shared(
+TypeExpression::Ptr TypeExpression::make(
+    Arena& arena,
     Tag tag,
     Position start,
     Position end,
-    std::vector<Part::SPtr>&& fields,
-    std::vector<LetStatement::SPtr>&& declsPre,
-    std::vector<LetStatement::SPtr>&& declsPost,
-    Node::SPtr pUnderlyingType,
-    Node::SPtr pParent)
+    std::vector<Part::Ptr> const& fields,
+    std::vector<LetStatement::Ptr> const& declsPre,
+    std::vector<LetStatement::Ptr> const& declsPost,
+    Node::Ptr pUnderlyingType)
 {
-  auto pRes = std::make_shared<TypeExpression>(
+  auto pRes = arena.make<TypeExpression>(
     tag, start, end,
-    std::move(fields),
-    std::move(declsPre),
-    std::move(declsPost),
-    pUnderlyingType,
-    pParent);
+    arena.copy(fields),
+    arena.copy(declsPre),
+    arena.copy(declsPost),
+    pUnderlyingType);
 
   for (auto pPart : pRes->d_fields)
   {
-    pPart->setParent(pRes);
-  }
-  for (auto pDecl : pRes->d_declsPre)
-  {
-    pDecl->setParent(pRes);
-  }
-  for (auto pDecl : pRes->d_declsPost)
-  {
-    pDecl->setParent(pRes);
-  }
-  if (pUnderlyingType != nullptr)
-  {
-    pUnderlyingType->setParent(pRes);
+    pPart->setRole(tag == Struct ? Part::Field : Part::Variant);
   }
+  pRes->rehash();
   return pRes;
 }
\ No newline at end of file
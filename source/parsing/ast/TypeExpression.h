@@ -13,6 +13,7 @@ namespace ast
 struct TypeExpression final : public Node
 {
   PTR(TypeExpression)
+  KIND(TypeExpression)
 
 public:
   enum Tag
@@ -26,34 +27,36 @@ private:
   Tag d_tag;
   Position d_start;
   Position d_end;
-  std::vector<Part::SPtr> d_fields;
-  std::vector<LetStatement::SPtr> d_declsPre;
-  std::vector<LetStatement::SPtr> d_declsPost;
-  Node::SPtr d_pUnderlyingType; // in case of enum
+  std::span<Part::Ptr const> d_fields;
+  std::span<LetStatement::Ptr const> d_declsPre;
+  std::span<LetStatement::Ptr const> d_declsPost;
+  Node::Ptr d_pUnderlyingType; // in case of enum
 
 protected:
   virtual void toStringData(
-    std::vector<Node::SPtr>* subNodes,
+    std::vector<Node::Ptr>* subNodes,
     std::string* nodeName,
-    std::string* additionalInfo) const override;
+    std::string* additionalInfo,
+    Arena* pTemporaries) const override;
+
+  virtual void shiftData(PositionShift const& shift) override;
 
 public:
   TypeExpression(
     Tag tag,
     Position start,
     Position end,
-    std::vector<Part::SPtr>&& fields,
-    std::vector<LetStatement::SPtr>&& declsPre,
-    std::vector<LetStatement::SPtr>&& declsPost,
-    Node::SPtr pUnderlyingType = nullptr,
-    Node::SPtr pParent = nullptr)
-    : Node(pParent)
+    std::span<Part::Ptr const> fields,
+    std::span<LetStatement::Ptr const> declsPre,
+    std::span<LetStatement::Ptr const> declsPost,
+    Node::Ptr pUnderlyingType = nullptr)
+    : Node(Kind::TypeExpression)
     , d_tag(tag)
     , d_start(start)
     , d_end(end)
-    , d_fields(std::move(fields))
-    , d_declsPre(std::move(declsPre))
-    , d_declsPost(std::move(declsPost))
+    , d_fields(fields)
+    , d_declsPre(declsPre)
+    , d_declsPost(declsPost)
     , d_pUnderlyingType(pUnderlyingType)
   {}
 
@@ -62,22 +65,22 @@ public:
   virtual bool isExpression() const override { return true; }
 
   Tag tag() const { return d_tag; }
-  std::vector<Part::SPtr> const& fields() const { return d_fields; }
-  std::vector<LetStatement::SPtr> const& declsPre() const { return d_declsPre; }
-  std::vector<LetStatement::SPtr> const& declsPost() const { return d_declsPost; }
-  std::vector<LetStatement::SPtr> decls() const;
+  std::span<Part::Ptr const> fields() const { return d_fields; }
+  std::span<LetStatement::Ptr const> declsPre() const { return d_declsPre; }
+  std::span<LetStatement::Ptr const> declsPost() const { return d_declsPost; }
+  std::vector<LetStatement::Ptr> decls() const;
   bool hasUnderlyingType() const { return d_pUnderlyingType != nullptr; }
-  Node::SPtr underlyingType() const { return d_pUnderlyingType; }
+  Node::Ptr underlyingType() const { return d_pUnderlyingType; }
 
-  static TypeExpression::SPtr make_shared(
+  static TypeExpression::Ptr make(
+    Arena& arena,
     Tag tag,
     Position start,
     Position end,
-    std::vector<Part::SPtr>&& fields,
-    std::vector<LetStatement::SPtr>&& declsPre,
-    std::vector<LetStatement::SPtr>&& declsPost,
-    Node::SPtr pUnderlyingType = nullptr,
-    Node::SPtr pParent = nullptr);
+    std::vector<Part::Ptr> const& fields,
+    std::vector<LetStatement::Ptr> const& declsPre,
+    std::vector<LetStatement::Ptr> const& declsPost,
+    Node::Ptr pUnderlyingType = nullptr);
 };
 
 } // namespace ast
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <parsing/ast/FlatTree.h>
+#include <parsing/ast/Nodes.h>
+
+#include <span>
+#include <vector>
+
+namespace ast
+{
+
+namespace detail
+{
+
+template<typename NodeT>
+std::vector<NodeT*> cast(std::vector<Node::Ptr> const& nodes)
+{
+  std::vector<NodeT*> res;
+  res.reserve(nodes.size());
+  for (auto const pNode : nodes)
+  {
+    res.push_back(pNode->as<NodeT>());
+  }
+  return res;
+}
+
+} // namespace detail
+
+template<typename Tree>
+Node::Ptr unflattenOptional(Tree const& tree, Arena& arena, FlatTree::Index node);
+
+// Rebuilds the pointer based tree rooted at node from anything laid out
+// like a FlatTree, i.e. FlatTree itself and AstCache
+template<typename Tree>
+Node::Ptr unflatten(Tree const& tree, Arena& arena, FlatTree::Index node)
+{
+  auto const nodes = [&](std::span<FlatTree::Index const> indices)
+  {
+    std::vector<Node::Ptr> res;
+    res.reserve(indices.size());
+    for (FlatTree::Index const idx : indices)
+    {
+      res.push_back(unflatten(tree, arena, idx));
+    }
+    return res;
+  };
+
+  Token const tokMain = tree.mainToken(node);
+  FlatTree::Data const data = tree.data(node);
+  Node::Ptr pRes = nullptr;
+
+  switch (tree.kind(node))
+  {
+  case Node::Kind::TypeExpression:
+  {
+    auto const tag =
+      (tokMain.tag() == Token::KwStruct) ? TypeExpression::Struct :
+      (tokMain.tag() == Token::KwEnum) ? TypeExpression::Enum :
+      TypeExpression::Union;
+
+    FlatTree::Index const
+      fieldCount = tree.extra(data.lhs + 1),
+      preCount = tree.extra(data.lhs + 2),
+      postCount = tree.extra(data.lhs + 3),
+      first = data.lhs + 4;
+
+    auto const pUnderlyingType = unflattenOptional(tree, arena, data.rhs);
+    auto const declsPre = detail::cast<LetStatement>(nodes(tree.extra(first, preCount)));
+    auto const fields = detail::cast<Part>(nodes(tree.extra(first + preCount, fieldCount)));
+    auto const declsPost = detail::cast<LetStatement>(nodes(tree.extra(first + preCount + fieldCount, postCount)));
+
+    pRes = TypeExpression::make(
+      arena, tag, tokMain.start(), tree.token(tree.extra(data.lhs)).start(),
+      fields, declsPre, declsPost, pUnderlyingType);
+    break;
+  }
+  case Node::Kind::FunctionExpression:
+  {
+    auto const parameters = detail::cast<Part>(nodes(tree.extra(data.lhs + 2, tree.extra(data.lhs + 1))));
+    auto const pReturnType = unflatten(tree, arena, tree.extra(data.lhs));
+    auto const pBody = unflattenOptional(tree, arena, data.rhs);
+
+    pRes = FunctionExpression::make(
+      arena, tokMain, parameters, pReturnType, asOrNull<BlockExpression>(pBody));
+    break;
+  }
+  case Node::Kind::LetStatement:
+  {
+    auto const parts = detail::cast<Part>(nodes(tree.extra(data.lhs + 1, tree.extra(data.lhs))));
+    pRes = LetStatement::make(arena, tokMain.start(), (data.rhs & FlatTree::Pub) != 0, (data.rhs & FlatTree::Mut) != 0, parts);
+    break;
+  }
+  case Node::Kind::Part:
+  {
+    auto const pAsign = unflatten(tree, arena, data.lhs);
+    auto const pType = unflattenOptional(tree, arena, tree.extra(data.rhs));
+    auto const pValue = unflattenOptional(tree, arena, tree.extra(data.rhs + 1));
+    pRes = Part::make(arena, pAsign, pType, pValue);
+    break;
+  }
+  case Node::Kind::SwitchExpression:
+  {
+    auto const pValue = unflatten(tree, arena, data.lhs);
+
+    std::vector<SwitchExpression::Case> cases;
+    auto const triples = tree.extra(data.rhs + 2, 3 * tree.extra(data.rhs + 1));
+    for (size_t i = 0; i < triples.size(); i += 3)
+    {
+      cases.push_back({
+        unflatten(tree, arena, triples[i]),
+        unflattenOptional(tree, arena, triples[i + 1]),
+        unflatten(tree, arena, triples[i + 2])});
+    }
+
+    pRes = SwitchExpression::make(arena, tokMain, pValue, cases, tree.token(tree.extra(data.rhs)).start());
+    break;
+  }
+  case Node::Kind::ReturnStatement:
+    pRes = ReturnStatement::make(arena, tokMain, unflattenOptional(tree, arena, data.lhs));
+    break;
+  case Node::Kind::BreakStatement:
+  {
+    auto const tokLabel = tree.label(node);
+    pRes = BreakStatement::make(
+      arena, tokMain, tokLabel.has_value(), tokLabel.value_or(Token()), unflattenOptional(tree, arena, data.lhs));
+    break;
+  }
+  case Node::Kind::ContinueStatement:
+  {
+    auto const tokLabel = tree.label(node);
+    pRes = arena.make<ContinueStatement>(tokMain, tokLabel.has_value(), tokLabel.value_or(Token()));
+    break;
+  }
+  case Node::Kind::DeferStatement:
+    pRes = DeferStatement::make(arena, tokMain, unflatten(tree, arena, data.lhs));
+    break;
+  case Node::Kind::BlockExpression:
+  {
+    auto const statements = nodes(tree.extra(data.lhs + 2, tree.extra(data.lhs + 1)));
+    pRes = BlockExpression::make(arena, tokMain.start(), tree.token(tree.extra(data.lhs)).start(), statements);
+    break;
+  }
+  case Node::Kind::IfExpression:
+  {
+    std::vector<IfExpression::Clause> clauses;
+    auto const fields = tree.extra(data.lhs + 1, 5 * tree.extra(data.lhs));
+    for (size_t i = 0; i < fields.size(); i += 5)
+    {
+      clauses.push_back({
+        static_cast<IfExpression::Clause::Tag>(fields[i]),
+        tree.token(fields[i + 1]),
+        unflattenOptional(tree, arena, fields[i + 2]),
+        unflattenOptional(tree, arena, fields[i + 3]),
+        unflatten(tree, arena, fields[i + 4])->template as<BlockExpression>()});
+    }
+    pRes = IfExpression::make(arena, clauses);
+    break;
+  }
+  case Node::Kind::LoopExpression:
+  {
+    auto const pCondition = unflatten(tree, arena, data.lhs);
+    auto const pCapture = unflattenOptional(tree, arena, tree.extra(data.rhs));
+    auto const pBody = unflatten(tree, arena, tree.extra(data.rhs + 1))->template as<BlockExpression>();
+    auto const pElseCapture = unflattenOptional(tree, arena, tree.extra(data.rhs + 3));
+    auto const pElseBody = unflattenOptional(tree, arena, tree.extra(data.rhs + 4));
+
+    pRes = LoopExpression::make(
+      arena, tokMain, pCondition, pCapture, pBody, tree.token(tree.extra(data.rhs + 2)),
+      pElseCapture, asOrNull<BlockExpression>(pElseBody));
+    break;
+  }
+  case Node::Kind::SymbolExpression:
+    pRes = arena.make<SymbolExpression>(tokMain);
+    break;
+  case Node::Kind::BuiltinExpression:
+    pRes = arena.make<BuiltinExpression>(tokMain);
+    break;
+  case Node::Kind::StringExpression:
+    pRes = arena.make<StringExpression>(tokMain);
+    break;
+  case Node::Kind::NumberExpression:
+    pRes = arena.make<NumberExpression>(tokMain);
+    break;
+  case Node::Kind::BoolExpression:
+    pRes = arena.make<BoolExpression>(tokMain, data.lhs != 0);
+    break;
+  case Node::Kind::NullExpression:
+    pRes = arena.make<NullExpression>(tokMain);
+    break;
+  case Node::Kind::UndefinedExpression:
+    pRes = arena.make<UndefinedExpression>(tokMain);
+    break;
+  case Node::Kind::UnreachableExpression:
+    pRes = arena.make<UnreachableExpression>(tokMain);
+    break;
+  case Node::Kind::Clause:
+  case Node::Kind::Case:
+    assert(false && "printing only nodes are never part of a tree");
+    break;
+  }
+
+  if (auto const tok = tree.tokComptime(node); tok.has_value())
+  {
+    pRes->setIsComptime(*tok);
+  }
+  if (auto const tok = tree.label(node); tok.has_value() && pRes->is<LabeledNode>())
+  {
+    pRes->as<LabeledNode>()->setLabel(*tok);
+  }
+  return pRes;
+}
+
+template<typename Tree>
+Node::Ptr unflattenOptional(Tree const& tree, Arena& arena, FlatTree::Index node)
+{
+  return node != FlatTree::Null ? unflatten(tree, arena, node) : nullptr;
+}
+
+} // namespace ast
\ No newline at end of file
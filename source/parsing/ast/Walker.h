@@ -0,0 +1,270 @@
+#pragma once
+
+#include <parsing/ast/Nodes.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ast
+{
+
+// Calls f with pNode cast to its concrete type, the switch over the kind
+// replaces a virtual call. Nodes that only exist while printing are passed
+// as Node.
+template<typename F>
+decltype(auto) dispatch(Node::Ptr pNode, F&& f)
+{
+  switch (pNode->kind())
+  {
+  case Node::Kind::TypeExpression: return f(pNode->as<TypeExpression>());
+  case Node::Kind::FunctionExpression: return f(pNode->as<FunctionExpression>());
+  case Node::Kind::LetStatement: return f(pNode->as<LetStatement>());
+  case Node::Kind::Part: return f(pNode->as<Part>());
+  case Node::Kind::SwitchExpression: return f(pNode->as<SwitchExpression>());
+  case Node::Kind::ReturnStatement: return f(pNode->as<ReturnStatement>());
+  case Node::Kind::BreakStatement: return f(pNode->as<BreakStatement>());
+  case Node::Kind::ContinueStatement: return f(pNode->as<ContinueStatement>());
+  case Node::Kind::DeferStatement: return f(pNode->as<DeferStatement>());
+  case Node::Kind::BlockExpression: return f(pNode->as<BlockExpression>());
+  case Node::Kind::IfExpression: return f(pNode->as<IfExpression>());
+  case Node::Kind::LoopExpression: return f(pNode->as<LoopExpression>());
+  case Node::Kind::SymbolExpression: return f(pNode->as<SymbolExpression>());
+  case Node::Kind::BuiltinExpression: return f(pNode->as<BuiltinExpression>());
+  case Node::Kind::StringExpression: return f(pNode->as<StringExpression>());
+  case Node::Kind::NumberExpression: return f(pNode->as<NumberExpression>());
+  case Node::Kind::BoolExpression: return f(pNode->as<BoolExpression>());
+  case Node::Kind::NullExpression: return f(pNode->as<NullExpression>());
+  case Node::Kind::UndefinedExpression: return f(pNode->as<UndefinedExpression>());
+  case Node::Kind::UnreachableExpression: return f(pNode->as<UnreachableExpression>());
+  case Node::Kind::Clause:
+  case Node::Kind::Case:
+    break;
+  }
+  return f(pNode);
+}
+
+// Calls f for every child of pNode in source order, with the child or with
+// the name of the field holding it and the child. Parses the body of a
+// lazily parsed function like FunctionExpression::body() does.
+template<typename F>
+void forEachChild(Node::Ptr pNode, F&& f)
+{
+  auto const call = [&f](char const* field, Node::Ptr pChild)
+  {
+    if constexpr (std::is_invocable_v<F&, char const*, Node::Ptr>)
+    {
+      f(field, pChild);
+    }
+    else
+    {
+      (void)field;
+      f(pChild);
+    }
+  };
+  auto const optional = [&call](char const* field, Node::Ptr pChild)
+  {
+    if (pChild != nullptr)
+    {
+      call(field, pChild);
+    }
+  };
+
+  switch (pNode->kind())
+  {
+  case Node::Kind::TypeExpression:
+  {
+    auto const pType = pNode->as<TypeExpression>();
+    optional("underlyingType", pType->underlyingType());
+    for (auto const pDecl : pType->declsPre()) call("decls", pDecl);
+    for (auto const pField : pType->fields()) call("fields", pField);
+    for (auto const pDecl : pType->declsPost()) call("decls", pDecl);
+    break;
+  }
+  case Node::Kind::FunctionExpression:
+  {
+    auto const pFn = pNode->as<FunctionExpression>();
+    for (auto const pParameter : pFn->parameters()) call("parameters", pParameter);
+    call("returnType", pFn->returnType());
+    if (!pFn->isType())
+    {
+      call("body", pFn->body());
+    }
+    break;
+  }
+  case Node::Kind::LetStatement:
+    for (auto const pPart : pNode->as<LetStatement>()->parts()) call("parts", pPart);
+    break;
+  case Node::Kind::Part:
+  {
+    auto const pPart = pNode->as<Part>();
+    call("asign", pPart->asign());
+    optional("type", pPart->type());
+    optional("value", pPart->value());
+    break;
+  }
+  case Node::Kind::SwitchExpression:
+  {
+    auto const pSwitch = pNode->as<SwitchExpression>();
+    call("value", pSwitch->value());
+    for (auto const& _case : pSwitch->cases())
+    {
+      call("caseValue", _case.value);
+      optional("caseCapture", _case.capture);
+      call("caseResult", _case.result);
+    }
+    break;
+  }
+  case Node::Kind::ReturnStatement:
+    optional("value", pNode->as<ReturnStatement>()->value());
+    break;
+  case Node::Kind::BreakStatement:
+    optional("value", pNode->as<BreakStatement>()->value());
+    break;
+  case Node::Kind::DeferStatement:
+    call("target", pNode->as<DeferStatement>()->target());
+    break;
+  case Node::Kind::BlockExpression:
+    for (auto const pStatement : pNode->as<BlockExpression>()->statements()) call("statements", pStatement);
+    break;
+  case Node::Kind::IfExpression:
+    for (auto const& clause : pNode->as<IfExpression>()->clauses())
+    {
+      optional("clauseCondition", clause.condition);
+      optional("clauseCapture", clause.capture);
+      call("clauseBody", clause.body);
+    }
+    break;
+  case Node::Kind::LoopExpression:
+  {
+    auto const pLoop = pNode->as<LoopExpression>();
+    call("condition", pLoop->condition());
+    optional("capture", pLoop->capture());
+    call("body", pLoop->body());
+    optional("elseCapture", pLoop->elseCapture());
+    optional("elseBody", pLoop->elseBody());
+    break;
+  }
+  case Node::Kind::ContinueStatement:
+  case Node::Kind::SymbolExpression:
+  case Node::Kind::BuiltinExpression:
+  case Node::Kind::StringExpression:
+  case Node::Kind::NumberExpression:
+  case Node::Kind::BoolExpression:
+  case Node::Kind::NullExpression:
+  case Node::Kind::UndefinedExpression:
+  case Node::Kind::UnreachableExpression:
+  case Node::Kind::Clause:
+  case Node::Kind::Case:
+    break;
+  }
+}
+
+// Depth-first traversal driving a visitor with typed hooks:
+//
+//   struct CountBlocks
+//   {
+//     size_t count = 0;
+//     void pre(BlockExpression::Ptr) { count += 1; }
+//   };
+//
+// pre(T*) is called before the children of a node and post(T*) after
+// them, the most specific overload for the node's concrete type is chosen
+// at compile time and nodes without a matching hook are skipped. A pre
+// hook returning false skips the children and the post hook of the node.
+//
+// The traversal keeps its own stack instead of recursing so arbitrarily
+// deep trees can be walked, the stack is reused between walks and visiting
+// a node allocates nothing.
+struct Walker final
+{
+private:
+  // Types
+  struct Frame
+  {
+    Node::Ptr pNode;
+    uint32_t depth;
+    bool isExit;
+  };
+
+  // Data
+  std::vector<Frame> d_stack;
+  uint32_t d_depth;
+
+public:
+  // Constructors
+  Walker()
+    : d_depth(0)
+  {}
+
+  // Methods
+  // Depth of the node whose hook is running, the root is at 0
+  uint32_t depth() const { return d_depth; }
+
+  template<typename Visitor>
+  void walk(Node::Ptr pRoot, Visitor& visitor)
+  {
+    d_stack.clear();
+    d_stack.push_back({pRoot, 0, false});
+
+    while (!d_stack.empty())
+    {
+      Frame const frame = d_stack.back();
+      d_stack.pop_back();
+      d_depth = frame.depth;
+
+      if (frame.isExit)
+      {
+        dispatch(frame.pNode, [&](auto pNode) { post(visitor, pNode); });
+        continue;
+      }
+
+      bool const enter = dispatch(frame.pNode, [&](auto pNode) { return pre(visitor, pNode); });
+      if (!enter)
+      {
+        continue;
+      }
+
+      d_stack.push_back({frame.pNode, frame.depth, true});
+
+      // pushed in reverse so that they are popped in source order
+      size_t const first = d_stack.size();
+      forEachChild(frame.pNode, [&](Node::Ptr pChild)
+      {
+        d_stack.push_back({pChild, frame.depth + 1, false});
+      });
+      std::reverse(d_stack.begin() + static_cast<std::ptrdiff_t>(first), d_stack.end());
+    }
+  }
+
+private:
+  template<typename Visitor, typename NodeT>
+  static bool pre(Visitor& visitor, NodeT* pNode)
+  {
+    if constexpr (requires { visitor.pre(pNode); })
+    {
+      if constexpr (std::is_same_v<decltype(visitor.pre(pNode)), bool>)
+      {
+        return visitor.pre(pNode);
+      }
+      else
+      {
+        visitor.pre(pNode);
+      }
+    }
+    return true;
+  }
+
+  template<typename Visitor, typename NodeT>
+  static void post(Visitor& visitor, NodeT* pNode)
+  {
+    if constexpr (requires { visitor.post(pNode); })
+    {
+      visitor.post(pNode);
+    }
+  }
+};
+
+} // namespace ast
\ No newline at end of file
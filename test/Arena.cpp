@@ -0,0 +1,46 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Parser.h>
+#include <parsing/ast/ParentTable.h>
+
+TEST_SUITE_BEGIN("Arena");
+
+TEST_CASE("parsed nodes are owned by the arena")
+{
+  PARSER_TEXT("let a = { let b = 1; };\nc: i32,\n");
+  auto const pRoot = prs.root();
+
+  // root, 2 lets, 2 parts, block, 3 identifiers, number and field, plus
+  // the nodes of speculative parses that were rolled back
+  REQUIRE_GE(arena.nodeCount(), 11);
+  REQUIRE_GT(arena.bytesUsed(), 11 * sizeof(Node));
+
+  auto const pBlock = pRoot->declsPre()[0]->parts()[0]->value();
+  auto const parents = ParentTable(pRoot);
+  REQUIRE_EQ(parents.parent(parents.parent(parents.parent(pBlock))), pRoot);
+}
+
+TEST_CASE("forks are counted and released with their arena")
+{
+  size_t destroyed = 0;
+  struct Counter
+  {
+    size_t* pDestroyed;
+    ~Counter() { *pDestroyed += 1; }
+  };
+
+  {
+    Arena arena;
+    auto& fork = arena.fork();
+    auto const pA = fork.make<SymbolExpression>(t(Token::Symbol, "a"));
+    auto const pB = arena.make<SymbolExpression>(t(Token::Symbol, "b"));
+    fork.destroyWith(fork.make<Counter>(&destroyed));
+
+    REQUIRE_EQ(arena.nodeCount(), 3);
+    REQUIRE_NE(pA->id(), pB->id());
+    REQUIRE_EQ(destroyed, 0);
+  }
+  REQUIRE_EQ(destroyed, 1);
+}
+
+TEST_SUITE_END();
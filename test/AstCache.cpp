@@ -0,0 +1,153 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Error.h>
+#include <parsing/Parser.h>
+#include <parsing/ast/AstCache.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+
+TEST_SUITE_BEGIN("AstCache");
+
+namespace
+{
+
+std::string cachePath()
+{
+  return (std::filesystem::temp_directory_path() / "mir-test-ast.cache").string();
+}
+
+} // anonymous namespace
+
+TEST_CASE("round trip through the ast cache")
+{
+  PARSER_TEXT(sampleSource);
+  auto const pRoot = prs.root();
+  auto const flat = FlatTree(pRoot);
+  AstCache::write(cachePath(), flat, sampleSource);
+
+  Node::Ptr pCopy = nullptr;
+  {
+    auto const cache = AstCache(cachePath(), sampleSource);
+    REQUIRE_EQ(cache.size(), flat.size());
+    REQUIRE(std::ranges::equal(cache.kinds(), flat.kinds()));
+
+    pCopy = cache.toNode(arena);
+  }
+
+  // the rebuilt tree does not point into the unmapped file
+  REQUIRE(equal(pCopy, pRoot));
+  REQUIRE_EQ(pCopy->toString(), pRoot->toString());
+
+  std::filesystem::remove(cachePath());
+}
+
+TEST_CASE("ast cache is read in place")
+{
+  std::string const text = "let a = { b; c; };\nd: i32,\n";
+  PARSER_TEXT(text);
+  auto const flat = FlatTree(prs.root());
+  AstCache::write(cachePath(), flat, text);
+
+  auto const cache = AstCache(cachePath(), text);
+  for (AstCache::Index node = 0; node < cache.size(); node += 1)
+  {
+    REQUIRE_EQ(cache.mainToken(node), flat.mainToken(node));
+    REQUIRE_EQ(cache.data(node).lhs, flat.data(node).lhs);
+    REQUIRE_EQ(cache.data(node).rhs, flat.data(node).rhs);
+  }
+  REQUIRE_EQ(cache.mainToken(5).text(), "b");
+
+  std::filesystem::remove(cachePath());
+}
+
+TEST_CASE("invalid ast cache")
+{
+  {
+    auto file = std::ofstream(cachePath(), std::ios::out | std::ios::trunc);
+    file << "not an ast cache, not an ast cache, not an ast cache";
+  }
+  REQUIRE_THROWS_AS(AstCache(cachePath(), sampleSource), Error);
+
+  std::filesystem::remove(cachePath());
+  REQUIRE_THROWS_AS(AstCache(cachePath(), sampleSource), Error);
+}
+
+TEST_CASE("ast cache of another source")
+{
+  PARSER_TEXT(sampleSource);
+  AstCache::write(cachePath(), FlatTree(prs.root()), sampleSource);
+
+  REQUIRE_NOTHROW(AstCache(cachePath(), sampleSource));
+  REQUIRE_THROWS_AS(AstCache(cachePath(), sampleSource + " "), Error);
+
+  std::string edited = sampleSource;
+  edited[edited.find("f32")] = 'i';
+  REQUIRE_THROWS_AS(AstCache(cachePath(), edited), Error);
+
+  std::filesystem::remove(cachePath());
+}
+
+TEST_CASE("truncated ast cache")
+{
+  PARSER_TEXT(sampleSource);
+  AstCache::write(cachePath(), FlatTree(prs.root()), sampleSource);
+  auto const size = std::filesystem::file_size(cachePath());
+
+  for (auto const newSize : {size - 1, size / 2, uintmax_t(8)})
+  {
+    AstCache::write(cachePath(), FlatTree(prs.root()), sampleSource);
+    std::filesystem::resize_file(cachePath(), newSize);
+    REQUIRE_THROWS_AS(AstCache(cachePath(), sampleSource), Error);
+  }
+
+  std::filesystem::remove(cachePath());
+}
+
+TEST_CASE("out of range values in an ast cache")
+{
+  PARSER_TEXT(sampleSource);
+  auto const flat = FlatTree(prs.root());
+  AstCache::write(cachePath(), flat, sampleSource);
+  auto const size = std::filesystem::file_size(cachePath());
+
+  // the texts of the tokens end the file, they hold no indices
+  std::set<std::string_view> texts;
+  for (auto const& token : flat.tokens())
+  {
+    texts.insert(token.text());
+  }
+  uintmax_t textSize = 0;
+  for (auto const text : texts)
+  {
+    textSize += text.size();
+  }
+
+  // every 32 bit word set to a large index, either the cache is rejected
+  // or the value is not an index and the tree can be rebuilt
+  for (uintmax_t offset = 0; offset + 4 <= size - textSize; offset += 4)
+  {
+    AstCache::write(cachePath(), flat, sampleSource);
+    {
+      auto file = std::fstream(cachePath(), std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(static_cast<std::streamoff>(offset));
+      uint32_t const value = 0x7fff'fff0;
+      file.write(reinterpret_cast<char const*>(&value), sizeof(value));
+    }
+
+    try
+    {
+      auto const cache = AstCache(cachePath(), sampleSource);
+      REQUIRE_NE(cache.toNode(arena), nullptr);
+    }
+    catch (Error const&)
+    {
+    }
+  }
+
+  std::filesystem::remove(cachePath());
+}
+
+TEST_SUITE_END();
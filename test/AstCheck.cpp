@@ -0,0 +1,135 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <command/AstCheck.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+using command::AstCheck;
+
+TEST_SUITE_BEGIN("AstCheck");
+
+namespace
+{
+
+struct TempTree
+{
+  fs::path root;
+
+  TempTree()
+    : root(fs::temp_directory_path() / "mir-test-ast-check")
+  {
+    fs::remove_all(root);
+    fs::create_directories(root / "a" / "b");
+    write("z.mir", "let z = 1;");
+    write("a/y.mir", "let y = ;");
+    write("a/b/x.mir", "x: i32,");
+    write("a/b/w.mir", "let w = fn () void { let v; };");
+    write("a/notes.txt", "let");
+  }
+
+  ~TempTree()
+  {
+    fs::remove_all(root);
+  }
+
+  void write(std::string const& name, std::string const& text) const
+  {
+    std::ofstream(root / name, std::ios::out | std::ios::binary) << text;
+  }
+
+  std::string path(std::string const& name) const
+  {
+    return (root / name).string();
+  }
+};
+
+std::string readAll(std::FILE* pFile)
+{
+  std::string res(static_cast<size_t>(std::ftell(pFile)), '\0');
+  std::rewind(pFile);
+  REQUIRE_EQ(std::fread(res.data(), 1, res.size(), pFile), res.size());
+  return res;
+}
+
+} // anonymous namespace
+
+TEST_CASE("directories are searched for sorted .mir files")
+{
+  TempTree const tree;
+
+  // given files are kept once whatever their extension
+  auto const files = AstCheck::collect({tree.root.string(), tree.path("a/b/x.mir"), tree.path("a/notes.txt")});
+
+  REQUIRE_EQ(files, std::vector<std::string>{
+    tree.path("a/b/w.mir"),
+    tree.path("a/b/x.mir"),
+    tree.path("a/notes.txt"),
+    tree.path("a/y.mir"),
+    tree.path("z.mir"),
+  });
+}
+
+TEST_CASE("errors are reported in the order of the paths")
+{
+  TempTree const tree;
+  auto const root = tree.root.string();
+
+  for (std::string_view jobs : {"-j1", "-j4"})
+  {
+    auto const pOut = std::tmpfile();
+    auto const pErr = std::tmpfile();
+    int const exitCode = AstCheck::exec({"--diagnostics-format=json", jobs, root}, pOut, pErr);
+
+    auto const out = readAll(pOut);
+    auto const w = out.find(tree.path("a/b/w.mir"));
+    auto const y = out.find(tree.path("a/y.mir"));
+    REQUIRE_NE(w, std::string::npos);
+    REQUIRE_NE(y, std::string::npos);
+    REQUIRE_LT(w, y);
+    REQUIRE_EQ(out.find(tree.path("z.mir")), std::string::npos);
+
+    REQUIRE(readAll(pErr).starts_with("checked 4 files in "));
+    REQUIRE(readAll(pErr).ends_with(", 2 with errors\n"));
+    REQUIRE_EQ(exitCode, 1);
+
+    std::fclose(pOut);
+    std::fclose(pErr);
+  }
+}
+
+TEST_CASE("the exit code is 0 without errors")
+{
+  TempTree const tree;
+
+  auto const pOut = std::tmpfile();
+  auto const pErr = std::tmpfile();
+  REQUIRE_EQ(AstCheck::exec({"--diagnostics-format=json", tree.path("z.mir"), tree.path("a/b")}, pOut, pErr), 1);
+  std::fclose(pOut);
+  std::fclose(pErr);
+
+  tree.write("a/b/w.mir", "let w = fn () void { let v = 1; };");
+  auto const pOutFixed = std::tmpfile();
+  auto const pErrFixed = std::tmpfile();
+  REQUIRE_EQ(AstCheck::exec({tree.path("z.mir"), tree.path("a/b")}, pOutFixed, pErrFixed), 0);
+  REQUIRE_EQ(readAll(pOutFixed), "");
+  std::fclose(pOutFixed);
+  std::fclose(pErrFixed);
+}
+
+TEST_CASE("missing files are errors")
+{
+  TempTree const tree;
+
+  auto const pOut = std::tmpfile();
+  auto const pErr = std::tmpfile();
+  REQUIRE_EQ(AstCheck::exec({"--diagnostics-format=json", tree.path("missing.mir")}, pOut, pErr), 1);
+  REQUIRE_NE(readAll(pOut).find("cannot open file"), std::string::npos);
+  std::fclose(pOut);
+  std::fclose(pErr);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,47 @@
+#include <doctest.h>
+#include <Benchmark.h>
+
+TEST_SUITE_BEGIN("Benchmark");
+
+TEST_CASE("nearest-rank percentiles")
+{
+  auto const samples = Samples({5, 1, 4, 2, 3, 10, 9, 8, 7, 6});
+
+  REQUIRE_EQ(samples.size(), 10);
+  REQUIRE_EQ(samples.min(), 1);
+  REQUIRE_EQ(samples.median(), 5);
+  REQUIRE_EQ(samples.percentile(90), 9);
+  REQUIRE_EQ(samples.percentile(99), 10);
+  REQUIRE_EQ(samples.max(), 10);
+
+  REQUIRE_EQ(Samples({}).median(), 0);
+  REQUIRE_EQ(Samples({3}).percentile(1), 3);
+}
+
+TEST_CASE("outliers are rejected")
+{
+  auto const samples = Samples({10, 11, 10, 12, 11, 10, 50, 11, 1});
+  auto const kept = samples.withoutOutliers();
+
+  REQUIRE_EQ(kept.size(), 7);
+  REQUIRE_EQ(kept.min(), 10);
+  REQUIRE_EQ(kept.max(), 12);
+  REQUIRE_EQ(Samples({2, 4}).mean(), 3);
+}
+
+TEST_CASE("time per call")
+{
+  size_t calls = 0;
+  auto const samples = timePerCall([&] { calls += 1; }, 5, std::chrono::microseconds(100));
+
+  REQUIRE_EQ(samples.size(), 5);
+  REQUIRE_GT(calls, 5);
+  REQUIRE_GE(samples.min(), 0);
+}
+
+TEST_CASE("peak resident set size is known")
+{
+  REQUIRE_GT(peakRss(), 0);
+}
+
+TEST_SUITE_END();
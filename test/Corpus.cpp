@@ -0,0 +1,51 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <Corpus.h>
+#include <parsing/Parser.h>
+
+#include <cstdio>
+
+TEST_SUITE_BEGIN("Corpus");
+
+TEST_CASE("generated source parses")
+{
+  for (uint64_t seed : list<uint64_t>{0, 1, 2, 3, 42})
+  {
+    CorpusOptions options;
+    options.size = 8 * 1024;
+    options.maxDepth = 1 + seed % 6;
+    options.seed = seed;
+    auto const text = generateCorpus(options);
+
+    REQUIRE_GE(text.size(), options.size);
+    auto textStream = std::istringstream(text, std::ios::in);
+    auto prs = Parser(Tokenizer(textStream, "<corpus>"), testArena());
+    REQUIRE_NOTHROW(prs.root());
+  }
+}
+
+TEST_CASE("equal options give equal source")
+{
+  CorpusOptions options;
+  options.size = 4 * 1024;
+  options.identifierCount = 8;
+  options.seed = 7;
+
+  auto const text = generateCorpus(options);
+  REQUIRE_EQ(generateCorpus(options), text);
+
+  options.seed = 8;
+  REQUIRE_NE(generateCorpus(options), text);
+
+  // written in chunks the source is the same
+  options.seed = 7;
+  auto const pFile = std::tmpfile();
+  generateCorpus(options, pFile);
+  std::string written(static_cast<size_t>(std::ftell(pFile)), '\0');
+  std::rewind(pFile);
+  REQUIRE_EQ(std::fread(written.data(), 1, written.size(), pFile), written.size());
+  std::fclose(pFile);
+  REQUIRE_EQ(written, text);
+}
+
+TEST_SUITE_END();
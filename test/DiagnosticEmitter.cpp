@@ -0,0 +1,74 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/DiagnosticEmitter.h>
+
+#include <cstdio>
+
+TEST_SUITE_BEGIN("DiagnosticEmitter");
+
+namespace
+{
+
+std::string readAll(std::FILE* pFile)
+{
+  std::string res(static_cast<size_t>(std::ftell(pFile)), '\0');
+  std::rewind(pFile);
+  REQUIRE_EQ(std::fread(res.data(), 1, res.size(), pFile), res.size());
+  return res;
+}
+
+} // anonymous namespace
+
+TEST_CASE("json lines")
+{
+  auto const pFile = std::tmpfile();
+  {
+    auto emitter = DiagnosticEmitter(DiagnosticFormat::Json, pFile);
+    emitter.emit(Error("<emitter-json>", Position(1, 4), "expected \"a\"").note(Position(0, 0), "here"));
+    // written before the next one is emitted
+    REQUIRE_EQ(readAll(pFile),
+      "{\"tag\":\"error\",\"file\":\"<emitter-json>\",\"start\":[1,4],\"end\":[1,5],"
+      "\"message\":\"expected \\\"a\\\"\",\"notes\":[{\"tag\":\"note\",\"file\":\"<emitter-json>\","
+      "\"start\":[0,0],\"end\":[0,1],\"message\":\"here\"}]}\n");
+
+    std::fseek(pFile, 0, SEEK_END);
+    emitter.emit(Error("<emitter-json>", "no position"));
+    REQUIRE_EQ(emitter.count(), 2);
+  }
+  REQUIRE(readAll(pFile).ends_with(
+    "\n{\"tag\":\"error\",\"file\":\"<emitter-json>\",\"start\":null,\"end\":null,"
+    "\"message\":\"no position\",\"notes\":[]}\n"));
+  std::fclose(pFile);
+}
+
+TEST_CASE("sarif log")
+{
+  auto const pFile = std::tmpfile();
+  {
+    auto emitter = DiagnosticEmitter(DiagnosticFormat::Sarif, pFile);
+    emitter.emit(Error("<emitter-sarif>", Position(0, 2), Position(0, 5), "first").note(Position(2, 0), "see"));
+    emitter.emit(Error("<emitter-sarif>", "second"));
+  }
+  REQUIRE_EQ(readAll(pFile),
+    "{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"version\":\"2.1.0\","
+    "\"runs\":[{\"tool\":{\"driver\":{\"name\":\"mir\"}},\"results\":["
+    "{\"level\":\"error\",\"message\":{\"text\":\"first\"},\"locations\":[{\"physicalLocation\":"
+    "{\"artifactLocation\":{\"uri\":\"<emitter-sarif>\"},\"region\":{\"startLine\":1,\"startColumn\":3,"
+    "\"endLine\":1,\"endColumn\":6}}}],\"relatedLocations\":[{\"message\":{\"text\":\"see\"},"
+    "\"physicalLocation\":{\"artifactLocation\":{\"uri\":\"<emitter-sarif>\"},\"region\":{\"startLine\":3,"
+    "\"startColumn\":1,\"endLine\":3,\"endColumn\":2}}}]},"
+    "{\"level\":\"error\",\"message\":{\"text\":\"second\"},\"locations\":[{\"physicalLocation\":"
+    "{\"artifactLocation\":{\"uri\":\"<emitter-sarif>\"}}}],\"relatedLocations\":[]}"
+    "]}]}\n");
+  std::fclose(pFile);
+}
+
+TEST_CASE("formats by name")
+{
+  REQUIRE_EQ(diagnosticFormat("text"), DiagnosticFormat::Text);
+  REQUIRE_EQ(diagnosticFormat("json"), DiagnosticFormat::Json);
+  REQUIRE_EQ(diagnosticFormat("sarif"), DiagnosticFormat::Sarif);
+  REQUIRE_FALSE(diagnosticFormat("xml").has_value());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,70 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/DiagnosticRenderer.h>
+#include <parsing/ParallelParser.h>
+
+TEST_SUITE_BEGIN("DiagnosticRenderer");
+
+TEST_CASE("lines are shown under the header")
+{
+  auto const file = SourceManager::add("<diagnostics-lines>", "let a = 1;\n\tlet bc = a;\n");
+  auto const err = Error(file, Position(1, 5), Position(1, 7), "unused")
+    .note(Position(0, 4), "declared here")
+    .note("same position");
+
+  REQUIRE_EQ(DiagnosticRenderer().render(err),
+    "<diagnostics-lines>:1:5: error: unused\n"
+    "  1 | \tlet bc = a;\n"
+    "    | \t    ^~\n"
+    "<diagnostics-lines>:0:4: note: declared here\n"
+    "  0 | let a = 1;\n"
+    "    |     ^\n"
+    "<diagnostics-lines>:0:4: note: same position\n"
+    "  0 | let a = 1;\n"
+    "    |     ^\n");
+}
+
+TEST_CASE("spans are clamped to their first line")
+{
+  auto const file = SourceManager::add("<diagnostics-spans>", "ab\ncd");
+
+  REQUIRE_EQ(DiagnosticRenderer().render(Error(file, Position(0, 1), Position(1, 1), "multi")),
+    "<diagnostics-spans>:0:1: error: multi\n"
+    "  0 | ab\n"
+    "    |  ^\n");
+  REQUIRE_EQ(DiagnosticRenderer().render(Error(file, Position(1, 2), Position(1, 2), "at end")),
+    "<diagnostics-spans>:1:2: error: at end\n"
+    "  1 | cd\n"
+    "    |   ^\n");
+  REQUIRE_EQ(DiagnosticRenderer().render(Error(file, Position(7, 0), "past the end")),
+    "<diagnostics-spans>:7:0: error: past the end\n");
+}
+
+TEST_CASE("files without text only get the header")
+{
+  REQUIRE_EQ(DiagnosticRenderer().render(Error("<diagnostics-no-text>", Position(2, 3), "msg")),
+    "<diagnostics-no-text>:2:3: error: msg\n");
+  REQUIRE_EQ(DiagnosticRenderer().render(Error("<diagnostics-no-text>", "msg")),
+    "<diagnostics-no-text>: error: msg\n");
+}
+
+TEST_CASE("parse errors")
+{
+  std::string const text = "let a = 1;\nlet b = ;\n";
+  auto const file = SourceManager::add("<diagnostics-parse>", text);
+
+  try
+  {
+    Arena arena;
+    ParallelParser::root(SourceManager::text(file), file, 1, arena);
+    FAIL("unreachable");
+  }
+  catch (Error const& err)
+  {
+    auto const rendered = DiagnosticRenderer().render(err);
+    // the header is the one fmt::formatter<Error::Part> writes
+    REQUIRE(rendered.starts_with(fmt::format("{}\n  1 | let b = ;\n", err.parts().front())));
+  }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,83 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Parser.h>
+#include <parsing/ast/Export.h>
+
+TEST_SUITE_BEGIN("Export");
+
+namespace
+{
+
+std::string exported(Node::Ptr pRoot, ExportFormat format, std::vector<size_t> const& lineStarts = {})
+{
+  fmt::memory_buffer out;
+  exportTree(pRoot, format, lineStarts, out);
+  return fmt::to_string(out);
+}
+
+} // anonymous namespace
+
+TEST_CASE("formats are parsed by name")
+{
+  REQUIRE_EQ(exportFormat("json"), ExportFormat::Json);
+  REQUIRE_EQ(exportFormat("sexpr"), ExportFormat::Sexpr);
+  REQUIRE_FALSE(exportFormat("xml").has_value());
+}
+
+TEST_CASE("json export")
+{
+  PARSER_TEXT("pub let mut a = \"x\\\"\";");
+  auto const pLet = prs.letStatement();
+
+  REQUIRE_EQ(
+    exported(pLet, ExportFormat::Json, {0}),
+    "{\"kind\":\"LetStatement\",\"start\":[0,0],\"end\":[0,21],\"range\":[0,21],\"pub\":true,\"mut\":true,"
+    "\"children\":[{\"kind\":\"Part\",\"field\":\"parts\",\"start\":[0,12],\"end\":[0,21],\"range\":[12,21],"
+    "\"role\":\"declaration\",\"children\":["
+    "{\"kind\":\"SymbolExpression\",\"field\":\"asign\",\"start\":[0,12],\"end\":[0,13],\"range\":[12,13],\"text\":\"a\"},"
+    "{\"kind\":\"StringExpression\",\"field\":\"value\",\"start\":[0,16],\"end\":[0,21],\"range\":[16,21],"
+    "\"text\":\"\\\"x\\\\\\\"\\\"\"}]}]}\n");
+}
+
+TEST_CASE("export with the line starts of the tree's own lines")
+{
+  PARSER_TEXT("\n\n  a;");
+  auto const pSymbol = prs.expression();
+
+  fmt::memory_buffer out;
+  exportTree(pSymbol, ExportFormat::Sexpr, std::vector<size_t>{10}, out, 2);
+  REQUIRE_EQ(
+    fmt::to_string(out),
+    "(SymbolExpression :start (2 2) :end (2 3) :range (12 13) :text \"a\")\n");
+}
+
+TEST_CASE("s-expression export")
+{
+  PARSER_TEXT("comptime blk: { break :blk; }");
+  auto const pBlock = prs.expression();
+
+  REQUIRE_EQ(
+    exported(pBlock, ExportFormat::Sexpr),
+    "(BlockExpression :start (0 14) :end (0 29) :comptime true :label \"blk\" "
+    "(BreakStatement :field \"statements\" :start (0 16) :end (0 26) :label \"blk\"))\n");
+}
+
+TEST_CASE("export does not depend on the depth of the tree")
+{
+  std::string text;
+  for (size_t i = 0; i < 2000; i += 1)
+  {
+    text += "{ ";
+  }
+  for (size_t i = 0; i < 2000; i += 1)
+  {
+    text += "} ";
+  }
+
+  PARSER_TEXT(text);
+  auto const out = exported(prs.expression(), ExportFormat::Sexpr);
+
+  REQUIRE(out.ends_with(std::string(2000, ')') + "\n"));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,49 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Parser.h>
+#include <parsing/ast/FlatTree.h>
+
+#include <algorithm>
+
+TEST_SUITE_BEGIN("FlatTree");
+
+TEST_CASE("round trip through the flat tree")
+{
+  PARSER_TEXT(sampleSource);
+  auto const pRoot = prs.root();
+
+  auto const flat = FlatTree(pRoot);
+  auto const pCopy = flat.toNode(arena);
+
+  REQUIRE(equal(pCopy, pRoot));
+  // also checks positions, labels and comptime
+  REQUIRE_EQ(pCopy->toString(), pRoot->toString());
+}
+
+TEST_CASE("nodes are stored in pre-order")
+{
+  PARSER_TEXT("let a = { b; c; };\nd: i32,\n");
+  auto const flat = FlatTree(prs.root());
+
+  std::vector<Node::Kind> const expected = {
+    Node::Kind::TypeExpression,
+    Node::Kind::LetStatement,
+    Node::Kind::Part,
+    Node::Kind::SymbolExpression,
+    Node::Kind::BlockExpression,
+    Node::Kind::SymbolExpression,
+    Node::Kind::SymbolExpression,
+    Node::Kind::Part,
+    Node::Kind::SymbolExpression,
+    Node::Kind::SymbolExpression,
+  };
+  REQUIRE(std::ranges::equal(flat.kinds(), expected));
+
+  REQUIRE_EQ(flat.mainToken(5).text(), "b");
+  auto const data = flat.data(4);
+  REQUIRE_EQ(flat.extra(data.lhs + 1), 2);
+  REQUIRE_EQ(flat.extra(data.lhs + 2), 5);
+  REQUIRE_EQ(flat.extra(data.lhs + 3), 6);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,95 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Parser.h>
+
+TEST_SUITE_BEGIN("Hash");
+
+namespace
+{
+
+Hash hashOf(std::string const& text)
+{
+  auto textStream = std::istringstream(text, std::ios::in);
+  auto prs = Parser(Tokenizer(textStream, "<file>"), testArena());
+  return prs.root()->hash();
+}
+
+} // anonymous namespace
+
+TEST_CASE("hashes ignore positions")
+{
+  REQUIRE_EQ(hashOf("let a = { b; };"), hashOf("let  a =\n{\n  b;\n};"));
+  REQUIRE_EQ(
+    hashOf("let f = fn(x: i32) void { loop x |y| { break; } };"),
+    hashOf("let f = fn(x: i32) void {\n  loop x |y| {\n    break;\n  }\n};"));
+}
+
+TEST_CASE("hashes tell structures apart")
+{
+  std::vector<std::string> const texts = {
+    "let a = b;",
+    "let a = c;",
+    "let b = a;",
+    "let a: b = b;",
+    "let a = comptime b;",
+    "pub let a = b;",
+    "let mut a = b;",
+    "let a = b, c = d;",
+    "let a = { b; };",
+    "let a = x: { b; };",
+    "let a = y: { b; };",
+    "let a = { b; c; };",
+    "let a = { { b; } c; };",
+    "let a = { b; { c; } };",
+    "let a = if b { c; };",
+    "let a = if b { c; } else { c; };",
+    "let a = if b { c; } else if b { c; };",
+    "let a = true;",
+    "let a = false;",
+    "let a = \"b\";",
+    "let a = 1;",
+    "let a = null;",
+    "let mut a = undefined;",
+    "let a = fn() void;",
+    "let a = fn() void {};",
+    "let a = fn(b: i32) void {};",
+    "a: b,",
+  };
+
+  for (size_t i = 0; i < texts.size(); i += 1)
+  {
+    for (size_t j = i + 1; j < texts.size(); j += 1)
+    {
+      CAPTURE(texts[i]);
+      CAPTURE(texts[j]);
+      REQUIRE_NE(hashOf(texts[i]), hashOf(texts[j]));
+    }
+  }
+}
+
+TEST_CASE("trees are hashed while they are built")
+{
+  PARSER_TEXT("let a = fn(x: i32) i32 { return x; };\nb: i32,");
+  auto const pRoot = prs.root();
+
+  REQUIRE(pRoot->tryHash().has_value());
+  REQUIRE_EQ(*pRoot->tryHash(), pRoot->hash());
+}
+
+TEST_CASE("lazy function bodies are hashed on demand")
+{
+  std::string const text = "let a = fn(x: i32) i32 { return x; };\nb: i32,";
+
+  PARSER_TEXT(text);
+  prs.setLazyFunctionBodies(true);
+  auto const pRoot = prs.root();
+  auto const pFn = pRoot->declsPre()[0]->parts()[0]->value()->as<FunctionExpression>();
+
+  REQUIRE_FALSE(pRoot->tryHash().has_value());
+  REQUIRE(pFn->isBodyLazy());
+
+  REQUIRE_EQ(pRoot->hash(), hashOf(text));
+  REQUIRE_FALSE(pFn->isBodyLazy());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,187 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Parser.h>
+#include <parsing/IncrementalParser.h>
+#include <parsing/ast/ParentTable.h>
+
+TEST_SUITE_BEGIN("IncrementalParser");
+
+namespace
+{
+
+std::string const source = R"MIR(let a = fn(x: i32) i32 {
+  let y = x;
+  return y;
+};
+let b = fn() void {
+  let z = 1;
+  return z;
+};
+let c = 2;
+)MIR";
+
+TypeExpression::Ptr fresh(std::string const& text)
+{
+  auto textStream = std::istringstream(text, std::ios::in);
+  auto prs = Parser(Tokenizer(textStream, "<file>"), testArena());
+  return prs.root();
+}
+
+IncrementalParser::Edit replace(std::string const& text, std::string const& what, std::string const& with)
+{
+  size_t const offset = text.find(what);
+  REQUIRE_NE(offset, std::string::npos);
+  return {offset, what.size(), with};
+}
+
+} // anonymous namespace
+
+TEST_CASE("update matches a fresh parse")
+{
+  auto prs = IncrementalParser(source, "<file>");
+  REQUIRE_EQ(prs.root()->toString(), fresh(source)->toString());
+
+  // same length, positions after the edit are unchanged
+  auto const pRoot = prs.update(replace(prs.source(), "let z = 1;", "let w = 3;"));
+  REQUIRE_EQ(pRoot->toString(), fresh(prs.source())->toString());
+  REQUIRE_GT(prs.reusedCount(), 0);
+
+  // different line count, positions after the edit shift
+  prs.update(replace(prs.source(), "let y = x;", "let y = x;\n  let q = y;"));
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+}
+
+TEST_CASE("update reuses declarations outside the edit")
+{
+  auto prs = IncrementalParser(source, "<file>");
+  auto const pOldA = prs.root()->declsPre()[0];
+  auto const pOldC = prs.root()->declsPre()[2];
+
+  auto const pRoot = prs.update(replace(prs.source(), "let z = 1;", "let w = 3;"));
+
+  REQUIRE_EQ(pRoot->declsPre()[0], pOldA);
+  REQUIRE_EQ(pRoot->declsPre()[2], pOldC);
+  REQUIRE_EQ(ParentTable(pRoot).parent(pRoot->declsPre()[0]), pRoot);
+}
+
+TEST_CASE("update reuses declarations moved by the edit")
+{
+  auto prs = IncrementalParser(source, "<file>");
+  auto const pOldA = prs.root()->declsPre()[0];
+
+  // b and c move one line down
+  auto const pRoot = prs.update({source.find("let b"), 0, "\n"});
+  REQUIRE_EQ(pRoot->toString(), fresh(prs.source())->toString());
+  REQUIRE_EQ(pRoot->declsPre()[0], pOldA);
+  REQUIRE_EQ(prs.reusedCount(), 3);
+
+  // comments are skipped, the let of b is parsed again since the edit
+  // covers it but its function, moved with it, is reused
+  prs.update(replace(prs.source(), "\n\nlet b", "\n// b\nlet b"));
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+  REQUIRE_EQ(prs.reusedCount(), 3);
+}
+
+TEST_CASE("update shares the declarations moved by a new line")
+{
+  std::string text;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    text += fmt::format("let f{} = fn(x: i32) i32 {{\n  let y = x;\n  return y;\n}};\n", i);
+  }
+  auto prs = IncrementalParser(text, "<file>");
+  size_t const parsedBytes = prs.bytesUsed();
+  auto const pOldLast = prs.root()->declsPre().back();
+
+  // all the declarations after the first one move one line down
+  prs.update({text.find("let f1 "), 0, "\n"});
+  REQUIRE_EQ(prs.reusedCount(), 1000);
+  REQUIRE_EQ(prs.root()->declsPre().back(), pOldLast);
+  REQUIRE_LT(prs.bytesUsed() - parsedBytes, parsedBytes / 50);
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+
+  // and back up, the declarations inside moved functions stay reusable
+  prs.update({text.find("let f1 "), 1, ""});
+  prs.update(replace(prs.source(), "return y;\n};\nlet f501", "return x;\n};\nlet f501"));
+  REQUIRE_EQ(prs.reusedCount(), 1000);
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+}
+
+TEST_CASE("update shifts the columns of declarations on the edited line")
+{
+  auto prs = IncrementalParser("let a = 1; let b = { let c = 2; };\nlet d = 3;\n", "<file>");
+
+  prs.update(replace(prs.source(), "1", "100"));
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+  REQUIRE_EQ(prs.reusedCount(), 2);
+
+  prs.update(replace(prs.source(), "let a = 100; ", ""));
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+  REQUIRE_EQ(prs.reusedCount(), 2);
+}
+
+TEST_CASE("update relexes tokens merged by the edit")
+{
+  auto prs = IncrementalParser("let ab = 1;\nlet c = ab; /* x */\nlet d = 2;\n", "<file>");
+
+  prs.update(replace(prs.source(), "ab;", "abx;"));
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+
+  prs.update(replace(prs.source(), " */", " */ let e = 0;"));
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+  REQUIRE_EQ(prs.root()->declsPre().size(), 4);
+}
+
+TEST_CASE("update reparses nodes whose context changed")
+{
+  auto prs = IncrementalParser("let a = { let b = 1; };\n", "<file>");
+
+  prs.update(replace(prs.source(), "= {", "= blk: {"));
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+
+  prs.update(replace(prs.source(), "= blk: {", "= comptime {"));
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+
+  prs.update(replace(prs.source(), "= comptime {", "= {"));
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+}
+
+TEST_CASE("update bounds the memory kept for previous trees")
+{
+  auto prs = IncrementalParser(source, "<file>");
+  size_t const parsedBytes = prs.bytesUsed();
+
+  bool isReleased = false;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    size_t const bytesUsed = prs.bytesUsed();
+    prs.update((i % 2 == 0)
+      ? replace(prs.source(), "let z = ", "let z = 1; let q = ")
+      : replace(prs.source(), "let z = 1; let q = ", "let z = "));
+    isReleased = isReleased || prs.bytesUsed() < bytesUsed;
+    REQUIRE_LE(prs.bytesUsed(), (IncrementalParser::MaxArenaGrowth + 1) * parsedBytes);
+  }
+  REQUIRE(isReleased);
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+}
+
+TEST_CASE("update keeps the previous state on errors")
+{
+  auto prs = IncrementalParser(source, "<file>");
+  auto const pOldRoot = prs.root();
+
+  REQUIRE_THROWS_AS(prs.update(replace(prs.source(), "let c = 2;", "let c = ;")), Error);
+  REQUIRE_EQ(prs.source(), source);
+  REQUIRE_EQ(prs.root(), pOldRoot);
+
+  // declarations moved before the error are moved back
+  REQUIRE_THROWS_AS(prs.update({0, 0, "let s = struct {\n"}), Error);
+  REQUIRE_EQ(prs.source(), source);
+  REQUIRE_EQ(prs.root()->toString(), fresh(source)->toString());
+
+  prs.update(replace(prs.source(), "let c = 2;", "let c = 3;"));
+  REQUIRE_EQ(prs.root()->toString(), fresh(prs.source())->toString());
+}
+
+TEST_SUITE_END();
+
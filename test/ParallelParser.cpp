@@ -0,0 +1,74 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Parser.h>
+#include <parsing/ParallelParser.h>
+
+TEST_SUITE_BEGIN("ParallelParser");
+
+namespace
+{
+
+TypeExpression::Ptr sequential(std::string const& text)
+{
+  auto textStream = std::istringstream(text, std::ios::in);
+  auto prs = Parser(Tokenizer(textStream, "<file>"), testArena());
+  return prs.root();
+}
+
+} // anonymous namespace
+
+TEST_CASE("top-level boundaries skip strings, comments and let parts")
+{
+  auto const boundaries = ParallelParser::topLevelBoundaries("let a = \";\", b = {1;2};\n// ;\nc: T, d: U");
+
+  REQUIRE_EQ(boundaries.size(), 3);
+  REQUIRE_EQ(boundaries[0].offset, 0);
+  REQUIRE_EQ(boundaries[1].offset, 23);
+  REQUIRE_EQ(boundaries[1].position, Position(0, 23));
+  REQUIRE_EQ(boundaries[2].offset, 34);
+  REQUIRE_EQ(boundaries[2].position, Position(2, 5));
+}
+
+TEST_CASE("parallel parse matches sequential parse")
+{
+  auto const pExpected = sequential(sampleSource);
+
+  for (size_t jobs : list<size_t>{1, 2, 4, 16})
+  {
+    Arena arena;
+    auto const pActual = ParallelParser::root(sampleSource, "<file>", jobs, arena);
+
+    REQUIRE(equal(pActual, pExpected));
+    // also checks positions
+    REQUIRE_EQ(pActual->toString(), pExpected->toString());
+  }
+}
+
+TEST_CASE("parallel parse reports the sequential error")
+{
+  std::string const text = "a: i32,\nlet b = 1;\nc: i32,\nlet d = 2;\n";
+
+  std::string expectedMsg;
+  try
+  {
+    sequential(text);
+    FAIL("unreachable");
+  }
+  catch (Error const& err)
+  {
+    expectedMsg = fmt::to_string(err);
+  }
+
+  try
+  {
+    Arena arena;
+    ParallelParser::root(text, "<file>", 4, arena);
+    FAIL("unreachable");
+  }
+  catch (Error const& err)
+  {
+    REQUIRE_EQ(fmt::to_string(err), expectedMsg);
+  }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,79 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Parser.h>
+#include <parsing/ParallelParser.h>
+#include <parsing/ast/ParentTable.h>
+#include <parsing/ast/Walker.h>
+
+TEST_SUITE_BEGIN("ParentTable");
+
+namespace
+{
+
+// checks every child against the table
+void requireParents(ParentTable const& parents, Node::Ptr pRoot)
+{
+  REQUIRE_EQ(parents.parent(pRoot), nullptr);
+
+  std::vector<Node::Ptr> stack = {pRoot};
+  while (!stack.empty())
+  {
+    auto const pNode = stack.back();
+    stack.pop_back();
+
+    forEachChild(pNode, [&](Node::Ptr pChild)
+    {
+      REQUIRE_EQ(parents.parent(pChild), pNode);
+      stack.push_back(pChild);
+    });
+  }
+}
+
+} // anonymous namespace
+
+TEST_CASE("parents of a parsed tree")
+{
+  PARSER_TEXT(
+    "let f = fn(a: i32) i32 {\n"
+    "  let b = blk: {\n"
+    "    if a { break :blk a; } else { break :blk null; }\n"
+    "  };\n"
+    "  loop b |x| { continue; } else |e| { unreachable; }\n"
+    "  defer { b; }\n"
+    "  return switch b { 0 => a, 1 |v| => v, };\n"
+    "};\n"
+    "let E = enum { a, b };\n"
+    "c: i32,\n");
+  prs.setLazyFunctionBodies(true);
+  auto const pRoot = prs.root();
+
+  auto const parents = ParentTable(pRoot);
+  requireParents(parents, pRoot);
+
+  auto const pLet = pRoot->declsPre()[0];
+  auto const pFn = pLet->parts()[0]->value()->as<FunctionExpression>();
+  REQUIRE_EQ(parents.parent<LetStatement>(pLet->parts()[0]), pLet);
+  REQUIRE_EQ(parents.parent<FunctionExpression>(pFn->body()), pFn);
+  REQUIRE_EQ(parents.parent<TypeExpression>(pRoot->fields()[0]), pRoot);
+}
+
+TEST_CASE("parents of a tree built in forks")
+{
+  std::string const text = "let a = 1;\nlet b = { c; };\nd: i32,\ne: u8,\nlet f = 2;\n";
+
+  Arena arena;
+  auto const pRoot = ParallelParser::root(text, "<file>", 4, arena);
+  requireParents(ParentTable(pRoot), pRoot);
+}
+
+TEST_CASE("nodes outside the tree have no parent")
+{
+  PARSER_TEXT("let a = 1;");
+  auto const pRoot = prs.root();
+  auto const parents = ParentTable(pRoot->declsPre()[0]);
+
+  REQUIRE_EQ(parents.parent(pRoot), nullptr);
+  REQUIRE_EQ(parents.parent(testArena().make<SymbolExpression>(t(Token::Symbol, "b"))), nullptr);
+}
+
+TEST_SUITE_END();
@@ -1,6 +1,7 @@
 #include <doctest.h>
 #include <ParsingUtils.h>
 #include <parsing/Parser.h>
+#include <parsing/ast/ParentTable.h>
 
 #define REQUIRE_AST_EQ(ast1, ast2) REQUIRE(equal((ast1), (ast2)))
 
@@ -2210,6 +2211,26 @@ TEST_CASE("comptime requires expression after")
   }
 }
 
+TEST_CASE("comptime and label tokens")
+{
+  PARSER_TEXT("comptime  blk: { break :blk; }");
+  auto const pBlock = prs.expression()->as<BlockExpression>();
+
+  REQUIRE(pBlock->isComptime());
+  REQUIRE_EQ(pBlock->tokComptime(), t(Token::KwComptime, 0, 0, 0, 8, "comptime"));
+  REQUIRE_EQ(pBlock->label(), t(Token::Symbol, 0, 10, 0, 13, "blk"));
+
+  auto const pBreak = pBlock->statements()[0]->as<BreakStatement>();
+  REQUIRE(pBreak->isLabeled());
+  REQUIRE_EQ(pBreak->label(), t(Token::Symbol, 0, 24, 0, 27, "blk"));
+
+  pBlock->setIsComptime(true);
+  REQUIRE_EQ(pBlock->tokComptime(), Token(Token::KwComptime, pBlock->start(), pBlock->start(), ""));
+  pBlock->setIsComptime(false);
+  REQUIRE_FALSE(pBlock->isComptime());
+  REQUIRE(pBlock->isLabeled());
+}
+
 /* ================== Labels ================== */
 
 TEST_CASE("labels require expressions after")
@@ -2230,4 +2251,144 @@ TEST_CASE("labels require expressions after")
   }
 }
 
+/* ================== Lazy function bodies ================== */
+
+TEST_CASE("lazy function bodies are parsed on first access")
+{
+  std::string const text =
+    "let f = fn (a: i32) i32 {\n"
+    "  let g = fn () void { { } };\n"
+    "  let b = blk: { break :blk a; };\n"
+    "  return b;\n"
+    "};";
+
+  std::string expected;
+  {
+    PARSER_TEXT(text);
+    expected = prs.root()->toString();
+  }
+
+  PARSER_TEXT(text);
+  prs.setLazyFunctionBodies(true);
+  auto const pRoot = prs.root();
+
+  auto const pFn = pRoot->declsPre()[0]->parts()[0]->value()->as<FunctionExpression>();
+  REQUIRE(pFn->isBodyLazy());
+  REQUIRE_FALSE(pFn->isType());
+  REQUIRE_EQ(pFn->end(), Position(4, 1));
+
+  REQUIRE_EQ(pRoot->toString(), expected);
+  REQUIRE_FALSE(pFn->isBodyLazy());
+  REQUIRE_EQ(ParentTable(pRoot).parent(pFn->body()), pFn);
+}
+
+TEST_CASE("lazy function bodies are forced in any order")
+{
+  char const* const text =
+    "let a = fn () void { let b = fn () void { x; }; };\n"
+    "let c = fn () void { y; };\n"
+    "let d = fn () void { { z; } };";
+
+  std::string expected;
+  {
+    PARSER_TEXT(text);
+    expected = prs.root()->toString();
+  }
+
+  PARSER_TEXT(text);
+  prs.setLazyFunctionBodies(true);
+  auto const pRoot = prs.root();
+
+  std::vector<FunctionExpression::Ptr> fns;
+  for (auto const& pDecl : pRoot->declsPre())
+  {
+    fns.push_back(pDecl->parts()[0]->value()->as<FunctionExpression>());
+    REQUIRE(fns.back()->isBodyLazy());
+  }
+  fns[2]->body();
+  fns[0]->body();
+  REQUIRE_EQ(pRoot->toString(), expected);
+}
+
+TEST_CASE("lazy function body errors are reported on access")
+{
+  PARSER_TEXT("fn () void { let a; }");
+  prs.setLazyFunctionBodies(true);
+  auto const pFn = prs.expression()->as<FunctionExpression>();
+
+  try
+  {
+    pFn->body();
+    FAIL("unreachable");
+  }
+  catch(Error const& err)
+  {
+    std::string const
+      msg = fmt::to_string(err),
+      expectedMsg = "<file>:0:17: error: constants must be initialized";
+
+    REQUIRE_EQ(msg, expectedMsg);
+  }
+}
+
+TEST_CASE("lazy function bodies must be closed")
+{
+  PARSER_TEXT("fn () void { {}");
+  prs.setLazyFunctionBodies(true);
+  try
+  {
+    prs.expression();
+    FAIL("unreachable");
+  }
+  catch(Error const& err)
+  {
+    std::string const
+      msg = fmt::to_string(err),
+      expectedMsg = "<file>:0:15: error: '}' expected";
+
+    REQUIRE_EQ(msg, expectedMsg);
+  }
+}
+
+TEST_CASE("printed trees draw indent guides")
+{
+  PARSER_TEXT("let a = { if b { c; } d; };\nx: i32,");
+  auto const pRoot = prs.root();
+
+  fmt::memory_buffer out;
+  pRoot->print(out);
+  std::string const printed = fmt::to_string(out);
+
+  // without colors, escapes are ESC [ digits and ';' m
+  std::string actual;
+  for (size_t i = 0; i < printed.size(); i += 1)
+  {
+    if (printed[i] == '\x1b' && i + 1 < printed.size() && printed[i + 1] == '[')
+    {
+      auto const end = printed.find('m', i);
+      REQUIRE_NE(end, std::string::npos);
+      i = end;
+      continue;
+    }
+    actual += printed[i];
+  }
+  std::string const expected =
+    "TypeLiteral (0:0, 1:7) struct\n"
+    "├╾LetStatement (0:0, 0:26)\n"
+    "│ └╾Part (0:4, 0:26)\n"
+    "│   ├╾Identifier (0:4, 0:5) 'a'\n"
+    "│   └╾BlockExpression (0:8, 0:26)\n"
+    "│     ├╾If (0:10, 0:21)\n"
+    "│     │ ├╾Identifier (0:13, 0:14) 'b'\n"
+    "│     │ └╾BlockExpression (0:15, 0:21)\n"
+    "│     │   └╾Identifier (0:17, 0:18) 'c'\n"
+    "│     └╾Identifier (0:22, 0:23) 'd'\n"
+    "└╾Field (1:0, 1:6)\n"
+    "  ├╾Identifier (1:0, 1:1) 'x'\n"
+    "  └╾Identifier (1:3, 1:6) 'i32'";
+
+  REQUIRE_EQ(actual, expected);
+  REQUIRE_EQ(pRoot->toString(), printed);
+}
+
 TEST_SUITE_END();
\ No newline at end of file
@@ -1,7 +1,48 @@
 #include "ParsingUtils.h"
 
+#include <parsing/ast/FlatTree.h>
+
+#include <algorithm>
+#include <optional>
+
+std::string const sampleSource = R"MIR(
+let std = @import, str = "a; b, c";
+// comments; with, separators
+pub let Vec = struct {
+  x: f32,
+  y: f32,
+
+  let zero = fn() Vec {
+    return undefined;
+  };
+};
+/* nested /* block; */ comments, */
+let mut counter: usize = 0;
+let Color = enum u8 { red, green = 2, blue, };
+let f = fn(a: i32, b: i32) i32 {
+  let c = comptime blk: {
+    if a { break :blk b; } else if b |x| { break :blk x; } else { continue; }
+  };
+  outer: loop c |x| { continue :outer; } else |e| { e; }
+  defer { @import; }
+  return switch c { 0 => "a", 1 |y| => true, };
+};
+let T = fn(i32) void;
+a: i32,
+b: Vec,
+c: u8,
+let post = 1;
+)MIR";
+
 /* ================== Constructors ================== */
 
+ast::Arena& testArena()
+{
+  // nodes built by the helpers below live until the test binary exits
+  static ast::Arena arena;
+  return arena;
+}
+
 Token t(Token::Tag tag, size_t startLine, size_t startColumn, size_t endLine, size_t endColumn, std::string const& text)
 {
   return Token(tag, {startLine, startColumn}, {endLine, endColumn}, Intern::string(text));
@@ -12,162 +53,162 @@ Token t(Token::Tag tag, std::string const& text)
   return Token(tag, Position::invalid(), Position::invalid(), Intern::string(text));
 }
 
-SymbolExpression::SPtr symbol(std::string const& name)
+SymbolExpression::Ptr symbol(std::string const& name)
 {
-  return std::make_shared<SymbolExpression>(t(Token::Symbol, name));
+  return testArena().make<SymbolExpression>(t(Token::Symbol, name));
 }
 
-BuiltinExpression::SPtr builtin(std::string const& name)
+BuiltinExpression::Ptr builtin(std::string const& name)
 {
-  return std::make_shared<BuiltinExpression>(t(Token::Symbol, '@' + name));
+  return testArena().make<BuiltinExpression>(t(Token::Symbol, '@' + name));
 }
 
-StringExpression::SPtr string(std::string const& text)
+StringExpression::Ptr string(std::string const& text)
 {
-  return std::make_shared<StringExpression>(t(Token::StringLiteral, '"' + text + '"'));
+  return testArena().make<StringExpression>(t(Token::StringLiteral, '"' + text + '"'));
 }
 
-NumberExpression::SPtr number(std::string const& value)
+NumberExpression::Ptr number(std::string const& value)
 {
-  return std::make_shared<NumberExpression>(t(Token::NumberLiteral, value));
+  return testArena().make<NumberExpression>(t(Token::NumberLiteral, value));
 }
 
-BoolExpression::SPtr boolean(bool value)
+BoolExpression::Ptr boolean(bool value)
 {
-  return std::make_shared<BoolExpression>(t(Token::Symbol, fmt::to_string(value)), value);
+  return testArena().make<BoolExpression>(t(Token::Symbol, fmt::to_string(value)), value);
 }
 
-NullExpression::SPtr null()
+NullExpression::Ptr null()
 {
-  return std::make_shared<NullExpression>(t(Token::Symbol, "null"));
+  return testArena().make<NullExpression>(t(Token::Symbol, "null"));
 }
 
-UndefinedExpression::SPtr undefined()
+UndefinedExpression::Ptr undefined()
 {
-  return std::make_shared<UndefinedExpression>(t(Token::Symbol, "undefined"));
+  return testArena().make<UndefinedExpression>(t(Token::Symbol, "undefined"));
 }
 
-UnreachableExpression::SPtr unreachable()
+UnreachableExpression::Ptr unreachable()
 {
-  return std::make_shared<UnreachableExpression>(t(Token::Symbol, "unreachable"));
+  return testArena().make<UnreachableExpression>(t(Token::Symbol, "unreachable"));
 }
 
-TypeExpression::SPtr _struct(
-  list<LetStatement::SPtr> declsPre, list<Part::SPtr> fields, list<LetStatement::SPtr> declsPost)
+TypeExpression::Ptr _struct(
+  list<LetStatement::Ptr> declsPre, list<Part::Ptr> fields, list<LetStatement::Ptr> declsPost)
 {
-  return TypeExpression::make_shared(TypeExpression::Struct, Position::invalid(), Position::invalid(),
+  return TypeExpression::make(testArena(), TypeExpression::Struct, Position::invalid(), Position::invalid(),
     fields, declsPre, declsPost);
 }
 
-TypeExpression::SPtr _enum(
-  list<LetStatement::SPtr> declsPre, list<Part::SPtr> fields, list<LetStatement::SPtr> declsPost)
+TypeExpression::Ptr _enum(
+  list<LetStatement::Ptr> declsPre, list<Part::Ptr> fields, list<LetStatement::Ptr> declsPost)
 {
-  return TypeExpression::make_shared(TypeExpression::Enum, Position::invalid(), Position::invalid(),
+  return TypeExpression::make(testArena(), TypeExpression::Enum, Position::invalid(), Position::invalid(),
     fields, declsPre, declsPost);
 }
 
-TypeExpression::SPtr _enum(
-  Node::SPtr underlyingType, list<LetStatement::SPtr> declsPre, list<Part::SPtr> fields, list<LetStatement::SPtr> declsPost)
+TypeExpression::Ptr _enum(
+  Node::Ptr underlyingType, list<LetStatement::Ptr> declsPre, list<Part::Ptr> fields, list<LetStatement::Ptr> declsPost)
 {
-  return TypeExpression::make_shared(TypeExpression::Enum, Position::invalid(), Position::invalid(),
+  return TypeExpression::make(testArena(), TypeExpression::Enum, Position::invalid(), Position::invalid(),
     fields, declsPre, declsPost, underlyingType);
 }
 
-TypeExpression::SPtr _union(
-  list<LetStatement::SPtr> declsPre, list<Part::SPtr> fields, list<LetStatement::SPtr> declsPost)
+TypeExpression::Ptr _union(
+  list<LetStatement::Ptr> declsPre, list<Part::Ptr> fields, list<LetStatement::Ptr> declsPost)
 {
-  return TypeExpression::make_shared(TypeExpression::Union, Position::invalid(), Position::invalid(),
+  return TypeExpression::make(testArena(), TypeExpression::Union, Position::invalid(), Position::invalid(),
     fields, declsPre, declsPost);
 }
 
-Part::SPtr part(
-  Node::SPtr asign, Node::SPtr type, Node::SPtr value)
+Part::Ptr part(
+  Node::Ptr asign, Node::Ptr type, Node::Ptr value)
 {
-  return Part::make_shared(asign, type, value);
+  return Part::make(testArena(), asign, type, value);
 }
 
-Part::SPtr part(
-  Node::SPtr asign, Node::SPtr value)
+Part::Ptr part(
+  Node::Ptr asign, Node::Ptr value)
 {
-  return Part::make_shared(asign, nullptr, value);
+  return Part::make(testArena(), asign, nullptr, value);
 }
 
-Part::SPtr field(
-  std::string const& name, Node::SPtr type, Node::SPtr value)
+Part::Ptr field(
+  std::string const& name, Node::Ptr type, Node::Ptr value)
 {
   return part(symbol(name), type, value);
 }
 
-Part::SPtr field(
-  std::string const& name, Node::SPtr value)
+Part::Ptr field(
+  std::string const& name, Node::Ptr value)
 {
   return part(symbol(name), nullptr, value);
 }
 
-LetStatement::SPtr let(
-  bool isPub, bool isMut, list<Part::SPtr> parts)
+LetStatement::Ptr let(
+  bool isPub, bool isMut, list<Part::Ptr> parts)
 {
-  return LetStatement::make_shared(Position::invalid(), isPub, isMut, parts);
+  return LetStatement::make(testArena(), Position::invalid(), isPub, isMut, parts);
 }
 
-LetStatement::SPtr let(
-  bool isPub, bool isMut, std::string const& name, Node::SPtr value)
+LetStatement::Ptr let(
+  bool isPub, bool isMut, std::string const& name, Node::Ptr value)
 {
-  return LetStatement::make_shared(Position::invalid(), isPub, isMut, {part(symbol(name), value)});
+  return LetStatement::make(testArena(), Position::invalid(), isPub, isMut, {part(symbol(name), value)});
 }
 
-LetStatement::SPtr let(
-  bool isPub, bool isMut, std::string const& name, Node::SPtr type, Node::SPtr value)
+LetStatement::Ptr let(
+  bool isPub, bool isMut, std::string const& name, Node::Ptr type, Node::Ptr value)
 {
-  return LetStatement::make_shared(Position::invalid(), isPub, isMut, {part(symbol(name), type, value)});
+  return LetStatement::make(testArena(), Position::invalid(), isPub, isMut, {part(symbol(name), type, value)});
 }
 
-BlockExpression::SPtr block(list<Node::SPtr> statements)
+BlockExpression::Ptr block(list<Node::Ptr> statements)
 {
-  return BlockExpression::make_shared(Position::invalid(), Position::invalid(), statements);
+  return BlockExpression::make(testArena(), Position::invalid(), Position::invalid(), statements);
 }
 
-BlockExpression::SPtr block(std::string const& label, list<Node::SPtr> statements)
+BlockExpression::Ptr block(std::string const& label, list<Node::Ptr> statements)
 {
-  auto res = BlockExpression::make_shared(Position::invalid(), Position::invalid(), statements);
+  auto res = BlockExpression::make(testArena(), Position::invalid(), Position::invalid(), statements);
   res->setLabel(t(Token::Symbol, label));
   return res;
 }
 
-FunctionExpression::SPtr fn(
-  list<Part::SPtr> parameters, Node::SPtr returnType, BlockExpression::SPtr body)
+FunctionExpression::Ptr fn(
+  list<Part::Ptr> parameters, Node::Ptr returnType, BlockExpression::Ptr body)
 {
   Token tok(Token::KwFn, Position::invalid(), Position::invalid(), Intern::string("fn"));
-  return FunctionExpression::make_shared(tok, parameters, returnType, body);
+  return FunctionExpression::make(testArena(), tok, parameters, returnType, body);
 }
 
-IfExpression::SPtr _if(
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr block)
+IfExpression::Ptr _if(
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr block)
 {
   std::vector<IfExpression::Clause> clauses;
   Token tokIf(Token::KwIf, Position::invalid(), Position::invalid(), Intern::string("if"));
   clauses.push_back({IfExpression::Clause::If, tokIf, condition, capture, block});
 
-  return IfExpression::make_shared(std::move(clauses));
+  return IfExpression::make(testArena(), clauses);
 }
 
-IfExpression::SPtr _if(
+IfExpression::Ptr _if(
   std::string const& label,
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr block)
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr block)
 {
   auto const pRes = _if(condition, capture, block);
   pRes->setLabel(t(Token::Symbol, label));
   return pRes;
 }
 
-IfExpression::SPtr _if(
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr block,
+IfExpression::Ptr _if(
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr block,
   list<IfExpression::Clause> clauses)
 {
   std::vector<IfExpression::Clause> temp;
@@ -176,14 +217,14 @@ IfExpression::SPtr _if(
   temp.push_back({IfExpression::Clause::If, t(Token::KwIf, "if"), condition, capture, block});
   temp.insert(temp.end(), clauses);
 
-  return IfExpression::make_shared(std::move(temp));
+  return IfExpression::make(testArena(), temp);
 }
 
-IfExpression::SPtr _if(
+IfExpression::Ptr _if(
   std::string const& label,
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr block,
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr block,
   list<IfExpression::Clause> clauses)
 {
   auto const pRes = _if(condition, capture, block, clauses);
@@ -192,336 +233,135 @@ IfExpression::SPtr _if(
 }
 
 IfExpression::Clause _elseIf(
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr block)
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr block)
 {
   return {IfExpression::Clause::ElseIf, t(Token::KwElse, "else"), condition, capture, block};
 }
 
 IfExpression::Clause _else(
-  Node::SPtr capture,
-  BlockExpression::SPtr block)
+  Node::Ptr capture,
+  BlockExpression::Ptr block)
 {
   return {IfExpression::Clause::Else, t(Token::KwElse, "else"), nullptr, capture, block};
 }
 
-LoopExpression::SPtr loop(
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr body,
-  Node::SPtr elseCapture,
-  BlockExpression::SPtr elseBody)
+LoopExpression::Ptr loop(
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr body,
+  Node::Ptr elseCapture,
+  BlockExpression::Ptr elseBody)
 {
-  return LoopExpression::make_shared(
+  // like the parser, loops without an else keep an empty else token
+  return LoopExpression::make(
+    testArena(),
     t(Token::KwLoop, "loop"), condition, capture, body,
-    t(Token::KwElse, "else"), elseCapture, elseBody);
+    elseBody != nullptr ? t(Token::KwElse, "else") : Token(), elseCapture, elseBody);
 }
 
-LoopExpression::SPtr loop(
+LoopExpression::Ptr loop(
   std::string const& label,
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr body,
-  Node::SPtr elseCapture,
-  BlockExpression::SPtr elseBody)
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr body,
+  Node::Ptr elseCapture,
+  BlockExpression::Ptr elseBody)
 {
   auto pRes = loop(condition, capture, body, elseCapture, elseBody);
   pRes->setLabel(t(Token::Symbol, label));
   return pRes;
 }
 
-SwitchExpression::SPtr _switch(
-  Node::SPtr value,
+SwitchExpression::Ptr _switch(
+  Node::Ptr value,
   list<SwitchExpression::Case> cases)
 {
-  return SwitchExpression::make_shared(
+  return SwitchExpression::make(
+    testArena(),
     t(Token::KwSwitch, "switch"), value, cases, Position::invalid());
 }
 
-ReturnStatement::SPtr _return(
-  Node::SPtr value)
+ReturnStatement::Ptr _return(
+  Node::Ptr value)
 {
-  return ReturnStatement::make_shared(t(Token::Operator, "return"), value);
+  return ReturnStatement::make(testArena(), t(Token::Operator, "return"), value);
 }
 
-BreakStatement::SPtr _break(
+BreakStatement::Ptr _break(
   std::string const label,
-  Node::SPtr value)
+  Node::Ptr value)
 {
-  return BreakStatement::make_shared(
+  return BreakStatement::make(
+    testArena(),
     t(Token::Operator, "break"),
     !label.empty(),
     t(Token::Symbol, label),
     value);
 }
 
-ContinueStatement::SPtr _continue(
+ContinueStatement::Ptr _continue(
   std::string const label)
 {
-  return std::make_shared<ContinueStatement>(
+  return testArena().make<ContinueStatement>(
     t(Token::Operator, "continue"),
     !label.empty(),
     t(Token::Symbol, label));
 }
 
-DeferStatement::SPtr defer(
-  Node::SPtr target)
+DeferStatement::Ptr defer(
+  Node::Ptr target)
 {
-  return DeferStatement::make_shared(t(Token::Operator, "defer"), target);
+  return DeferStatement::make(testArena(), t(Token::Operator, "defer"), target);
 }
 
 /* ================== Equality ================== */
 
-template<typename T>
-std::tuple<std::shared_ptr<T>, std::shared_ptr<T>, bool> nodesAreImpl(
-  Node::SPtr node1, Node::SPtr node2)
+namespace
 {
-  std::shared_ptr<T>
-    node1asT = std::dynamic_pointer_cast<T>(node1),
-    node2asT = std::dynamic_pointer_cast<T>(node2);
 
-  return {node1asT, node2asT, (node1asT != nullptr && node2asT != nullptr)};
+bool sameText(Token const& tok1, Token const& tok2)
+{
+  return tok1.text() == tok2.text();
 }
 
-#define nodesAre(type) auto const [n1, n2, cond] = nodesAreImpl<type>(node1, node2); cond
-
-bool equal(Node::SPtr node1, Node::SPtr node2)
+bool sameText(std::optional<Token> const& tok1, std::optional<Token> const& tok2)
 {
-  if (node1 == nullptr && node2 == nullptr)
-    return true;
+  return tok1.has_value() == tok2.has_value() && (!tok1.has_value() || sameText(*tok1, *tok2));
+}
 
-  if (node1 != nullptr && node2 != nullptr
-    && node1->isComptime() != node2->isComptime())
+// Flat trees of equal shape store their tokens at the same indices,
+// positions are ignored like the tests do
+bool sameStructure(FlatTree const& tree1, FlatTree const& tree2)
+{
+  if (!std::ranges::equal(tree1.kinds(), tree2.kinds())
+    || !std::ranges::equal(tree1.extra(), tree2.extra())
+    || !std::ranges::equal(tree1.tokens(), tree2.tokens(),
+      [](Token const& tok1, Token const& tok2) { return sameText(tok1, tok2); }))
     return false;
 
-  if (nodesAre(SymbolExpression))
-    return n1->name() == n2->name();
-
-  if (nodesAre(BuiltinExpression))
-    return n1->name() == n2->name();
-
-  if (nodesAre(StringExpression))
-    return n1->quotedValue() == n2->quotedValue();
-
-  if (nodesAre(NumberExpression))
-    return n1->valueToString() == n2->valueToString();
-
-  if (nodesAre(BoolExpression))
-    return n1->value() == n2->value();
-
-  if (nodesAre(NullExpression))
-    return true;
-
-  if (nodesAre(UndefinedExpression))
-    return true;
-
-  if (nodesAre(UnreachableExpression))
-    return true;
-
-  if (nodesAre(Part))
-  {
-    if (!equal(n1->asign(), n2->asign()))
-      return false;
-
-    if (!equal(n1->type(), n2->type()))
-      return false;
-
-    return equal(n1->value(), n2->value());
-  }
-
-  if (nodesAre(LetStatement))
-  {
-    if (n1->isPub() != n2->isPub())
-      return false;
-
-    if (n1->isMut() != n2->isMut())
-      return false;
-
-    if (n1->parts().size() != n2->parts().size())
-      return false;
-
-    for (size_t i = 0; i < n1->parts().size(); i += 1)
-    {
-      if (!equal(n1->parts()[i], n2->parts()[i]))
-        return false;
-    }
-    return true;
-  }
-
-  if (nodesAre(BlockExpression))
+  for (FlatTree::Index node = 0; node < tree1.size(); ++node)
   {
-    if (n1->labelName() != n2->labelName())
-      return false;
-
-    if (n1->statements().size() != n2->statements().size())
+    auto const data1 = tree1.data(node), data2 = tree2.data(node);
+    if (data1.lhs != data2.lhs || data1.rhs != data2.rhs
+      || !sameText(tree1.mainToken(node), tree2.mainToken(node))
+      || !sameText(tree1.label(node), tree2.label(node))
+      || !sameText(tree1.tokComptime(node), tree2.tokComptime(node)))
       return false;
-
-    for (size_t i = 0; i < n1->statements().size(); i += 1)
-    {
-      if (!equal(n1->statements()[i], n2->statements()[i]))
-        return false;
-    }
-    return true;
   }
+  return true;
+}
 
-  if (nodesAre(FunctionExpression))
-  {
-    if (!equal(n1->returnType(), n2->returnType()))
-      return false;
-
-    if (n1->parameters().size() != n2->parameters().size())
-      return false;
-
-    for (size_t i = 0; i < n1->parameters().size(); i += 1)
-    {
-      auto const
-        p1 = n1->parameters()[i],
-        p2 = n2->parameters()[i];
-
-      if (!equal(p1, p2))
-        return false;
-    }
-    return true;
-  }
-
-  if (nodesAre(TypeExpression))
-  {
-    if (n1->tag() != n2->tag())
-      return false;
-
-    if (n1->tag() == TypeExpression::Enum
-      && !equal(n1->underlyingType(), n2->underlyingType()))
-      return false;
-
-    if (n1->declsPre().size() != n2->declsPre().size())
-      return false;
-
-    if (n1->fields().size() != n2->fields().size())
-      return false;
-
-    if (n1->declsPost().size() != n2->declsPost().size())
-      return false;
-
-    for (size_t i = 0; i < n1->declsPre().size(); i += 1)
-    {
-      if (!equal(n1->declsPre()[i], n2->declsPre()[i]))
-        return false;
-    }
-    for (size_t i = 0; i < n1->fields().size(); i += 1)
-    {
-      if (!equal(n1->fields()[i], n2->fields()[i]))
-        return false;
-    }
-    for (size_t i = 0; i < n1->declsPost().size(); i += 1)
-    {
-      if (!equal(n1->declsPost()[i], n2->declsPost()[i]))
-        return false;
-    }
-    return true;
-  }
-
-  if (nodesAre(IfExpression))
-  {
-    if (n1->labelName() != n2->labelName())
-      return false;
-
-    if (n1->clauses().size() != n2->clauses().size())
-      return false;
-
-    for (size_t i = 0; i < n1->clauses().size(); i += 1)
-    {
-      auto const&
-        c1 = n1->clauses()[i],
-        c2 = n2->clauses()[i];
-
-      if (c1.tag != c2.tag)
-        return false;
-
-      if (!equal(c1.condition, c2.condition))
-        return false;
-
-      if (!equal(c1.capture, c2.capture))
-        return false;
-
-      return equal(c1.body, c2.body);
-    }
-  }
-
-  if (nodesAre(LoopExpression))
-  {
-    if (n1->labelName() != n2->labelName())
-      return false;
-
-    if (!equal(n1->condition(), n2->condition()))
-      return false;
-
-    if (!equal(n1->capture(), n2->capture()))
-      return false;
-
-    if (!equal(n1->body(), n2->body()))
-      return false;
-
-    if (!equal(n1->elseCapture(), n2->elseCapture()))
-      return false;
-
-    return equal(n1->elseBody(), n2->elseBody());
-  }
-
-  if (nodesAre(SwitchExpression))
-  {
-    if (!equal(n1->value(), n2->value()))
-      return false;
-
-    if (n1->cases().size() != n2->cases().size())
-      return false;
-
-    for (size_t i = 0; i < n1->cases().size(); i += 1)
-    {
-      auto const&
-        c1 = n1->cases()[i],
-        c2 = n2->cases()[i];
-
-      if (!equal(c1.value, c2.value))
-        return false;
-
-      if (!equal(c1.capture, c2.capture))
-        return false;
-
-      if (!equal(c1.result, c2.result))
-        return false;
-    }
-    return true;
-  }
-
-  if (nodesAre(ReturnStatement))
-  {
-    return equal(n1->value(), n2->value());
-  }
-
-  if (nodesAre(BreakStatement))
-  {
-    if (n1->isLabeled() != n2->isLabeled())
-      return false;
-
-    if (n1->isLabeled() && n1->label().text() != n2->label().text())
-      return false;
-
-    return equal(n1->value(), n2->value());
-  }
+} // namespace
 
-  if (nodesAre(ContinueStatement))
-  {
-    if (n1->isLabeled() != n2->isLabeled())
-      return false;
-
-    return n1->isLabeled()
-      && n1->label().text() == n2->label().text();
-  }
+bool equal(Node::Ptr node1, Node::Ptr node2)
+{
+  if (node1 == nullptr || node2 == nullptr)
+    return node1 == node2;
 
-  if (nodesAre(DeferStatement))
-  {
-    return equal(n1->target(), n2->target());
-  }
-  return false;
+  // structural hashes ignore positions like the tests do, equal hashes
+  // are confirmed by comparing the trees
+  return node1->hash() == node2->hash()
+    && sameStructure(FlatTree(node1), FlatTree(node2));
 }
\ No newline at end of file
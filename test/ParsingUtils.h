@@ -26,7 +26,15 @@ using list = std::initializer_list<T>;
 
 #define PARSER_TEXT(text) \
   auto textStream = std::istringstream((text), std::ios::in); \
-  auto prs = Parser(Tokenizer(textStream, "<file>"))
+  ast::Arena arena; \
+  auto prs = Parser(Tokenizer(textStream, "<file>"), arena)
+
+// A source using every kind of node, with comments and separators inside
+// strings and comments, and declarations before and after the fields
+extern std::string const sampleSource;
+
+// owns the nodes built by the helpers below
+ast::Arena& testArena();
 
 Token t(
   Token::Tag tag,
@@ -36,154 +44,154 @@ Token t(
 
 Token t(Token::Tag tag, std::string const& text);
 
-SymbolExpression::SPtr symbol(std::string const& name);
+SymbolExpression::Ptr symbol(std::string const& name);
 
-BuiltinExpression::SPtr builtin(std::string const& name);
+BuiltinExpression::Ptr builtin(std::string const& name);
 
-StringExpression::SPtr string(std::string const& text);
+StringExpression::Ptr string(std::string const& text);
 
-NumberExpression::SPtr number(std::string const& value);
+NumberExpression::Ptr number(std::string const& value);
 
-BoolExpression::SPtr boolean(bool value);
+BoolExpression::Ptr boolean(bool value);
 
-NullExpression::SPtr null();
+NullExpression::Ptr null();
 
-UndefinedExpression::SPtr undefined();
+UndefinedExpression::Ptr undefined();
 
-UnreachableExpression::SPtr unreachable();
+UnreachableExpression::Ptr unreachable();
 
-TypeExpression::SPtr _struct(
-  list<LetStatement::SPtr> declsPre,
-  list<Part::SPtr> fields,
-  list<LetStatement::SPtr> declsPost);
+TypeExpression::Ptr _struct(
+  list<LetStatement::Ptr> declsPre,
+  list<Part::Ptr> fields,
+  list<LetStatement::Ptr> declsPost);
 
-TypeExpression::SPtr _enum(
-  list<LetStatement::SPtr> declsPre,
-  list<Part::SPtr> fields,
-  list<LetStatement::SPtr> declsPost);
+TypeExpression::Ptr _enum(
+  list<LetStatement::Ptr> declsPre,
+  list<Part::Ptr> fields,
+  list<LetStatement::Ptr> declsPost);
 
-TypeExpression::SPtr _enum(
-  Node::SPtr underlyingType,
-  list<LetStatement::SPtr> declsPre,
-  list<Part::SPtr> fields,
-  list<LetStatement::SPtr> declsPost);
+TypeExpression::Ptr _enum(
+  Node::Ptr underlyingType,
+  list<LetStatement::Ptr> declsPre,
+  list<Part::Ptr> fields,
+  list<LetStatement::Ptr> declsPost);
 
-TypeExpression::SPtr _union(
-  list<LetStatement::SPtr> declsPre,
-  list<Part::SPtr> fields,
-  list<LetStatement::SPtr> declsPost);
+TypeExpression::Ptr _union(
+  list<LetStatement::Ptr> declsPre,
+  list<Part::Ptr> fields,
+  list<LetStatement::Ptr> declsPost);
 
-Part::SPtr part(
-  Node::SPtr asign,
-  Node::SPtr type,
-  Node::SPtr value);
+Part::Ptr part(
+  Node::Ptr asign,
+  Node::Ptr type,
+  Node::Ptr value);
 
-Part::SPtr part(
-  Node::SPtr asign,
-  Node::SPtr value);
+Part::Ptr part(
+  Node::Ptr asign,
+  Node::Ptr value);
 
-Part::SPtr field(
+Part::Ptr field(
   std::string const& name,
-  Node::SPtr type,
-  Node::SPtr value);
+  Node::Ptr type,
+  Node::Ptr value);
 
-Part::SPtr field(
+Part::Ptr field(
   std::string const& name,
-  Node::SPtr value);
+  Node::Ptr value);
 
-LetStatement::SPtr let(
+LetStatement::Ptr let(
   bool isPub,
   bool isMut,
-  list<Part::SPtr> parts);
+  list<Part::Ptr> parts);
 
-LetStatement::SPtr let(
+LetStatement::Ptr let(
   bool isPub,
   bool isMut,
   std::string const& name,
-  Node::SPtr value);
+  Node::Ptr value);
 
-LetStatement::SPtr let(
+LetStatement::Ptr let(
   bool isPub,
   bool isMut,
   std::string const& name,
-  Node::SPtr type,
-  Node::SPtr value);
+  Node::Ptr type,
+  Node::Ptr value);
 
-BlockExpression::SPtr block(
-  list<Node::SPtr> statements);
+BlockExpression::Ptr block(
+  list<Node::Ptr> statements);
 
-BlockExpression::SPtr block(
+BlockExpression::Ptr block(
   std::string const& label,
-  list<Node::SPtr> statements);
+  list<Node::Ptr> statements);
 
-FunctionExpression::SPtr fn(
-  list<Part::SPtr> parameters,
-  Node::SPtr returnType,
-  BlockExpression::SPtr body = nullptr);
+FunctionExpression::Ptr fn(
+  list<Part::Ptr> parameters,
+  Node::Ptr returnType,
+  BlockExpression::Ptr body = nullptr);
 
-IfExpression::SPtr _if(
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr block);
+IfExpression::Ptr _if(
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr block);
 
-IfExpression::SPtr _if(
+IfExpression::Ptr _if(
   std::string const& label,
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr block);
-
-IfExpression::SPtr _if(
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr block,
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr block);
+
+IfExpression::Ptr _if(
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr block,
   list<IfExpression::Clause> clauses);
 
-IfExpression::SPtr _if(
+IfExpression::Ptr _if(
   std::string const& label,
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr block,
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr block,
   list<IfExpression::Clause> clauses);
 
 IfExpression::Clause _elseIf(
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr block);
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr block);
 
 IfExpression::Clause _else(
-  Node::SPtr capture,
-  BlockExpression::SPtr block);
+  Node::Ptr capture,
+  BlockExpression::Ptr block);
 
-LoopExpression::SPtr loop(
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr body,
-  Node::SPtr elseCapture = nullptr,
-  BlockExpression::SPtr elseBody = nullptr);
+LoopExpression::Ptr loop(
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr body,
+  Node::Ptr elseCapture = nullptr,
+  BlockExpression::Ptr elseBody = nullptr);
 
-LoopExpression::SPtr loop(
+LoopExpression::Ptr loop(
   std::string const& label,
-  Node::SPtr condition,
-  Node::SPtr capture,
-  BlockExpression::SPtr body,
-  Node::SPtr elseCapture = nullptr,
-  BlockExpression::SPtr elseBody = nullptr);
-
-SwitchExpression::SPtr _switch(
-  Node::SPtr value,
+  Node::Ptr condition,
+  Node::Ptr capture,
+  BlockExpression::Ptr body,
+  Node::Ptr elseCapture = nullptr,
+  BlockExpression::Ptr elseBody = nullptr);
+
+SwitchExpression::Ptr _switch(
+  Node::Ptr value,
   list<SwitchExpression::Case> cases);
 
-ReturnStatement::SPtr _return(
-  Node::SPtr value = nullptr);
+ReturnStatement::Ptr _return(
+  Node::Ptr value = nullptr);
 
-BreakStatement::SPtr _break(
+BreakStatement::Ptr _break(
   std::string const label = "",
-  Node::SPtr value = nullptr);
+  Node::Ptr value = nullptr);
 
-ContinueStatement::SPtr _continue(
+ContinueStatement::Ptr _continue(
   std::string const label = "");
 
-DeferStatement::SPtr defer(
-  Node::SPtr target);
+DeferStatement::Ptr defer(
+  Node::Ptr target);
 
-bool equal(Node::SPtr node1, Node::SPtr node2);
\ No newline at end of file
+bool equal(Node::Ptr node1, Node::Ptr node2);
\ No newline at end of file
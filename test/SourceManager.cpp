@@ -0,0 +1,111 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Error.h>
+#include <parsing/SourceManager.h>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+TEST_SUITE_BEGIN("SourceManager");
+
+namespace
+{
+
+std::string writeTemp(std::string const& name, std::string const& text)
+{
+  auto const path = (std::filesystem::temp_directory_path() / name).string();
+  std::ofstream(path, std::ios::out | std::ios::binary) << text;
+  return path;
+}
+
+} // anonymous namespace
+
+TEST_CASE("files are loaded once")
+{
+  auto const path = writeTemp("mir-test-source.mir", "let a = 1;\r\nlet b = 2;\n\nc: i32,");
+  auto const file = SourceManager::load(path);
+
+  // later changes are not seen, the text is kept
+  writeTemp("mir-test-source.mir", "let z = 0;");
+  REQUIRE_EQ(SourceManager::load(path), file);
+  REQUIRE_EQ(SourceManager::id(path), file);
+  REQUIRE_EQ(SourceManager::path(file), path);
+  REQUIRE_EQ(SourceManager::text(file), "let a = 1;\r\nlet b = 2;\n\nc: i32,");
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("lines and offsets")
+{
+  auto const file = SourceManager::add("<source-manager-lines>", "ab\ncde\n\nf");
+
+  REQUIRE_EQ(SourceManager::lineStarts(file).size(), 4);
+  REQUIRE_EQ(SourceManager::line(file, 0), "ab");
+  REQUIRE_EQ(SourceManager::line(file, 1), "cde");
+  REQUIRE_EQ(SourceManager::line(file, 2), "");
+  REQUIRE_EQ(SourceManager::line(file, 3), "f");
+  REQUIRE_EQ(SourceManager::line(file, 4), "");
+
+  for (size_t offset = 0; offset < 9; offset += 1)
+  {
+    REQUIRE_EQ(SourceManager::offset(file, SourceManager::position(file, offset)), offset);
+  }
+  REQUIRE_EQ(SourceManager::position(file, 4), Position(1, 1));
+  REQUIRE_EQ(SourceManager::position(file, 7), Position(2, 0));
+  REQUIRE_EQ(SourceManager::offset(file, Position(3, 0)), 8);
+
+  // texts are set once
+  REQUIRE_EQ(SourceManager::add("<source-manager-lines>", "other"), file);
+  REQUIRE_EQ(SourceManager::text(file), "ab\ncde\n\nf");
+}
+
+TEST_CASE("paths without a text")
+{
+  auto const file = SourceManager::id("<source-manager-no-text>");
+
+  REQUIRE_FALSE(SourceManager::hasText(file));
+  REQUIRE(SourceManager::text(file).empty());
+  REQUIRE(SourceManager::lineStarts(file).empty());
+  REQUIRE_THROWS_AS(SourceManager::load("/nonexistent/mir/file.mir"), Error);
+}
+
+TEST_CASE("a text is seen whole or not at all while it is added")
+{
+  auto const file = SourceManager::id("<source-manager-race>");
+  std::string const text = "let a = 1;\nlet b = 2;\n";
+
+  bool isTorn = false;
+  auto reader = std::thread([&]
+  {
+    while (!SourceManager::hasText(file))
+    {
+      auto const lineStarts = SourceManager::lineStarts(file);
+      isTorn = isTorn || (!lineStarts.empty() && SourceManager::text(file).empty());
+    }
+    isTorn = isTorn || SourceManager::text(file) != text || SourceManager::lineStarts(file).size() != 3;
+  });
+  SourceManager::add("<source-manager-race>", text);
+  reader.join();
+
+  REQUIRE_FALSE(isTorn);
+}
+
+TEST_CASE("errors refer to files by id")
+{
+  auto const err = Error("<source-manager-error>", Position(1, 2), "msg")
+    .note(Position(0, 0), "note")
+    .note("<source-manager-other>", "other");
+
+  auto const& parts = err.parts();
+  REQUIRE_EQ(parts[0].file(), SourceManager::id("<source-manager-error>"));
+  REQUIRE_EQ(parts[1].file(), parts[0].file());
+  REQUIRE_NE(parts[2].file(), parts[0].file());
+  REQUIRE_EQ(
+    fmt::to_string(err),
+    "<source-manager-error>:1:2: error: msg\n"
+    "<source-manager-error>:0:0: note: note\n"
+    "<source-manager-other>:0:0: note: other");
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,78 @@
+#include <doctest.h>
+#include <SpscRing.h>
+
+#include <thread>
+#include <vector>
+
+TEST_SUITE_BEGIN("SpscRing");
+
+TEST_CASE("push and pop in batches")
+{
+  SpscRing<int, 4> ring;
+  int out[4] = {};
+
+  int const first[3] = {1, 2, 3};
+  REQUIRE_EQ(ring.tryPush(first, 3), 3);
+  REQUIRE_EQ(ring.tryPop(out, 2), 2);
+  REQUIRE_EQ(out[0], 1);
+  REQUIRE_EQ(out[1], 2);
+
+  // wraps around and stops when full
+  int const second[4] = {4, 5, 6, 7};
+  REQUIRE_EQ(ring.tryPush(second, 4), 3);
+  REQUIRE_EQ(ring.tryPop(out, 4), 4);
+  REQUIRE_EQ(out[0], 3);
+  REQUIRE_EQ(out[1], 4);
+  REQUIRE_EQ(out[2], 5);
+  REQUIRE_EQ(out[3], 6);
+
+  REQUIRE_EQ(ring.tryPop(out, 4), 0);
+}
+
+TEST_CASE("transfers between threads in order")
+{
+  constexpr size_t count = 100000;
+  auto pRing = std::make_unique<SpscRing<size_t, 64>>();
+
+  auto producer = std::thread([&]()
+  {
+    size_t batch[16];
+    for (size_t next = 0; next < count;)
+    {
+      size_t const batchSize = std::min<size_t>(16, count - next);
+      for (size_t i = 0; i < batchSize; i += 1)
+      {
+        batch[i] = next + i;
+      }
+      size_t pushed = 0;
+      while (pushed < batchSize)
+      {
+        pushed += pRing->tryPush(batch + pushed, batchSize - pushed);
+        std::this_thread::yield();
+      }
+      next += batchSize;
+    }
+  });
+
+  std::vector<size_t> received;
+  size_t out[32];
+  while (received.size() < count)
+  {
+    size_t const popped = pRing->tryPop(out, 32);
+    received.insert(received.end(), out, out + popped);
+    if (popped == 0)
+    {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  bool inOrder = true;
+  for (size_t i = 0; i < count; i += 1)
+  {
+    inOrder = inOrder && received[i] == i;
+  }
+  REQUIRE(inOrder);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,140 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Parser.h>
+#include <parsing/StreamingParser.h>
+
+TEST_SUITE_BEGIN("StreamingParser");
+
+namespace
+{
+
+std::string const source = R"MIR(let a = 1, b = "x;y";
+/* block ; comment */ let f = fn(x: i32) i32 {
+  return x; // ;
+};
+pub let mut c = struct { d: i32, };
+e: u8,
+f: u8
+)MIR";
+
+std::string expected()
+{
+  PARSER_TEXT(source);
+  auto const pRoot = prs.root();
+
+  std::string res;
+  for (auto const& pDecl : pRoot->declsPre())
+  {
+    res += pDecl->toString();
+  }
+  for (auto const& pField : pRoot->fields())
+  {
+    res += pField->toString();
+  }
+  return res;
+}
+
+} // anonymous namespace
+
+TEST_CASE("declarations are returned as soon as they are complete")
+{
+  auto prs = StreamingParser("<file>");
+
+  REQUIRE(prs.push("let a = 1,").empty());
+  REQUIRE(prs.push(" b = 2").empty());
+
+  auto const nodes = prs.push(";\nlet c = {");
+  REQUIRE_EQ(nodes.size(), 1);
+  REQUIRE_EQ(nodes[0]->start(), Position(0, 0));
+
+  REQUIRE(prs.push("};").size() == 1);
+  REQUIRE(prs.finish().empty());
+}
+
+TEST_CASE("any split gives the same declarations as the parser")
+{
+  for (size_t pieceSize : list<size_t>{1, 2, 3, 7, 64})
+  {
+    auto streaming = StreamingParser("<file>");
+
+    std::string actual;
+    for (size_t offset = 0; offset < source.size(); offset += pieceSize)
+    {
+      for (auto const& pNode : streaming.push(std::string_view(source).substr(offset, pieceSize)))
+      {
+        actual += pNode->toString();
+      }
+    }
+    for (auto const& pNode : streaming.finish())
+    {
+      actual += pNode->toString();
+    }
+
+    REQUIRE_EQ(actual, expected());
+
+    PARSER_TEXT(source);
+    REQUIRE_EQ(streaming.root()->toString(), prs.root()->toString());
+  }
+}
+
+TEST_CASE("streamed declarations can be released")
+{
+  auto prs = StreamingParser("<file>");
+  prs.setKeepsTree(false);
+
+  std::string actual;
+  for (size_t offset = 0; offset < source.size(); offset += 5)
+  {
+    for (auto const& pNode : prs.push(std::string_view(source).substr(offset, 5)))
+    {
+      actual += pNode->toString();
+    }
+  }
+  for (auto const& pNode : prs.finish())
+  {
+    actual += pNode->toString();
+  }
+
+  REQUIRE_EQ(actual, expected());
+  REQUIRE_EQ(prs.root(), nullptr);
+}
+
+TEST_CASE("line starts of the streamed declarations")
+{
+  auto prs = StreamingParser("<file>");
+  prs.setKeepsTree(false);
+
+  REQUIRE(prs.push("let a = 1;\nlet b").size() == 1);
+  REQUIRE_EQ(prs.firstLine(), 0);
+  REQUIRE_EQ(std::vector<size_t>(prs.lineStarts().begin(), prs.lineStarts().end()), std::vector<size_t>{0});
+
+  // the text after the last ';' starts on line 0
+  auto nodes = prs.push(" =\n  2;\n");
+  REQUIRE_EQ(nodes.size(), 1);
+  REQUIRE_EQ(nodes[0]->start(), Position(1, 0));
+  REQUIRE_EQ(prs.firstLine(), 0);
+  REQUIRE_EQ(std::vector<size_t>(prs.lineStarts().begin(), prs.lineStarts().end()), std::vector<size_t>{0, 11, 19});
+
+  nodes = prs.push("let c = 3;");
+  REQUIRE_EQ(nodes.size(), 1);
+  REQUIRE_EQ(prs.firstLine(), 2);
+  REQUIRE_EQ(std::vector<size_t>(prs.lineStarts().begin(), prs.lineStarts().end()), std::vector<size_t>{19, 24});
+}
+
+TEST_CASE("streamed fields must be grouped together")
+{
+  auto prs = StreamingParser("<file>");
+  prs.push("a: i32,\nlet b = 1;\n");
+
+  try
+  {
+    prs.push("c: i32,\n");
+    FAIL("unreachable");
+  }
+  catch (Error const& err)
+  {
+    REQUIRE_EQ(fmt::to_string(err), "<file>:2:0: error: struct fields must be grouped together");
+  }
+}
+
+TEST_SUITE_END();
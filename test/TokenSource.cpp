@@ -0,0 +1,183 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/LexerThread.h>
+#include <parsing/Parser.h>
+#include <parsing/TokenCache.h>
+#include <parsing/TokenSource.h>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+TEST_SUITE_BEGIN("TokenSource");
+
+namespace
+{
+
+std::string const source = R"MIR(// comment
+let a = fn(x: i32) i32 {
+  let y = blk: { break :blk x; };
+  return y;
+};
+pub let mut b: u8 = "text";
+c: i32,
+)MIR";
+
+std::vector<Token> tokens(std::string const& text)
+{
+  TOKENIZER_TEXT(text);
+
+  std::vector<Token> res;
+  do
+  {
+    res.push_back(tk.next());
+  }
+  while (res.back().tag() != Token::Eof);
+  return res;
+}
+
+std::string expected()
+{
+  PARSER_TEXT(source);
+  return prs.root()->toString();
+}
+
+} // anonymous namespace
+
+TEST_CASE("token array")
+{
+  Arena arena;
+  auto prs = Parser(TokenArray(tokens(source), "<file>"), arena);
+  REQUIRE_EQ(prs.root()->toString(), expected());
+}
+
+TEST_CASE("token cache")
+{
+  auto const cachePath = (std::filesystem::temp_directory_path() / "mir-test-tokens.cache").string();
+  TokenCache::write(cachePath, tokens(source));
+
+  {
+    auto cache = TokenCache(cachePath, "<file>");
+    REQUIRE_EQ(cache.size(), tokens(source).size());
+
+    Arena arena;
+    auto prs = Parser(std::move(cache), arena);
+    REQUIRE_EQ(prs.root()->toString(), expected());
+  }
+
+  {
+    auto file = std::ofstream(cachePath, std::ios::out | std::ios::trunc);
+    file << "not a token cache";
+  }
+  REQUIRE_THROWS_AS(TokenCache(cachePath, "<file>"), Error);
+
+  std::filesystem::remove(cachePath);
+}
+
+TEST_CASE("token cache records are checked when opening")
+{
+  auto const cachePath = (std::filesystem::temp_directory_path() / "mir-test-tokens.cache").string();
+
+  // header of 32 bytes followed by records of 6 uint32_t
+  auto const overwrite = [&](size_t offset, uint32_t value)
+  {
+    TokenCache::write(cachePath, tokens(source));
+    auto file = std::fstream(cachePath, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(reinterpret_cast<char const*>(&value), sizeof(value));
+  };
+
+  overwrite(32, 1000); // tag
+  REQUIRE_THROWS_AS(TokenCache(cachePath, "<file>"), Error);
+
+  overwrite(32 + 20, 1000); // string
+  REQUIRE_THROWS_AS(TokenCache(cachePath, "<file>"), Error);
+
+  TokenCache::write(cachePath, tokens(source));
+  std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 1);
+  REQUIRE_THROWS_AS(TokenCache(cachePath, "<file>"), Error);
+
+  std::filesystem::remove(cachePath);
+}
+
+TEST_CASE("token queue")
+{
+  auto queue = TokenQueue("<file>");
+  auto producer = std::thread([queue]() mutable
+  {
+    for (auto const& token : tokens(source))
+    {
+      queue.push(token);
+    }
+  });
+
+  Arena arena;
+  auto prs = Parser(queue, arena);
+  auto const pRoot = prs.root();
+  producer.join();
+
+  REQUIRE_EQ(pRoot->toString(), expected());
+}
+
+TEST_CASE("lexer thread")
+{
+  // more tokens than fit in the ring
+  std::string text;
+  for (size_t i = 0; i < 1000; i += 1)
+  {
+    text += fmt::format("let a{} = {{ {}; }}; // comment\n", i, i);
+  }
+
+  PARSER_TEXT(text);
+  auto const pExpected = prs.root();
+
+  auto stream = std::istringstream(text, std::ios::in);
+  auto threaded = Parser(LexerThread(stream, "<file>"), arena);
+  REQUIRE_EQ(threaded.root()->toString(), pExpected->toString());
+}
+
+TEST_CASE("lexer thread reports tokenizer errors")
+{
+  std::string const text = "let a = 1;\nlet b = \"unterminated;\n";
+
+  std::string expectedMsg;
+  try
+  {
+    PARSER_TEXT(text);
+    prs.root();
+    FAIL("unreachable");
+  }
+  catch (Error const& err)
+  {
+    expectedMsg = fmt::to_string(err);
+  }
+
+  try
+  {
+    Arena arena;
+    auto stream = std::istringstream(text, std::ios::in);
+    auto threaded = Parser(LexerThread(stream, "<file>"), arena);
+    threaded.root();
+    FAIL("unreachable");
+  }
+  catch (Error const& err)
+  {
+    REQUIRE_EQ(fmt::to_string(err), expectedMsg);
+  }
+}
+
+TEST_CASE("lexer thread stops when the parser does")
+{
+  std::string text = "let = 1;\n";
+  for (size_t i = 0; i < 10000; i += 1)
+  {
+    text += "let a = 1;\n";
+  }
+
+  Arena arena;
+  auto stream = std::istringstream(text, std::ios::in);
+  auto threaded = Parser(LexerThread(stream, "<file>"), arena);
+  REQUIRE_THROWS_AS(threaded.root(), Error);
+}
+
+TEST_SUITE_END();
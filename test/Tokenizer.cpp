@@ -395,4 +395,17 @@ TEST_CASE("operators (runes) must be valid")
   }
 }
 
-TEST_SUITE_END();
\ No newline at end of file
+TEST_CASE("interned strings are counted once")
+{
+  auto const count = Intern::count();
+  auto const bytes = Intern::bytes();
+
+  TOKENIZER_TEXT("tokenizer_intern_count tokenizer_intern_count");
+  tk.next();
+  tk.next();
+
+  REQUIRE_EQ(Intern::count(), count + 1);
+  REQUIRE_EQ(Intern::bytes(), bytes + 22);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,82 @@
+#include <doctest.h>
+#include <ParsingUtils.h>
+#include <parsing/Parser.h>
+#include <parsing/ast/Walker.h>
+
+TEST_SUITE_BEGIN("Walker");
+
+namespace
+{
+
+struct Trace
+{
+  std::vector<std::string> events;
+
+  void pre(SymbolExpression::Ptr pSymbol) { events.push_back(std::string(pSymbol->name())); }
+  void pre(LabeledNode::Ptr) { events.push_back("labeled"); }
+  void post(LabeledNode::Ptr) { events.push_back("/labeled"); }
+  void pre(Node::Ptr) { events.push_back("node"); }
+};
+
+struct SkipFunctions
+{
+  size_t symbols = 0;
+
+  bool pre(FunctionExpression::Ptr) { return false; }
+  void pre(SymbolExpression::Ptr) { symbols += 1; }
+};
+
+} // anonymous namespace
+
+TEST_CASE("hooks are chosen by the concrete node type")
+{
+  PARSER_TEXT("let a = { b; if c { d; } };");
+
+  Trace trace;
+  Walker().walk(prs.root(), trace);
+
+  std::vector<std::string> const expected = {
+    "node", "node", "node", "a",
+    "labeled", "b",
+    "labeled", "c", "labeled", "d", "/labeled", "/labeled",
+    "/labeled",
+  };
+  REQUIRE_EQ(trace.events, expected);
+}
+
+TEST_CASE("pre hooks can skip children")
+{
+  PARSER_TEXT("let a = fn(x: i32) void { y; };\nlet b = c;");
+
+  SkipFunctions visitor;
+  Walker().walk(prs.root(), visitor);
+
+  REQUIRE_EQ(visitor.symbols, 3);
+}
+
+TEST_CASE("deep trees do not overflow the stack")
+{
+  Arena arena;
+  size_t constexpr depth = 200000;
+
+  Node::Ptr pNode = arena.make<SymbolExpression>(t(Token::Symbol, "x"));
+  for (size_t i = 0; i < depth; i += 1)
+  {
+    pNode = BlockExpression::make(arena, Position::invalid(), Position::invalid(), {pNode});
+  }
+
+  struct MaxDepth
+  {
+    Walker* pWalker;
+    uint32_t max = 0;
+    void pre(SymbolExpression::Ptr) { max = pWalker->depth(); }
+  };
+
+  Walker walker;
+  MaxDepth visitor = {&walker};
+  walker.walk(pNode, visitor);
+
+  REQUIRE_EQ(visitor.max, depth);
+}
+
+TEST_SUITE_END();